@@ -0,0 +1,112 @@
+#include "../include/async_publisher.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace trading;
+
+constexpr size_t kOrders = 200000;
+constexpr size_t kRestingPerSide = 2 * kOrders;
+constexpr uint64_t kCallbackNs = 500;    // Simulated logging / network send per event
+constexpr Price kBid = 9999;
+constexpr Price kAsk = 10001;
+
+// Spin for about ns nanoseconds
+static void slowConsumer(uint64_t ns) {
+    bench::Stopwatch sw;
+    while (sw.elapsedNs() < ns) {
+    }
+}
+
+// Lots of one-lot resting orders, so each IOC below sweeps several of
+// them; built outside the engine so seeding publishes no events
+template <typename Engine>
+static BookHandle seedBook(Engine& engine) {
+    auto book = std::make_unique<OrderBook>(InstrumentSpec("AP"));
+    book->reserveOrders(2 * kRestingPerSide);
+    OrderId id = kOrders + 1;
+    for (size_t i = 0; i < kRestingPerSide; ++i) {
+        book->addOrder(Order(id++, book->symbolId(), Side::Buy, OrderType::Limit, kBid, 1));
+        book->addOrder(Order(id++, book->symbolId(), Side::Sell, OrderType::Limit, kAsk, 1));
+    }
+    return engine.adoptBook(std::move(book));
+}
+
+// Time each submit on the engine thread
+template <typename Engine>
+static void runOrders(Engine& engine, BookHandle book, std::vector<uint64_t>& samples) {
+    std::vector<Fill> fills;
+    samples.clear();
+    samples.reserve(kOrders);
+    for (OrderId id = 1; id <= kOrders; ++id) {
+        Side side = (id & 1) ? Side::Buy : Side::Sell;
+        Order order(id, book.symbolId(), side, OrderType::IOC, side == Side::Buy ? kAsk : kBid,
+                    1 + static_cast<Quantity>(id % 4));
+        fills.clear();
+        bench::Stopwatch sw;
+        engine.submitOrder(book, order, fills);
+        samples.push_back(sw.elapsedNs());
+    }
+}
+
+// Baseline: the slow callbacks run inside matchOrder
+static void benchSync() {
+    MatchingEngine engine;
+    engine.setFillCallback([](const Fill&) { slowConsumer(kCallbackNs); });
+    engine.setOrderCallback([](const Order&) { slowConsumer(kCallbackNs); });
+    BookHandle book = seedBook(engine);
+    std::vector<uint64_t> samples;
+    runOrders(engine, book, samples);
+    std::printf("  synchronous callbacks\n");
+    bench::reportLatency("submit", samples);
+}
+
+static void benchAsync(SlowConsumerPolicy policy) {
+    PublisherOptions options;
+    options.capacity = 4096;
+    options.policy = policy;
+    AsyncPublisher publisher(options);
+    uint64_t gaps = 0;
+    publisher.setFillCallback([](const Fill&) { slowConsumer(kCallbackNs); });
+    publisher.setOrderCallback([](const Order&) { slowConsumer(kCallbackNs); });
+    publisher.setGapCallback([&gaps](uint64_t) { ++gaps; });
+
+    BasicMatchingEngine<AsyncListener> engine{AsyncListener(&publisher)};
+    BookHandle book = seedBook(engine);
+    publisher.start();
+    std::vector<uint64_t> samples;
+    bench::Stopwatch sw;
+    runOrders(engine, book, samples);
+    uint64_t matching_ns = sw.elapsedNs();
+    publisher.stop();
+    uint64_t total_ns = sw.elapsedNs();
+
+    PublisherStats stats = publisher.stats();
+    std::printf("  async, %s: matching done in %.1f ms, last event delivered at %.1f ms\n",
+                to_string(policy), matching_ns / 1e6, total_ns / 1e6);
+    bench::reportLatency("submit", samples);
+    std::printf("    ring: peak %zu / %zu, mean %.1f; %llu full waits, %llu dropped "
+                "(%llu gaps), %llu conflated\n",
+                stats.peak_occupancy, stats.capacity, stats.mean_occupancy,
+                static_cast<unsigned long long>(stats.full_waits),
+                static_cast<unsigned long long>(stats.dropped),
+                static_cast<unsigned long long>(gaps),
+                static_cast<unsigned long long>(stats.conflated));
+}
+
+int main() {
+    std::printf("=== Async Publisher (%zu IOC orders, %llu ns per callback, "
+                "%u hardware threads) ===\n",
+                kOrders, static_cast<unsigned long long>(kCallbackNs),
+                std::thread::hardware_concurrency());
+
+    benchSync();
+    for (SlowConsumerPolicy policy : {SlowConsumerPolicy::Block,
+                                      SlowConsumerPolicy::DropAndFlag,
+                                      SlowConsumerPolicy::Conflate}) {
+        benchAsync(policy);
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "../include/command_queue.hpp"
+#include "bench_util.hpp"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace trading;
+
+constexpr size_t kOrders = 200000;
+constexpr uint64_t kIntervalNs = 2000;    // One order every 2 us
+constexpr Price kBid = 9999;
+constexpr Price kAsk = 10001;
+
+static uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Stamps the first fill of each aggressive order on the engine thread
+struct FillClock : NullListener {
+    std::vector<uint64_t>* filled_at = nullptr;
+
+    void onFill(const Fill& fill) {
+        uint64_t& stamp = (*filled_at)[fill.order_id];
+        if (stamp == 0) {
+            stamp = nowNs();
+        }
+    }
+};
+
+// Enqueue-to-fill latency: the gateway thread stamps each IOC as it pushes
+// it, the engine thread stamps its fill against deep resting liquidity
+static void benchStrategy(WaitStrategy wait) {
+    std::vector<uint64_t> enqueued_at(kOrders + 1, 0);
+    std::vector<uint64_t> filled_at(kOrders + 1, 0);
+    FillClock listener;
+    listener.filled_at = &filled_at;
+
+    BasicMatchingEngine<FillClock> engine(listener);
+    BookHandle book = engine.registerSymbol("CQ", 16);
+    std::vector<Fill> fills;
+    OrderId resting = kOrders + 1;
+    engine.submitOrder(book, Order(resting++, book.symbolId(), Side::Buy, OrderType::Limit,
+                                   kBid, 1000000000), fills);
+    engine.submitOrder(book, Order(resting++, book.symbolId(), Side::Sell, OrderType::Limit,
+                                   kAsk, 1000000000), fills);
+
+    CommandQueue queue(4096, wait);
+    EngineLoop<FillClock> loop(engine, queue);
+    std::thread engine_thread([&loop]() { loop.run(); });
+
+    uint64_t next_send = nowNs();
+    for (OrderId id = 1; id <= kOrders; ++id) {
+        // Pace the flow so the latency is not just queueing behind a backlog
+        while (nowNs() < next_send) {
+            std::this_thread::yield();
+        }
+        next_send += kIntervalNs;
+        Side side = (id & 1) ? Side::Buy : Side::Sell;
+        Order order(id, book.symbolId(), side, OrderType::IOC, side == Side::Buy ? kAsk : kBid, 1);
+        enqueued_at[id] = nowNs();
+        queue.push(EngineCommand::submit(order));
+    }
+    loop.stop();
+    engine_thread.join();
+
+    std::vector<uint64_t> samples;
+    samples.reserve(kOrders);
+    for (OrderId id = 1; id <= kOrders; ++id) {
+        if (filled_at[id] >= enqueued_at[id]) {
+            samples.push_back(filled_at[id] - enqueued_at[id]);
+        }
+    }
+    std::printf("  %-10s %zu fills in %llu batches, %llu sleeps\n", to_string(wait),
+                samples.size(), static_cast<unsigned long long>(loop.batches()),
+                static_cast<unsigned long long>(queue.sleeps()));
+    bench::reportLatency("enqueue -> fill", samples);
+}
+
+int main() {
+    std::printf("=== Command Queue (%zu IOC orders, one per %llu ns, %u hardware threads) ===\n",
+                kOrders, static_cast<unsigned long long>(kIntervalNs),
+                std::thread::hardware_concurrency());
+
+    for (WaitStrategy wait : {WaitStrategy::BusySpin, WaitStrategy::SpinYield,
+                              WaitStrategy::Block}) {
+        benchStrategy(wait);
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "../include/matching_engine.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace trading;
+
+// Prices are generated as tick offsets around a 100.00 mid (10000 cent ticks)
+constexpr int64_t kMid = 10000;
+constexpr int64_t kHalfRange = 200;
+constexpr size_t kOrders = 50000;
+constexpr size_t kBatch = 64;
+
+// Order stream where about a third of the orders cross the spread
+static std::vector<Order> makeStream(size_t count) {
+    bench::Rng rng;
+    std::vector<Order> orders;
+    orders.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Side side = (rng.next() & 1) ? Side::Buy : Side::Sell;
+        int64_t offset = 1 + static_cast<int64_t>(rng.below(kHalfRange));
+        Price price = (side == Side::Buy) ? kMid - offset : kMid + offset;
+        OrderType type = OrderType::Limit;
+        if (rng.below(3) == 0) {
+            price = (side == Side::Buy) ? kMid + kHalfRange : kMid - kHalfRange;
+            type = OrderType::IOC;
+        }
+        orders.emplace_back(i + 1, "BENCH", side, type, price,
+                            1 + static_cast<Quantity>(rng.below(100)));
+    }
+    return orders;
+}
+
+struct Policy {
+    const char* name;
+    bool journal;
+    FsyncPolicy fsync;
+};
+
+static std::shared_ptr<OrderJournal> openJournal(const std::string& path, const Policy& policy) {
+    if (!policy.journal) {
+        return nullptr;
+    }
+    std::remove(path.c_str());
+    JournalOptions options;
+    options.fsync = policy.fsync;
+    options.group_size = kBatch;
+    options.sync_interval = std::chrono::milliseconds(1);
+    auto journal = std::make_shared<OrderJournal>();
+    if (!journal->open(path, options)) {
+        std::printf("cannot open journal %s\n", path.c_str());
+        return nullptr;
+    }
+    return journal;
+}
+
+static void printSyncs(const OrderJournal* journal) {
+    if (journal) {
+        std::printf("    %llu commits, %llu fdatasyncs, %.1f MB\n",
+                    static_cast<unsigned long long>(journal->commits()),
+                    static_cast<unsigned long long>(journal->syncs()),
+                    journal->bytesWritten() / 1e6);
+    }
+}
+
+// One submitOrder per order; the journal commits every kBatch commands,
+// so most calls only buffer and every kBatch-th one pays for the commit
+static void benchSingle(const std::string& path, const Policy& policy,
+                        const std::vector<Order>& stream) {
+    MatchingEngine engine;
+    auto journal = openJournal(path, policy);
+    engine.setJournal(journal);
+    BookHandle book = engine.registerSymbol("BENCH", stream.size());
+    std::vector<Fill> fills;
+    fills.reserve(1024);
+    std::vector<uint64_t> latency;
+    latency.reserve(stream.size());
+
+    bench::Stopwatch total;
+    for (const Order& order : stream) {
+        bench::Stopwatch sw;
+        fills.clear();
+        engine.submitOrder(book, order, fills);
+        latency.push_back(sw.elapsedNs());
+    }
+    uint64_t elapsed = total.elapsedNs();
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "single, %s", policy.name);
+    bench::report(name, stream.size(), elapsed);
+    bench::reportLatency("per order", latency);
+    printSyncs(journal.get());
+}
+
+// submitOrders batches: each batch is journaled and committed up front
+static void benchBatched(const std::string& path, const Policy& policy,
+                         const std::vector<Order>& stream) {
+    MatchingEngine engine;
+    auto journal = openJournal(path, policy);
+    engine.setJournal(journal);
+    BookHandle book = engine.registerSymbol("BENCH", stream.size());
+    std::vector<Order> orders = stream;
+    Span<Order> all(orders);
+    std::vector<Fill> fills;
+    fills.reserve(4096);
+    std::vector<uint64_t> latency;
+
+    bench::Stopwatch total;
+    for (size_t start = 0; start < orders.size(); start += kBatch) {
+        bench::Stopwatch sw;
+        fills.clear();
+        engine.submitOrders(book, all.subspan(start, std::min(kBatch, orders.size() - start)),
+                            fills);
+        latency.push_back(sw.elapsedNs());
+    }
+    uint64_t elapsed = total.elapsedNs();
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "batch %zu, %s", kBatch, policy.name);
+    bench::report(name, stream.size(), elapsed);
+    bench::reportLatency("per batch", latency);
+    printSyncs(journal.get());
+}
+
+int main(int argc, char** argv) {
+    // Journal file on local disk; pass a path to test another device
+    std::string path = argc > 1 ? argv[1] : "bench_journal.bin";
+    const std::vector<Order> stream = makeStream(kOrders);
+
+    const Policy policies[] = {
+        {"no journal", false, FsyncPolicy::None},
+        {"no fsync", true, FsyncPolicy::None},
+        {"fsync per batch", true, FsyncPolicy::PerBatch},
+        {"fsync every 1ms", true, FsyncPolicy::Periodic},
+    };
+
+    std::printf("=== Journal Throughput and Latency (%zu orders, group %zu, %s) ===\n",
+                kOrders, kBatch, path.c_str());
+    for (const Policy& policy : policies) {
+        benchSingle(path, policy, stream);
+    }
+    for (const Policy& policy : policies) {
+        benchBatched(path, policy, stream);
+    }
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,322 @@
+#include "../include/matching_engine.hpp"
+#include "bench_util.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace trading;
+
+// Prices are generated as tick offsets around a 100.00 mid (10000 cent ticks)
+constexpr int64_t kMid = 10000;
+constexpr int64_t kHalfRange = 200;
+constexpr size_t kOrders = 200000;
+
+// Non-crossing passive order: bids below the mid, asks above
+static Order makePassive(OrderId id, bench::Rng& rng) {
+    Side side = (rng.next() & 1) ? Side::Buy : Side::Sell;
+    int64_t offset = 1 + static_cast<int64_t>(rng.below(kHalfRange));
+    Price price = (side == Side::Buy) ? kMid - offset : kMid + offset;
+    Quantity qty = 1 + static_cast<Quantity>(rng.below(100));
+    return Order(id, "BENCH", side, OrderType::Limit, price, qty);
+}
+
+// Aggressive orders alternate sides and each take a slice of the touch.
+// match(side, id) runs one aggressor and returns the number of fills.
+template <typename Match>
+static void benchBookAggressors(const char* name, Match&& match) {
+    bench::Rng rng;
+    OrderBook book(InstrumentSpec("BENCH").withArrayLadder(kMid - 4096, 8192));
+    for (size_t i = 0; i < kOrders; ++i) {
+        book.addOrder(makePassive(i + 1, rng));
+    }
+    
+    size_t fills = 0;
+    size_t aggressors = 0;
+    OrderId next_id = kOrders + 1;
+    bench::Stopwatch sw;
+    while (book.bidOrderCount() > 0 && book.askOrderCount() > 0) {
+        Side side = (aggressors & 1) ? Side::Sell : Side::Buy;
+        fills += match(book, side, next_id++);
+        ++aggressors;
+    }
+    bench::report(name, aggressors, sw.elapsedNs());
+    bench::doNotOptimize(fills);
+}
+
+static Price aggressorLimit(Side side) {
+    return (side == Side::Buy) ? kMid + kHalfRange : kMid - kHalfRange;
+}
+
+static void benchBookApis() {
+    benchBookAggressors("book executeFill (vector)",
+        [](OrderBook& book, Side side, OrderId id) {
+            return book.executeFill(side, 150, aggressorLimit(side), id).size();
+        });
+    
+    std::vector<Fill> fills;
+    benchBookAggressors("book executeFill (buffer)",
+        [&fills](OrderBook& book, Side side, OrderId id) {
+            fills.clear();
+            book.executeFill(side, 150, aggressorLimit(side), id, fills);
+            return fills.size();
+        });
+    
+    benchBookAggressors("book executeFill (sink)",
+        [](OrderBook& book, Side side, OrderId id) {
+            size_t count = 0;
+            book.executeFill(side, 150, aggressorLimit(side), id,
+                             [&count](const Fill&) { ++count; });
+            return count;
+        });
+}
+
+// Same flow through the engine: passive limits, then IOC aggressors
+template <typename Engine, typename Submit>
+static void benchEngineAggressors(const char* name, Engine& engine, Submit&& submit) {
+    bench::Rng rng;
+    engine.addInstrument(InstrumentSpec("BENCH").withArrayLadder(kMid - 4096, 8192));
+    for (size_t i = 0; i < kOrders; ++i) {
+        engine.submitOrder(makePassive(i + 1, rng));
+    }
+    const OrderBook& book = *engine.getOrderBook("BENCH");
+    
+    size_t fills = 0;
+    size_t aggressors = 0;
+    OrderId next_id = kOrders + 1;
+    bench::Stopwatch sw;
+    while (book.bidOrderCount() > 0 && book.askOrderCount() > 0) {
+        Side side = (aggressors & 1) ? Side::Sell : Side::Buy;
+        fills += submit(engine, Order(next_id++, "BENCH", side, OrderType::IOC,
+                                      aggressorLimit(side), 150));
+        ++aggressors;
+    }
+    bench::report(name, aggressors, sw.elapsedNs());
+    bench::doNotOptimize(fills);
+}
+
+static void benchEngineApis() {
+    MatchingEngine vector_engine;
+    benchEngineAggressors("engine submitOrder (vector)", vector_engine,
+        [](MatchingEngine& engine, const Order& order) {
+            return engine.submitOrder(order).size();
+        });
+    
+    std::vector<Fill> fills;
+    MatchingEngine buffer_engine;
+    benchEngineAggressors("engine submitOrder (buffer)", buffer_engine,
+        [&fills](MatchingEngine& engine, const Order& order) {
+            fills.clear();
+            engine.submitOrder(order, fills);
+            return fills.size();
+        });
+}
+
+// Listener resolved at compile time; counts the same events as the
+// std::function callbacks below
+struct CountingListener {
+    uint64_t fills = 0;
+    uint64_t orders = 0;
+    
+    void onFill(const Fill&) { ++fills; }
+    void onOrder(const Order&) { ++orders; }
+};
+
+static void benchListeners() {
+    uint64_t fill_events = 0;
+    uint64_t order_events = 0;
+    MatchingEngine callback_engine;
+    callback_engine.setFillCallback([&fill_events](const Fill&) { ++fill_events; });
+    callback_engine.setOrderCallback([&order_events](const Order&) { ++order_events; });
+    
+    std::vector<Fill> fills;
+    benchEngineAggressors("listener (std::function)", callback_engine,
+        [&fills](MatchingEngine& engine, const Order& order) {
+            fills.clear();
+            engine.submitOrder(order, fills);
+            return fills.size();
+        });
+    
+    BasicMatchingEngine<CountingListener> static_engine;
+    benchEngineAggressors("listener (compile-time)", static_engine,
+        [&fills](BasicMatchingEngine<CountingListener>& engine, const Order& order) {
+            fills.clear();
+            engine.submitOrder(order, fills);
+            return fills.size();
+        });
+    bench::doNotOptimize(fill_events + order_events + static_engine.listener().fills);
+}
+
+// Quote churn through the engine: each step adds one passive order and
+// cancels the oldest, addressing the book by name or by handle
+static void benchHandles() {
+    constexpr size_t kSteps = 200000;
+    constexpr size_t kDepth = 1000;
+    bench::Rng rng;
+    std::vector<Order> orders;
+    orders.reserve(kSteps);
+    for (size_t i = 0; i < kSteps; ++i) {
+        orders.push_back(makePassive(i + 1, rng));
+    }
+    
+    std::vector<Fill> fills;
+    {
+        MatchingEngine engine;
+        engine.addInstrument(InstrumentSpec("BENCH"));
+        bench::Stopwatch sw;
+        for (size_t i = 0; i < kSteps; ++i) {
+            engine.submitOrder(orders[i], fills);
+            if (i >= kDepth) {
+                engine.cancelOrder("BENCH", orders[i - kDepth].id);
+            }
+        }
+        bench::report("churn (symbol name)", kSteps, sw.elapsedNs());
+    }
+    {
+        MatchingEngine engine;
+        BookHandle book = engine.registerInstrument(InstrumentSpec("BENCH"), kDepth);
+        bench::Stopwatch sw;
+        for (size_t i = 0; i < kSteps; ++i) {
+            engine.submitOrder(book, orders[i], fills);
+            if (i >= kDepth) {
+                engine.cancelOrder(book, orders[i - kDepth].id);
+            }
+        }
+        bench::report("churn (book handle)", kSteps, sw.elapsedNs());
+    }
+    
+    // Latency of the very first order into a fresh engine
+    constexpr size_t kEngines = 2000;
+    uint64_t lazy_ns = 0;
+    uint64_t registered_ns = 0;
+    for (size_t i = 0; i < kEngines; ++i) {
+        MatchingEngine lazy;
+        bench::Stopwatch lazy_sw;
+        lazy.submitOrder(orders[i], fills);
+        lazy_ns += lazy_sw.elapsedNs();
+        
+        MatchingEngine registered;
+        BookHandle book = registered.registerSymbol("BENCH", 64);
+        bench::Stopwatch registered_sw;
+        registered.submitOrder(book, orders[i], fills);
+        registered_ns += registered_sw.elapsedNs();
+    }
+    bench::report("first order (lazy book)", kEngines, lazy_ns);
+    bench::report("first order (pre-registered)", kEngines, registered_ns);
+}
+
+// Order stream where about a third of the orders cross the spread
+static std::vector<Order> makeStream(size_t count) {
+    bench::Rng rng;
+    std::vector<Order> orders;
+    orders.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Order order = makePassive(i + 1, rng);
+        if (rng.below(3) == 0) {
+            order.price = (order.side == Side::Buy) ? kMid + kHalfRange : kMid - kHalfRange;
+            order.type = OrderType::IOC;
+        }
+        orders.push_back(order);
+    }
+    return orders;
+}
+
+static void benchBatches() {
+    constexpr size_t kStream = 200000;
+    const std::vector<Order> stream = makeStream(kStream);
+    uint64_t events = 0;
+    std::vector<Fill> fills;
+    fills.reserve(1024);
+    
+    {
+        MatchingEngine engine;
+        engine.setFillCallback([&events](const Fill&) { ++events; });
+        engine.setOrderCallback([&events](const Order&) { ++events; });
+        BookHandle book = engine.registerSymbol("BENCH", kStream);
+        bench::Stopwatch sw;
+        for (const Order& order : stream) {
+            fills.clear();
+            engine.submitOrder(book, order, fills);
+        }
+        bench::report("sequential submitOrder", kStream, sw.elapsedNs());
+    }
+    
+    for (size_t batch : {1, 8, 64, 512}) {
+        MatchingEngine engine;
+        engine.setBatchCallback([&events](Span<const Order> o, Span<const Fill> f) {
+            events += o.size() + f.size();
+        });
+        BookHandle book = engine.registerSymbol("BENCH", kStream);
+        std::vector<Order> orders = stream;
+        Span<Order> all(orders);
+        
+        char name[64];
+        std::snprintf(name, sizeof(name), "submitOrders (batch %zu)", batch);
+        bench::Stopwatch sw;
+        for (size_t start = 0; start < kStream; start += batch) {
+            fills.clear();
+            engine.submitOrders(book, all.subspan(start, std::min(batch, kStream - start)), fills);
+        }
+        bench::report(name, kStream, sw.elapsedNs());
+    }
+    bench::doNotOptimize(events);
+}
+
+// Adds CountingListener's events plus market-by-price deltas
+struct LevelCountingListener : CountingListener {
+    uint64_t levels = 0;
+    
+    void onLevelUpdate(const LevelUpdate&) { ++levels; }
+};
+
+// Same order stream with and without level deltas; the market-by-order
+// feed count shows how many per-order events the deltas coalesce
+template <typename Engine>
+static void runStream(const char* name, Engine& engine,
+                      const std::vector<Order>& stream, MboFeed* feed = nullptr) {
+    BookHandle book = engine.registerSymbol("BENCH", stream.size());
+    engine.getOrCreateOrderBook(book.symbolId())->attachFeed(feed);
+    std::vector<Fill> fills;
+    fills.reserve(1024);
+    
+    uint64_t mbo_events = 0;
+    bench::Stopwatch sw;
+    for (const Order& order : stream) {
+        fills.clear();
+        engine.submitOrder(book, order, fills);
+        if (feed) {
+            mbo_events += feed->consume([](const MboEvent&) {}, feed->capacity());
+        }
+    }
+    bench::report(name, stream.size(), sw.elapsedNs());
+    if (feed) {
+        std::printf("    %llu market-by-order events\n",
+                    static_cast<unsigned long long>(mbo_events));
+    }
+}
+
+static void benchLevelUpdates() {
+    const std::vector<Order> stream = makeStream(200000);
+    
+    BasicMatchingEngine<CountingListener> plain;
+    runStream("no level updates", plain, stream);
+    
+    BasicMatchingEngine<LevelCountingListener> deltas;
+    runStream("level updates", deltas, stream);
+    std::printf("    %llu level updates\n",
+                static_cast<unsigned long long>(deltas.listener().levels));
+    
+    MboFeed feed(1 << 12);
+    BasicMatchingEngine<CountingListener> mbo;
+    runStream("market-by-order feed", mbo, stream, &feed);
+    bench::doNotOptimize(plain.listener().fills + mbo.listener().fills);
+}
+
+int main() {
+    std::printf("=== Aggressive Order Throughput (%zu resting orders) ===\n", kOrders);
+    benchBookApis();
+    benchEngineApis();
+    benchListeners();
+    benchHandles();
+    benchBatches();
+    benchLevelUpdates();
+    return 0;
+}
@@ -0,0 +1,261 @@
+#include "../include/order_book.hpp"
+#include "bench_util.hpp"
+#include <vector>
+
+using namespace trading;
+
+// Prices are generated as tick offsets around a 100.00 mid (10000 cent ticks)
+constexpr int64_t kMid = 10000;
+constexpr int64_t kHalfRange = 200;
+constexpr size_t kOrders = 200000;
+
+// Non-crossing passive order: bids below the mid, asks above
+static Order makePassive(OrderId id, bench::Rng& rng) {
+    Side side = (rng.next() & 1) ? Side::Buy : Side::Sell;
+    int64_t offset = 1 + static_cast<int64_t>(rng.below(kHalfRange));
+    Price price = (side == Side::Buy) ? kMid - offset : kMid + offset;
+    Quantity qty = 1 + static_cast<Quantity>(rng.below(100));
+    return Order(id, "BENCH", side, OrderType::Limit, price, qty);
+}
+
+static void benchAdd(const InstrumentSpec& spec) {
+    bench::Rng rng;
+    std::vector<Order> orders;
+    orders.reserve(kOrders);
+    for (size_t i = 0; i < kOrders; ++i) {
+        orders.push_back(makePassive(i + 1, rng));
+    }
+    
+    OrderBook book(spec);
+    bench::Stopwatch sw;
+    for (const auto& order : orders) {
+        book.addOrder(order);
+    }
+    bench::report("add", kOrders, sw.elapsedNs());
+}
+
+static void benchCancel(const InstrumentSpec& spec) {
+    bench::Rng rng;
+    OrderBook book(spec);
+    std::vector<OrderId> ids;
+    ids.reserve(kOrders);
+    for (size_t i = 0; i < kOrders; ++i) {
+        book.addOrder(makePassive(i + 1, rng));
+        ids.push_back(i + 1);
+    }
+    
+    // Cancel in random order so the access pattern is not sequential
+    for (size_t i = ids.size(); i > 1; --i) {
+        std::swap(ids[i - 1], ids[rng.below(i)]);
+    }
+    
+    bench::Stopwatch sw;
+    for (OrderId id : ids) {
+        book.cancelOrder(id);
+    }
+    bench::report("cancel", kOrders, sw.elapsedNs());
+}
+
+static void benchMatch(const InstrumentSpec& spec) {
+    bench::Rng rng;
+    OrderBook book(spec);
+    for (size_t i = 0; i < kOrders; ++i) {
+        book.addOrder(makePassive(i + 1, rng));
+    }
+    
+    // Aggressive orders alternate sides and each take a slice of the touch
+    size_t fills = 0;
+    size_t aggressors = 0;
+    OrderId next_id = kOrders + 1;
+    bench::Stopwatch sw;
+    while (book.bidOrderCount() > 0 && book.askOrderCount() > 0) {
+        Side side = (aggressors & 1) ? Side::Sell : Side::Buy;
+        Price limit = (side == Side::Buy) ? kMid + kHalfRange : kMid - kHalfRange;
+        fills += book.executeFill(side, 150, limit, next_id++).size();
+        ++aggressors;
+    }
+    uint64_t elapsed = sw.elapsedNs();
+    bench::report("match (aggressive orders)", aggressors, elapsed);
+    bench::report("match (fills)", fills, elapsed);
+}
+
+// Quote churn: keep a fixed working set resting and replace one random
+// order per step (cancel + add), the dominant pattern for market makers
+// With a feed, MBO events are published and drained in bulk every 512 steps
+static void benchCancelHeavy(const InstrumentSpec& spec, MboFeed* feed = nullptr) {
+    constexpr size_t kWorkingSet = 20000;
+    constexpr size_t kSteps = 1000000;
+    bench::Rng rng;
+    OrderBook book(spec);
+    std::vector<OrderId> live;
+    live.reserve(kWorkingSet);
+    OrderId next_id = 1;
+    for (size_t i = 0; i < kWorkingSet; ++i) {
+        book.addOrder(makePassive(next_id, rng));
+        live.push_back(next_id++);
+    }
+    
+    uint64_t events = 0;
+    book.attachFeed(feed);
+    bench::Stopwatch sw;
+    for (size_t i = 0; i < kSteps; ++i) {
+        size_t slot = rng.below(kWorkingSet);
+        book.cancelOrder(live[slot]);
+        book.addOrder(makePassive(next_id, rng));
+        live[slot] = next_id++;
+        if (feed && (i & 511) == 511) {
+            events += feed->consume([](const MboEvent&) {});
+        }
+    }
+    bench::report(feed ? "cancel-heavy (with MBO feed)" : "cancel-heavy (cancel+add)",
+                  kSteps, sw.elapsedNs());
+    bench::doNotOptimize(events);
+}
+
+// Wide, sparse ladder: resting asks every kSparseGap ticks across a
+// million-tick band, swept by market buys that empty one level each
+static void benchSparseSweep() {
+    constexpr Price kBand = 1 << 20;
+    constexpr Price kSparseGap = 4096;
+    constexpr int kRounds = 50;
+    InstrumentSpec spec("SPARSE");
+    spec.withArrayLadder(0, kBand);
+    OrderBook book(spec);
+    
+    OrderId id = 1;
+    size_t levels = 0;
+    uint64_t elapsed = 0;
+    for (int round = 0; round < kRounds; ++round) {
+        size_t resting = 0;
+        for (Price price = 1; price < kBand; price += kSparseGap) {
+            book.addOrder(Order(id++, "SPARSE", Side::Sell, OrderType::Limit, price, 10));
+            ++resting;
+        }
+        
+        bench::Stopwatch sw;
+        for (size_t i = 0; i < resting; ++i) {
+            bench::doNotOptimize(book.executeFill(Side::Buy, 10, MAX_PRICE, id++));
+        }
+        elapsed += sw.elapsedNs();
+        levels += resting;
+    }
+    bench::report("sparse sweep (levels)", levels, elapsed);
+}
+
+// Depth queries on a deep book (kOrders resting over 2 * kHalfRange
+// levels): full snapshot copies vs aggregate-only views
+template <size_t N>
+static void benchDepthAt(const OrderBook& book) {
+    constexpr size_t kQueries = 20000;
+    constexpr size_t kSnapshotQueries = 200;  // Each copies ~250 orders/level
+    char name[64];
+    
+    bench::Stopwatch snapshot_sw;
+    for (size_t i = 0; i < kSnapshotQueries; ++i) {
+        bench::doNotOptimize(book.getBidLevels(N));
+    }
+    std::snprintf(name, sizeof(name), "depth %zu (getBidLevels)", N);
+    bench::report(name, kSnapshotQueries, snapshot_sw.elapsedNs());
+    
+    bench::Stopwatch array_sw;
+    for (size_t i = 0; i < kQueries; ++i) {
+        bench::doNotOptimize(book.getDepth<N>(Side::Buy));
+    }
+    std::snprintf(name, sizeof(name), "depth %zu (getDepth array)", N);
+    bench::report(name, kQueries, array_sw.elapsedNs());
+    
+    Quantity total = 0;
+    bench::Stopwatch visit_sw;
+    for (size_t i = 0; i < kQueries; ++i) {
+        book.visitDepth(Side::Buy, N, [&total](const DepthLevel& level) {
+            total += level.quantity;
+            return true;
+        });
+    }
+    std::snprintf(name, sizeof(name), "depth %zu (visitDepth)", N);
+    bench::report(name, kQueries, visit_sw.elapsedNs());
+    bench::doNotOptimize(total);
+}
+
+static void benchDepth(const InstrumentSpec& spec) {
+    bench::Rng rng;
+    OrderBook book(spec);
+    for (size_t i = 0; i < kOrders; ++i) {
+        book.addOrder(makePassive(i + 1, rng));
+    }
+    benchDepthAt<5>(book);
+    benchDepthAt<10>(book);
+    benchDepthAt<50>(book);
+    
+    // Pollers compare versions and only re-read books that changed
+    constexpr size_t kPolls = 1000000;
+    uint64_t seen = 0;
+    size_t reads = 0;
+    bench::Stopwatch sw;
+    for (size_t i = 0; i < kPolls; ++i) {
+        if (book.version() != seen) {
+            seen = book.version();
+            bench::doNotOptimize(book.getDepth<5>(Side::Buy));
+            ++reads;
+        }
+    }
+    bench::report("poll unchanged (version check)", kPolls, sw.elapsedNs());
+    bench::doNotOptimize(reads);
+}
+
+// Pre-trade liquidity checks (FOK): covered at the touch, needing levels
+// beyond the depth cache, and not coverable within the limit
+static void benchLiquidity(const InstrumentSpec& spec) {
+    bench::Rng rng;
+    OrderBook book(spec);
+    for (size_t i = 0; i < kOrders; ++i) {
+        book.addOrder(makePassive(i + 1, rng));
+    }
+    
+    constexpr size_t kQueries = 1000000;
+    struct Case {
+        const char* name;
+        Price limit;
+        Quantity needed;
+    };
+    const Case cases[] = {
+        {"liquidity (covered at touch)", kMid + kHalfRange, 10},
+        {"liquidity (beyond cached levels)", kMid + kHalfRange, 5000000},
+        {"liquidity (not covered)", kMid + 20, 1000000000},
+    };
+    for (const Case& c : cases) {
+        Quantity total = 0;
+        bench::Stopwatch sw;
+        for (size_t i = 0; i < kQueries; ++i) {
+            total += book.availableLiquidity(Side::Buy, c.limit, c.needed + (i & 7));
+        }
+        bench::report(c.name, kQueries, sw.elapsedNs());
+        bench::doNotOptimize(total);
+    }
+}
+
+int main() {
+    InstrumentSpec map_spec("BENCH");
+    InstrumentSpec array_spec("BENCH");
+    array_spec.withArrayLadder(kMid - 4096, 8192);
+    
+    std::printf("=== Order Book Benchmark (%zu orders, map layout) ===\n", kOrders);
+    benchAdd(map_spec);
+    benchCancel(map_spec);
+    benchMatch(map_spec);
+    benchCancelHeavy(map_spec);
+    benchDepth(map_spec);
+    benchLiquidity(map_spec);
+    
+    std::printf("=== Order Book Benchmark (%zu orders, array layout) ===\n", kOrders);
+    benchAdd(array_spec);
+    benchCancel(array_spec);
+    benchMatch(array_spec);
+    benchCancelHeavy(array_spec);
+    MboFeed feed(4096);
+    benchCancelHeavy(array_spec, &feed);
+    benchDepth(array_spec);
+    benchLiquidity(array_spec);
+    benchSparseSweep();
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "../include/engine_pipeline.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace trading;
+
+constexpr size_t kSymbols = 64;
+constexpr size_t kCommands = 2000000;
+constexpr int64_t kMid = 10000;
+constexpr int64_t kHalfRange = 200;
+
+// Day-like flow: resting orders, cancels and some crossing orders
+static std::vector<EngineCommand> makeFlow(const std::vector<SymbolId>& symbols) {
+    bench::Rng rng(0x2545F4914F6CDD1DULL);
+    std::vector<EngineCommand> commands;
+    commands.reserve(kCommands);
+    std::vector<std::pair<SymbolId, OrderId>> submitted;
+    OrderId next_id = 0;
+    for (size_t i = 0; i < kCommands; ++i) {
+        uint64_t action = rng.below(10);
+        if (action < 3 && !submitted.empty()) {
+            const auto& target = submitted[rng.below(submitted.size())];
+            commands.push_back(EngineCommand::cancel(target.first, target.second));
+            continue;
+        }
+        SymbolId symbol = symbols[rng.below(kSymbols)];
+        Side side = (rng.next() & 1) ? Side::Buy : Side::Sell;
+        int64_t offset = action == 9 ? -2 : 1 + static_cast<int64_t>(rng.below(kHalfRange));
+        Price price = (side == Side::Buy) ? kMid - offset : kMid + offset;
+        Quantity quantity = 1 + static_cast<Quantity>(rng.below(100));
+        commands.push_back(EngineCommand::submit(
+            Order(++next_id, symbol, side, OrderType::Limit, price, quantity)));
+        submitted.emplace_back(symbol, next_id);
+    }
+    return commands;
+}
+
+// Counts events so the publishing work is not optimized away
+struct CountingListener : NullListener {
+    uint64_t events = 0;
+
+    void onFill(const Fill&) { ++events; }
+    void onOrder(const Order&) { ++events; }
+};
+
+static std::shared_ptr<RiskManager> makeRisk() {
+    auto risk = std::make_shared<RiskManager>();
+    for (size_t s = 0; s < kSymbols; ++s) {
+        risk->setPositionLimit("PL" + std::to_string(s), 1000000000);
+        risk->setNotionalLimit("PL" + std::to_string(s), 1e15);
+    }
+    return risk;
+}
+
+static std::shared_ptr<OrderJournal> openJournal(const std::string& path) {
+    std::remove(path.c_str());
+    JournalOptions options;
+    options.fsync = FsyncPolicy::None;
+    options.group_size = 64;
+    auto journal = std::make_shared<OrderJournal>();
+    journal->open(path, options);
+    return journal;
+}
+
+// Baseline: risk check, journal, match, positions and events on one thread
+static uint64_t benchSerial(const std::vector<EngineCommand>& commands, const std::string& path) {
+    BasicMatchingEngine<CountingListener> engine;
+    for (size_t s = 0; s < kSymbols; ++s) {
+        engine.registerSymbol("PL" + std::to_string(s), kCommands / kSymbols);
+    }
+    engine.setRiskManager(makeRisk());
+    auto journal = openJournal(path);
+    engine.setJournal(journal);
+    std::vector<Fill> fills;
+
+    bench::Stopwatch sw;
+    for (const EngineCommand& command : commands) {
+        applyCommand(engine, command, fills);
+    }
+    journal->commit();
+    uint64_t elapsed = sw.elapsedNs();
+    bench::doNotOptimize(engine.listener().events);
+    journal->close();
+    std::remove(path.c_str());
+    return elapsed;
+}
+
+// The same work spread over the pipeline's three stage threads
+static uint64_t benchPipeline(const std::vector<EngineCommand>& commands,
+                              const std::string& path, bool pin) {
+    PipelineOptions options;
+    options.pin_threads = pin;
+    options.first_cpu = 1;    // Leave CPU 0 to the publishing thread
+    EnginePipeline<CountingListener> pipeline(options);
+    for (size_t s = 0; s < kSymbols; ++s) {
+        pipeline.registerSymbol("PL" + std::to_string(s), kCommands / kSymbols);
+    }
+    pipeline.setRiskManager(makeRisk());
+    auto journal = openJournal(path);
+    pipeline.setJournal(journal);
+    pipeline.start();
+
+    bench::Stopwatch sw;
+    for (const EngineCommand& command : commands) {
+        pipeline.publish(command);
+    }
+    pipeline.stop();
+    uint64_t elapsed = sw.elapsedNs();
+    bench::doNotOptimize(pipeline.listener().events);
+    journal->close();
+    std::remove(path.c_str());
+    return elapsed;
+}
+
+int main() {
+    std::printf("=== Staged Pipeline (%zu commands over %zu symbols, %u hardware threads) ===\n",
+                kCommands, kSymbols, std::thread::hardware_concurrency());
+
+    std::vector<SymbolId> symbols;
+    for (size_t s = 0; s < kSymbols; ++s) {
+        symbols.push_back(internSymbol("PL" + std::to_string(s)));
+    }
+    std::vector<EngineCommand> commands = makeFlow(symbols);
+    std::string path = "bench_pipeline_" + std::to_string(::getpid()) + ".bin";
+
+    bench::report("serial engine (risk + journal)", kCommands, benchSerial(commands, path));
+    bench::report("pipeline, unpinned", kCommands, benchPipeline(commands, path, false));
+    bench::report("pipeline, stages pinned", kCommands, benchPipeline(commands, path, true));
+    return 0;
+}
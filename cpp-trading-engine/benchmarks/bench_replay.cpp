@@ -0,0 +1,150 @@
+#include "../include/journal_replay.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace trading;
+
+constexpr size_t kSymbols = 64;
+constexpr size_t kCommands = 1000000;
+constexpr int64_t kMid = 10000;
+constexpr int64_t kHalfRange = 200;
+
+// Journal a day-like flow: mostly resting orders and cancels, a third of
+// the submits crossing, spread over kSymbols books
+static uint64_t writeJournal(const std::string& path) {
+    std::remove(path.c_str());
+    JournalOptions options;
+    options.fsync = FsyncPolicy::None;
+    options.group_size = 64;
+    auto journal = std::make_shared<OrderJournal>();
+    if (!journal->open(path, options)) {
+        std::printf("cannot open journal %s\n", path.c_str());
+        return 0;
+    }
+
+    BasicMatchingEngine<NullListener> engine;
+    engine.setJournal(journal);
+    std::vector<BookHandle> books;
+    for (size_t s = 0; s < kSymbols; ++s) {
+        books.push_back(engine.registerSymbol("RP" + std::to_string(s)));
+    }
+
+    bench::Rng rng;
+    std::vector<Fill> fills;
+    std::vector<std::pair<BookHandle, OrderId>> submitted;
+    OrderId next_id = 1;
+    bench::Stopwatch sw;
+    for (size_t i = 0; i < kCommands; ++i) {
+        uint64_t action = rng.below(10);
+        if (action < 3 && !submitted.empty()) {
+            size_t pick = rng.below(submitted.size());
+            if (action == 2) {
+                engine.modifyOrder(submitted[pick].first, submitted[pick].second, 0,
+                                   1 + static_cast<Quantity>(rng.below(100)));
+                continue;
+            }
+            engine.cancelOrder(submitted[pick].first, submitted[pick].second);
+            submitted[pick] = submitted.back();
+            submitted.pop_back();
+            continue;
+        }
+
+        Side side = (rng.next() & 1) ? Side::Buy : Side::Sell;
+        int64_t offset = 1 + static_cast<int64_t>(rng.below(kHalfRange));
+        Price price = (side == Side::Buy) ? kMid - offset : kMid + offset;
+        OrderType type = OrderType::Limit;
+        if (rng.below(3) == 0) {
+            price = (side == Side::Buy) ? kMid + kHalfRange : kMid - kHalfRange;
+            type = OrderType::IOC;
+        }
+        BookHandle book = books[rng.below(kSymbols)];
+        fills.clear();
+        engine.submitOrder(book, Order(next_id, book.symbolId(), side, type, price,
+                                       1 + static_cast<Quantity>(rng.below(100))), fills);
+        submitted.emplace_back(book, next_id++);
+    }
+    uint64_t hash = engine.journalCheckpoint();
+    bench::report("live engine (journaling)", kCommands, sw.elapsedNs());
+    std::printf("    %.1f MB journal\n", journal->bytesWritten() / 1e6);
+    return hash;
+}
+
+// Reference: read record by record and re-drive a callback engine with
+// risk checks, as a plain restart would
+static void benchSequential(const std::string& path) {
+    MatchingEngine engine;
+    uint64_t fill_count = 0;
+    engine.setFillCallback([&fill_count](const Fill&) { ++fill_count; });
+    engine.setRiskManager(std::make_shared<RiskManager>());
+
+    bench::Stopwatch sw;
+    JournalReader reader;
+    if (!reader.open(path)) {
+        return;
+    }
+    JournalRecord record;
+    InstrumentSpec spec;
+    std::vector<Fill> fills;
+    uint64_t commands = 0;
+    while (reader.next(record, spec)) {
+        switch (record.type) {
+            case CommandType::Instrument:
+                engine.registerInstrument(spec);
+                break;
+            case CommandType::Submit:
+                fills.clear();
+                engine.submitOrder(record.toOrder(), fills);
+                ++commands;
+                break;
+            case CommandType::Cancel:
+                engine.cancelOrder(record.symbol, record.order_id);
+                ++commands;
+                break;
+            case CommandType::Modify:
+                engine.modifyOrder(record.symbol, record.order_id, record.price, record.quantity);
+                ++commands;
+                break;
+            default:
+                break;
+        }
+    }
+    bench::report("sequential re-drive (callbacks)", commands, sw.elapsedNs());
+    bench::doNotOptimize(fill_count);
+}
+
+static void benchReplay(const std::string& path, size_t threads, uint64_t expected_hash) {
+    MatchingEngine engine;
+    ReplayOptions options;
+    options.threads = threads;
+
+    bench::Stopwatch sw;
+    ReplayResult result = replayJournal(path, engine, options);
+    uint64_t elapsed = sw.elapsedNs();
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "replay, %zu thread%s", result.partitions,
+                  result.partitions > 1 ? "s" : "");
+    bench::report(name, result.commands, elapsed);
+    std::printf("    %.1f ms, %llu fills, checkpoint %s\n", elapsed / 1e6,
+                static_cast<unsigned long long>(result.fills),
+                result.ok && result.state_hash == expected_hash ? "verified" : "MISMATCH");
+}
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : "bench_replay.bin";
+    std::printf("=== Journal Replay (%zu commands, %zu symbols, hardware threads: %u) ===\n",
+                kCommands, kSymbols, std::thread::hardware_concurrency());
+
+    uint64_t hash = writeJournal(path);
+    benchSequential(path);
+    for (size_t threads : {1, 2, 4, 8}) {
+        benchReplay(path, threads, hash);
+    }
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "../include/command_sequencer.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace trading;
+
+constexpr size_t kSymbols = 64;
+constexpr size_t kCommands = 2000000;
+constexpr int64_t kMid = 10000;
+constexpr int64_t kHalfRange = 200;
+
+// One producer's share of a day-like flow: resting orders, cancels of its
+// own orders and some crossing orders, with ids no other producer uses
+static std::vector<EngineCommand> makeFlow(const std::vector<SymbolId>& symbols,
+                                           size_t producer, size_t count) {
+    bench::Rng rng(0x9E3779B97F4A7C15ULL + producer);
+    std::vector<EngineCommand> commands;
+    commands.reserve(count);
+    std::vector<std::pair<SymbolId, OrderId>> submitted;
+    OrderId next_id = static_cast<OrderId>(producer) << 40;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t action = rng.below(10);
+        if (action < 3 && !submitted.empty()) {
+            const auto& target = submitted[rng.below(submitted.size())];
+            commands.push_back(EngineCommand::cancel(target.first, target.second));
+            continue;
+        }
+        SymbolId symbol = symbols[rng.below(kSymbols)];
+        Side side = (rng.next() & 1) ? Side::Buy : Side::Sell;
+        int64_t offset = action == 9 ? -2 : 1 + static_cast<int64_t>(rng.below(kHalfRange));
+        Price price = (side == Side::Buy) ? kMid - offset : kMid + offset;
+        Quantity quantity = 1 + static_cast<Quantity>(rng.below(100));
+        commands.push_back(EngineCommand::submit(
+            Order(++next_id, symbol, side, OrderType::Limit, price, quantity)));
+        submitted.emplace_back(symbol, next_id);
+    }
+    return commands;
+}
+
+static void registerBooks(BasicMatchingEngine<NullListener>& engine) {
+    for (size_t s = 0; s < kSymbols; ++s) {
+        engine.registerSymbol("SQ" + std::to_string(s), kCommands / kSymbols);
+    }
+}
+
+// Baseline: every gateway thread locks the engine around each command
+static uint64_t benchMutex(const std::vector<std::vector<EngineCommand>>& flows) {
+    BasicMatchingEngine<NullListener> engine;
+    registerBooks(engine);
+    std::mutex mutex;
+
+    bench::Stopwatch sw;
+    std::vector<std::thread> producers;
+    for (const auto& flow : flows) {
+        producers.emplace_back([&engine, &mutex, &flow]() {
+            std::vector<Fill> fills;
+            for (const EngineCommand& command : flow) {
+                std::lock_guard<std::mutex> lock(mutex);
+                applyCommand(engine, command, fills);
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    uint64_t elapsed = sw.elapsedNs();
+    bench::doNotOptimize(engine.stateHash());
+    return elapsed;
+}
+
+// Gateway threads publish into the sequencer; one engine thread drains it
+static uint64_t benchSequencer(const std::vector<std::vector<EngineCommand>>& flows,
+                               WaitStrategy wait, uint64_t& sleeps) {
+    BasicMatchingEngine<NullListener> engine;
+    registerBooks(engine);
+    CommandSequencer sequencer(65536, wait);
+    EngineLoop<NullListener, CommandSequencer> loop(engine, sequencer);
+    std::thread engine_thread([&loop]() { loop.run(); });
+
+    bench::Stopwatch sw;
+    std::vector<std::thread> producers;
+    for (const auto& flow : flows) {
+        producers.emplace_back([&sequencer, &flow]() {
+            for (const EngineCommand& command : flow) {
+                sequencer.publish(command);
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    loop.stop();
+    engine_thread.join();
+    uint64_t elapsed = sw.elapsedNs();
+    sleeps = sequencer.sleeps();
+    bench::doNotOptimize(engine.stateHash());
+    return elapsed;
+}
+
+int main() {
+    std::printf("=== MPSC Sequencer (%zu commands over %zu symbols, %u hardware threads) ===\n",
+                kCommands, kSymbols, std::thread::hardware_concurrency());
+
+    std::vector<SymbolId> symbols;
+    for (size_t s = 0; s < kSymbols; ++s) {
+        symbols.push_back(internSymbol("SQ" + std::to_string(s)));
+    }
+
+    for (size_t producers : {1, 2, 4, 8, 16}) {
+        std::vector<std::vector<EngineCommand>> flows;
+        for (size_t p = 0; p < producers; ++p) {
+            flows.push_back(makeFlow(symbols, p, kCommands / producers));
+        }
+        std::printf("%zu producer%s\n", producers, producers == 1 ? "" : "s");
+
+        bench::report("  mutex around the engine", kCommands, benchMutex(flows));
+        for (WaitStrategy wait : {WaitStrategy::SpinYield, WaitStrategy::Block}) {
+            uint64_t sleeps = 0;
+            uint64_t elapsed = benchSequencer(flows, wait, sleeps);
+            char name[64];
+            std::snprintf(name, sizeof(name), "  sequencer, %s", to_string(wait));
+            bench::report(name, kCommands, elapsed);
+            if (wait == WaitStrategy::Block) {
+                std::printf("    engine thread slept %llu times\n",
+                            static_cast<unsigned long long>(sleeps));
+            }
+        }
+    }
+    return 0;
+}
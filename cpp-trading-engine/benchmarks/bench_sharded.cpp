@@ -0,0 +1,125 @@
+#include "../include/sharded_engine.hpp"
+#include "bench_util.hpp"
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace trading;
+
+constexpr size_t kSymbols = 64;
+constexpr size_t kCommands = 2000000;
+constexpr int64_t kMid = 10000;
+constexpr int64_t kHalfRange = 200;
+
+// Day-like flow spread evenly over kSymbols books: resting orders, cancels
+// and a share of crossing orders
+static std::vector<EngineCommand> makeFlow(const std::vector<SymbolId>& symbols) {
+    bench::Rng rng;
+    std::vector<EngineCommand> commands;
+    commands.reserve(kCommands);
+    std::vector<std::pair<SymbolId, OrderId>> submitted;
+    OrderId next_id = 1;
+    for (size_t i = 0; i < kCommands; ++i) {
+        uint64_t action = rng.below(10);
+        if (action < 3 && !submitted.empty()) {
+            const auto& target = submitted[rng.below(submitted.size())];
+            commands.push_back(EngineCommand::cancel(target.first, target.second));
+            continue;
+        }
+        SymbolId symbol = symbols[rng.below(kSymbols)];
+        Side side = (rng.next() & 1) ? Side::Buy : Side::Sell;
+        int64_t offset = 1 + static_cast<int64_t>(rng.below(kHalfRange));
+        if (action == 9) {
+            offset = -2;    // Crosses the spread
+        }
+        Price price = (side == Side::Buy) ? kMid - offset : kMid + offset;
+        Quantity quantity = 1 + static_cast<Quantity>(rng.below(100));
+        commands.push_back(EngineCommand::submit(
+            Order(next_id, symbol, side, OrderType::Limit, price, quantity)));
+        submitted.emplace_back(symbol, next_id++);
+    }
+    return commands;
+}
+
+static uint64_t benchSingle(const std::vector<EngineCommand>& commands) {
+    BasicMatchingEngine<NullListener> engine;
+    for (size_t s = 0; s < kSymbols; ++s) {
+        engine.registerSymbol("SH" + std::to_string(s), kCommands / kSymbols);
+    }
+    std::vector<Fill> fills;
+    bench::Stopwatch sw;
+    for (const EngineCommand& command : commands) {
+        applyCommand(engine, command, fills);
+    }
+    uint64_t elapsed = sw.elapsedNs();
+    bench::report("single engine, caller's thread", commands.size(), elapsed);
+    bench::doNotOptimize(engine.stateHash());
+    return elapsed;
+}
+
+static void benchSharded(const std::vector<EngineCommand>& commands, size_t shards,
+                         uint64_t single_ns) {
+    ShardOptions options;
+    options.shards = shards;
+    ShardedEngine engine(options);
+    for (size_t s = 0; s < kSymbols; ++s) {
+        engine.registerSymbol("SH" + std::to_string(s), kCommands / kSymbols);
+    }
+    engine.start();
+
+    // One consumer thread drains every shard's output ring
+    std::atomic<bool> done{false};
+    uint64_t events = 0;
+    std::thread consumer([&]() {
+        for (;;) {
+            bool finished = done.load(std::memory_order_acquire);
+            size_t drained = 0;
+            for (size_t shard = 0; shard < engine.shardCount(); ++shard) {
+                drained += engine.consumeEvents(shard, [](const EngineEvent&) {});
+            }
+            events += drained;
+            if (drained == 0) {
+                if (finished) {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bench::Stopwatch sw;
+    for (const EngineCommand& command : commands) {
+        engine.submit(command);
+    }
+    engine.waitIdle();
+    uint64_t elapsed = sw.elapsedNs();
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    engine.stop();
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%zu shard%s", shards, shards == 1 ? "" : "s");
+    bench::report(name, commands.size(), elapsed);
+    std::printf("    %.2fx the single engine, %llu events published\n",
+                static_cast<double>(single_ns) / elapsed, static_cast<unsigned long long>(events));
+}
+
+int main() {
+    std::printf("=== Sharded Engine (%zu commands over %zu symbols, %u hardware threads) ===\n",
+                kCommands, kSymbols, std::thread::hardware_concurrency());
+
+    std::vector<SymbolId> symbols;
+    for (size_t s = 0; s < kSymbols; ++s) {
+        symbols.push_back(internSymbol("SH" + std::to_string(s)));
+    }
+    std::vector<EngineCommand> commands = makeFlow(symbols);
+
+    uint64_t single_ns = benchSingle(commands);
+    for (size_t shards : {1, 2, 4, 8}) {
+        benchSharded(commands, shards, single_ns);
+    }
+    return 0;
+}
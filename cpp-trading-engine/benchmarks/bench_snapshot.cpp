@@ -0,0 +1,184 @@
+#include "../include/engine_snapshot.hpp"
+#include "../include/fork_snapshot.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace trading;
+
+constexpr size_t kSymbols = 64;
+constexpr size_t kRestingOrders = 1000000;
+constexpr size_t kTailCommands = 100000;
+constexpr int64_t kMid = 10000;
+constexpr int64_t kHalfRange = 200;
+
+struct Flow {
+    bench::Rng rng;
+    std::vector<BookHandle> books;
+    std::vector<std::pair<BookHandle, OrderId>> resting;
+    std::vector<Fill> fills;
+    OrderId next_id = 1;
+};
+
+// Build depth without crossing: bids below the mid, asks above
+static void buildDepth(BasicMatchingEngine<NullListener>& engine, Flow& flow) {
+    for (size_t i = 0; i < kRestingOrders; ++i) {
+        Side side = (flow.rng.next() & 1) ? Side::Buy : Side::Sell;
+        int64_t offset = 1 + static_cast<int64_t>(flow.rng.below(kHalfRange));
+        Price price = (side == Side::Buy) ? kMid - offset : kMid + offset;
+        BookHandle book = flow.books[flow.rng.below(kSymbols)];
+        flow.fills.clear();
+        engine.submitOrder(book, Order(flow.next_id, book.symbolId(), side, OrderType::Limit,
+                                       price, 1 + static_cast<Quantity>(flow.rng.below(100))),
+                           flow.fills);
+        flow.resting.emplace_back(book, flow.next_id++);
+    }
+}
+
+// Day-like flow after the snapshot: cancels, modifies and crossing orders
+static void tradeTail(BasicMatchingEngine<NullListener>& engine, Flow& flow, size_t commands) {
+    for (size_t i = 0; i < commands; ++i) {
+        uint64_t action = flow.rng.below(10);
+        size_t pick = flow.rng.below(flow.resting.size());
+        if (action < 2) {
+            engine.cancelOrder(flow.resting[pick].first, flow.resting[pick].second);
+            continue;
+        }
+        if (action == 2) {
+            engine.modifyOrder(flow.resting[pick].first, flow.resting[pick].second, 0,
+                               1 + static_cast<Quantity>(flow.rng.below(100)));
+            continue;
+        }
+        Side side = (flow.rng.next() & 1) ? Side::Buy : Side::Sell;
+        Price price = (side == Side::Buy) ? kMid + 2 : kMid - 2;
+        OrderType type = flow.rng.below(3) == 0 ? OrderType::IOC : OrderType::Limit;
+        BookHandle book = flow.books[flow.rng.below(kSymbols)];
+        flow.fills.clear();
+        engine.submitOrder(book, Order(flow.next_id, book.symbolId(), side, type, price,
+                                       1 + static_cast<Quantity>(flow.rng.below(100))),
+                           flow.fills);
+        flow.resting.emplace_back(book, flow.next_id++);
+    }
+}
+
+// Reference: rebuild the same books by adding every resting order in turn
+static void benchAddOrder(const BasicMatchingEngine<NullListener>& engine) {
+    std::vector<Order> orders;
+    orders.reserve(kRestingOrders);
+    std::vector<const OrderBook*> sources;
+    engine.forEachBook([&](const OrderBook& book) {
+        sources.push_back(&book);
+        for (Side side : {Side::Buy, Side::Sell}) {
+            book.visitLevels(side, [&orders](const PriceLevel& level) {
+                for (const Order& order : level.orders) {
+                    orders.push_back(order);
+                }
+            });
+        }
+    });
+
+    bench::Stopwatch sw;
+    std::vector<std::unique_ptr<OrderBook>> books;
+    size_t next = 0;
+    for (const OrderBook* source : sources) {
+        books.push_back(std::make_unique<OrderBook>(source->instrument()));
+        books.back()->reserveOrders(source->totalOrderCount());
+        for (size_t end = next + source->totalOrderCount(); next < end; ++next) {
+            books.back()->addOrder(orders[next]);
+        }
+    }
+    bench::report("rebuild by addOrder per order", orders.size(), sw.elapsedNs());
+    bench::doNotOptimize(books.back()->totalOrderCount());
+}
+
+// Forked snapshot: keep matching until the child has written the file
+static void benchFork(const std::string& path, BasicMatchingEngine<NullListener>& engine,
+                      Flow& flow) {
+    ForkSnapshot snapshot;
+    if (!snapshot.start(path, engine)) {
+        std::printf("fork snapshot failed to start\n");
+        return;
+    }
+    size_t commands = 0;
+    while (!snapshot.poll()) {
+        tradeTail(engine, flow, 1000);
+        commands += 1000;
+    }
+    const ForkSnapshotMetrics& metrics = snapshot.metrics();
+    std::printf("  fork snapshot: parent stalled %.2f ms (fork %.2f ms), child wrote in %.1f ms\n",
+                metrics.stall_ns / 1e6, metrics.fork_ns / 1e6, metrics.write_ns / 1e6);
+    std::printf("    %zu commands matched meanwhile, %.1f MB duplicated by copy-on-write, %s\n",
+                commands, metrics.cow_bytes / 1e6, snapshot.info().ok ? "ok" : "FAILED");
+    std::remove(path.c_str());
+}
+
+static void benchRestore(const std::string& path, uint64_t expected_hash) {
+    BasicMatchingEngine<NullListener> engine;
+    bench::Stopwatch sw;
+    SnapshotInfo info = restoreSnapshot(path, engine);
+    bench::report("restore from mapped snapshot", info.orders, sw.elapsedNs());
+    std::printf("    %s\n", info.ok && engine.stateHash() == expected_hash ? "verified" : "MISMATCH");
+}
+
+int main(int argc, char** argv) {
+    std::string snapshot_path = argc > 1 ? argv[1] : "bench_snapshot.snap";
+    std::string journal_path = snapshot_path + ".journal";
+    std::printf("=== Engine Snapshot (%zu resting orders, %zu symbols, %zu tail commands) ===\n",
+                kRestingOrders, kSymbols, kTailCommands);
+
+    std::remove(journal_path.c_str());
+    JournalOptions options;
+    options.fsync = FsyncPolicy::None;
+    options.group_size = 64;
+    auto journal = std::make_shared<OrderJournal>();
+    if (!journal->open(journal_path, options)) {
+        std::printf("cannot open journal %s\n", journal_path.c_str());
+        return 1;
+    }
+
+    BasicMatchingEngine<NullListener> engine;
+    engine.setJournal(journal);
+    Flow flow;
+    for (size_t s = 0; s < kSymbols; ++s) {
+        flow.books.push_back(engine.registerSymbol("SN" + std::to_string(s)));
+    }
+    buildDepth(engine, flow);
+
+    bench::Stopwatch sw;
+    SnapshotInfo saved = saveSnapshot(snapshot_path, engine);
+    uint64_t elapsed = sw.elapsedNs();
+    bench::report("save snapshot (incl. fsync)", saved.orders, elapsed);
+    std::printf("    %.1f ms, %.1f MB\n", elapsed / 1e6,
+                (56.0 + saved.books * 64 + saved.orders * 24) / 1e6);
+
+    benchRestore(snapshot_path, saved.state_hash);
+    benchAddOrder(engine);
+    benchFork(snapshot_path + ".fork", engine, flow);
+
+    // Recovery: snapshot plus journal tail against the whole journal
+    tradeTail(engine, flow, kTailCommands);
+    uint64_t live_hash = engine.journalCheckpoint();
+    journal->close();
+
+    for (int full = 0; full < 2; ++full) {
+        BasicMatchingEngine<NullListener> recovered;
+        ReplayOptions replay_options;
+        replay_options.threads = 1;
+        sw.reset();
+        ReplayResult result = full ? replayJournal(journal_path, recovered, replay_options)
+                                   : recoverEngine(snapshot_path, journal_path, recovered,
+                                                   replay_options);
+        elapsed = sw.elapsedNs();
+        std::printf("  %-40s %8.1f ms  (%llu commands replayed) %s\n",
+                    full ? "recover: whole journal" : "recover: snapshot + tail", elapsed / 1e6,
+                    static_cast<unsigned long long>(result.commands),
+                    result.ok && result.state_hash == live_hash ? "verified" : "MISMATCH");
+    }
+
+    std::remove(snapshot_path.c_str());
+    std::remove(journal_path.c_str());
+    return 0;
+}
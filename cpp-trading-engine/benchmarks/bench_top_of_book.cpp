@@ -0,0 +1,141 @@
+#include "../include/order_book.hpp"
+#include "bench_util.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace trading;
+
+constexpr size_t kReads = 5000000;
+
+// Quote a reader would compute from the book on its own thread
+static Price spreadOf(const OrderBook& book) {
+    auto bid = book.getBestBid();
+    auto ask = book.getBestAsk();
+    return (bid && ask) ? ask->first - bid->first : 0;
+}
+
+static OrderBook makeBook() {
+    OrderBook book(InstrumentSpec("BENCH").withArrayLadder(9000, 2000));
+    bench::Rng rng;
+    for (OrderId id = 1; id <= 10000; ++id) {
+        Side side = (id & 1) ? Side::Buy : Side::Sell;
+        Price offset = 1 + static_cast<Price>(rng.below(200));
+        book.addOrder(Order(id, "BENCH", side, OrderType::Limit,
+                            side == Side::Buy ? 10000 - offset : 10000 + offset,
+                            1 + static_cast<Quantity>(rng.below(100))));
+    }
+    return book;
+}
+
+static void benchUncontended() {
+    OrderBook book = makeBook();
+    const TopOfBook& top = book.topOfBook();
+
+    Price sum = 0;
+    bench::Stopwatch sw;
+    for (size_t i = 0; i < kReads; ++i) {
+        sum += spreadOf(book);
+        bench::doNotOptimize(sum);
+    }
+    bench::report("book getBestBid/Ask (owner)", kReads, sw.elapsedNs());
+
+    sw.reset();
+    for (size_t i = 0; i < kReads; ++i) {
+        sum += top.read().getSpread().value_or(0);
+        bench::doNotOptimize(sum);
+    }
+    bench::report("seqlock read (no writer)", kReads, sw.elapsedNs());
+    bench::doNotOptimize(sum);
+}
+
+static void benchPublish() {
+    TopOfBook top;
+    bench::Stopwatch sw;
+    for (size_t i = 0; i < kReads; ++i) {
+        Price p = 10000 + static_cast<Price>(i & 63);
+        top.publish(p, 100, p + 1, 100);
+    }
+    bench::report("seqlock publish (writer)", kReads, sw.elapsedNs());
+}
+
+// Readers poll the quote while the book's thread churns the touch; reads
+// are timed in chunks so clock overhead stays out of the per-read figure
+static void benchWithWriter(int readers) {
+    constexpr size_t kChunk = 64;
+    OrderBook book = makeBook();
+    const TopOfBook& top = book.topOfBook();
+    std::atomic<bool> done{false};
+    std::atomic<int> running{0};
+
+    std::vector<std::vector<uint64_t>> chunk_ns(readers);
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            running.fetch_add(1);
+            std::vector<uint64_t>& samples = chunk_ns[r];
+            samples.reserve(kReads / kChunk);
+            Price sum = 0;
+            while (!done.load(std::memory_order_relaxed) && samples.size() < kReads / kChunk) {
+                bench::Stopwatch sw;
+                for (size_t i = 0; i < kChunk; ++i) {
+                    sum += top.read().getSpread().value_or(0);
+                }
+                samples.push_back(sw.elapsedNs());
+            }
+            bench::doNotOptimize(sum);
+        });
+    }
+    while (running.load() < readers) {
+        std::this_thread::yield();
+    }
+
+    // Writer: repeatedly improve and withdraw the best bid
+    uint64_t publishes = top.sequence();
+    OrderId next_id = 1000000;
+    bench::Stopwatch writer_sw;
+    for (size_t i = 0; i < 500000; ++i) {
+        book.addOrder(Order(next_id, "BENCH", Side::Buy, OrderType::Limit, 9999, 10));
+        book.cancelOrder(next_id++);
+    }
+    uint64_t writer_ns = writer_sw.elapsedNs();
+    publishes = top.sequence() - publishes;
+    done.store(true);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<uint64_t> all;
+    for (const auto& samples : chunk_ns) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    uint64_t total = 0;
+    for (uint64_t ns : all) {
+        total += ns;
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "seqlock read (%d reader%s)", readers,
+                  readers > 1 ? "s" : "");
+    bench::report(name, all.size() * kChunk, total);
+    if (!all.empty()) {
+        std::printf("    per read: p50 %.1f ns, p99 %.1f ns\n",
+                    static_cast<double>(all[all.size() / 2]) / kChunk,
+                    static_cast<double>(all[all.size() * 99 / 100]) / kChunk);
+    }
+    bench::report("  writer add+cancel at touch", 500000, writer_ns);
+    bench::doNotOptimize(publishes);
+}
+
+int main() {
+    std::printf("=== Top of Book Reads (hardware threads: %u) ===\n",
+                std::thread::hardware_concurrency());
+    benchUncontended();
+    benchPublish();
+    for (int readers : {1, 2, 4}) {
+        benchWithWriter(readers);
+    }
+    return 0;
+}
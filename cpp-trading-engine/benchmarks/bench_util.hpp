@@ -0,0 +1,88 @@
+#ifndef TRADING_BENCH_UTIL_HPP
+#define TRADING_BENCH_UTIL_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace bench {
+
+/**
+ * @brief Monotonic stopwatch reporting elapsed nanoseconds
+ */
+class Stopwatch {
+public:
+    Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+    
+    void reset() { start_ = std::chrono::steady_clock::now(); }
+    
+    uint64_t elapsedNs() const {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_).count());
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @brief Print a throughput line: operations, ns/op and ops/sec
+ */
+inline void report(const char* name, uint64_t ops, uint64_t elapsed_ns) {
+    double ns_per_op = ops ? static_cast<double>(elapsed_ns) / ops : 0.0;
+    double ops_per_sec = elapsed_ns ? ops * 1e9 / elapsed_ns : 0.0;
+    std::printf("%-32s %10llu ops %10.1f ns/op %14.0f ops/s\n",
+                name, static_cast<unsigned long long>(ops),
+                ns_per_op, ops_per_sec);
+}
+
+/**
+ * @brief Print latency percentiles of per-operation samples
+ * @param samples_ns Latencies in nanoseconds (sorted in place)
+ */
+inline void reportLatency(const char* name, std::vector<uint64_t>& samples_ns) {
+    if (samples_ns.empty()) {
+        return;
+    }
+    std::sort(samples_ns.begin(), samples_ns.end());
+    auto at = [&samples_ns](double q) {
+        return static_cast<unsigned long long>(
+            samples_ns[static_cast<size_t>(q * (samples_ns.size() - 1))]);
+    };
+    std::printf("    %-28s p50 %8llu ns  p99 %8llu ns  p99.9 %8llu ns  max %9llu ns\n",
+                name, at(0.5), at(0.99), at(0.999), at(1.0));
+}
+
+/**
+ * @brief Small deterministic xorshift generator so runs are repeatable
+ */
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 0x9E3779B97F4A7C15ULL) : state_(seed) {}
+    
+    uint64_t next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return state_;
+    }
+    
+    // Uniform value in [0, n)
+    uint64_t below(uint64_t n) { return next() % n; }
+
+private:
+    uint64_t state_;
+};
+
+// Keep the optimizer from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace bench
+
+#endif // TRADING_BENCH_UTIL_HPP
@@ -0,0 +1,272 @@
+#ifndef TRADING_ASYNC_PUBLISHER_HPP
+#define TRADING_ASYNC_PUBLISHER_HPP
+
+#include "command_queue.hpp"
+#include "engine_event.hpp"
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace trading {
+
+/**
+ * @brief What the engine does when the publisher's ring is full
+ */
+enum class SlowConsumerPolicy : uint8_t {
+    Block = 0,         // Wait for room: nothing lost, matching stalls
+    DropAndFlag = 1,   // Drop the event; the consumer gets a gap callback
+    Conflate = 2       // Merge fills of one order at one price into one
+                       // ConflatedFill while full; otherwise wait
+};
+
+inline const char* to_string(SlowConsumerPolicy policy) {
+    switch (policy) {
+        case SlowConsumerPolicy::Block: return "BLOCK";
+        case SlowConsumerPolicy::DropAndFlag: return "DROP_AND_FLAG";
+        case SlowConsumerPolicy::Conflate: return "CONFLATE";
+        default: return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief Callback type for dropped events: how many were lost at this point
+ */
+using GapCallback = std::function<void(uint64_t dropped)>;
+
+/**
+ * @brief Callback type for conflated fills: the merged fill, whose
+ *        counter_order_id is 0 since it spans resting orders, and how many
+ *        fills it merges
+ */
+using ConflatedFillCallback = std::function<void(const Fill& fill, uint64_t fills)>;
+
+/**
+ * @brief Async publisher tuning
+ */
+struct PublisherOptions {
+    size_t capacity = 65536;       // Events the ring holds
+    size_t batch_size = 256;       // Events delivered per pass
+    SlowConsumerPolicy policy = SlowConsumerPolicy::Block;
+    WaitStrategy wait = WaitStrategy::SpinYield;   // How an idle publisher thread waits
+};
+
+/**
+ * @brief Publisher ring counters (readable from any thread)
+ */
+struct PublisherStats {
+    uint64_t published = 0;       // Events put in the ring (gap markers included)
+    uint64_t delivered = 0;       // Events handed to the callbacks
+    uint64_t dropped = 0;         // DropAndFlag: events lost
+    uint64_t conflated = 0;       // Conflate: fills merged into a held one
+    uint64_t full_waits = 0;      // Times the engine waited on a full ring
+    size_t capacity = 0;
+    size_t occupancy = 0;         // Events queued now (approximate)
+    size_t peak_occupancy = 0;    // Most events seen queued by the publisher thread
+    double mean_occupancy = 0.0;  // Average queued per delivery pass
+};
+
+/**
+ * @brief Delivers fills and order updates to callbacks on its own thread
+ *
+ * The matching thread copies each event into a preallocated SPSC ring of
+ * EngineEvent records (see AsyncListener) and goes on matching; the
+ * publisher thread rebuilds the Fill / Order and runs the callbacks, so a
+ * slow callback (logging, a network send) costs the engine nothing until
+ * the ring fills. Events come out in the order the engine produced them.
+ *
+ * When the ring is full the policy decides:
+ *  - Block waits for room.
+ *  - DropAndFlag drops the event. The next event to get in is preceded
+ *    by a gap marker, and the gap callback is told how many were lost.
+ *  - Conflate holds back a fill that does not fit and merges the fills
+ *    that follow into it while they are for the same order at the same
+ *    price. A merged fill is a ConflatedFill: quantities summed, and no
+ *    resting order, since the fills may have come from several; it goes
+ *    to the conflated-fill callback, or without one to the fill callback
+ *    with counter_order_id 0. Anything else waits for room, so no
+ *    quantity is lost and an order's update still follows its fills.
+ *
+ * Callbacks are set before start(). The engine (one thread) calls the
+ * publish functions; stop() is called from that thread or once it is
+ * done, and delivers everything published before returning.
+ */
+class AsyncPublisher {
+public:
+    explicit AsyncPublisher(PublisherOptions options = PublisherOptions());
+    ~AsyncPublisher();    // Stops the publisher thread
+    
+    AsyncPublisher(const AsyncPublisher&) = delete;
+    AsyncPublisher& operator=(const AsyncPublisher&) = delete;
+    
+    void setFillCallback(FillCallback callback) { fill_callback_ = std::move(callback); }
+    void setOrderCallback(OrderCallback callback) { order_callback_ = std::move(callback); }
+    void setGapCallback(GapCallback callback) { gap_callback_ = std::move(callback); }
+    void setConflatedFillCallback(ConflatedFillCallback callback) {
+        conflated_fill_callback_ = std::move(callback);
+    }
+    
+    /**
+     * @brief Start the publisher thread
+     * @return false if already started (a publisher starts once)
+     */
+    bool start();
+    
+    /**
+     * @brief Deliver everything published so far, then join the thread
+     */
+    void stop();
+    
+    bool running() const { return started_ && !stopping_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @name Engine thread only
+     * @{
+     */
+    void publishFill(const Fill& fill) { publish(EngineEvent::fill(fill)); }
+    void publishOrder(const Order& order) { publish(EngineEvent::order(order)); }
+    
+    void publish(const EngineEvent& event) {
+        switch (options_.policy) {
+            case SlowConsumerPolicy::Block:
+                pushWaiting(event);
+                break;
+            case SlowConsumerPolicy::DropAndFlag:
+                pushOrDrop(event);
+                break;
+            case SlowConsumerPolicy::Conflate:
+                pushConflating(event);
+                break;
+        }
+    }
+    
+    /**
+     * @brief Put a held-back fill or gap marker in the ring, waiting for
+     *        room (stop() does this too)
+     */
+    void flush();
+    /** @} */
+    
+    /**
+     * @brief True once an event has been dropped
+     */
+    bool overflowed() const { return dropped_.load(std::memory_order_relaxed) > 0; }
+    
+    PublisherStats stats() const;
+    SlowConsumerPolicy policy() const { return options_.policy; }
+    size_t capacity() const { return ring_.capacity(); }
+
+private:
+    PublisherOptions options_;
+    SpscRing<EngineEvent> ring_;
+    QueueWaiter waiter_;
+    FillCallback fill_callback_;
+    OrderCallback order_callback_;
+    GapCallback gap_callback_;
+    ConflatedFillCallback conflated_fill_callback_;
+    std::thread thread_;
+    bool started_ = false;
+    std::atomic<bool> stopping_{false};
+    
+    // Engine thread: counters, the fill held back while conflating, and
+    // drops not yet reported with a gap marker
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> conflated_{0};
+    std::atomic<uint64_t> full_waits_{0};
+    EngineEvent held_;
+    bool holding_ = false;
+    uint64_t unreported_drops_ = 0;
+    
+    // Publisher thread: delivery and occupancy counters
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> passes_{0};
+    std::atomic<uint64_t> occupancy_sum_{0};
+    std::atomic<size_t> peak_occupancy_{0};
+    
+    // Single-writer counter bump, no locked instruction
+    static void bump(std::atomic<uint64_t>& counter, uint64_t by = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+    
+    bool tryPush(const EngineEvent& event) {
+        if (!ring_.tryPush(event)) {
+            return false;
+        }
+        bump(published_);
+        waiter_.notify();
+        return true;
+    }
+    
+    void pushWaiting(const EngineEvent& event) {
+        if (!tryPush(event)) {
+            bump(full_waits_);
+            waitToPush(event);
+        }
+    }
+    
+    void pushOrDrop(const EngineEvent& event) {
+        // The gap marker goes first; without room for both, this one is lost too
+        if (unreported_drops_ > 0 && tryPush(EngineEvent::gap(unreported_drops_))) {
+            unreported_drops_ = 0;
+        }
+        if (unreported_drops_ > 0 || !tryPush(event)) {
+            ++unreported_drops_;
+            bump(dropped_);
+        }
+    }
+    
+    void pushConflating(const EngineEvent& event) {
+        if (holding_) {
+            if (event.type == EngineEventType::Fill && event.order_id == held_.order_id &&
+                event.price == held_.price) {
+                // Not credited to one resting order: the fills may come from several
+                if (held_.type == EngineEventType::Fill) {
+                    held_.type = EngineEventType::ConflatedFill;
+                    held_.counter_order_id = 0;
+                    held_.filled_qty = 1;
+                }
+                held_.quantity += event.quantity;
+                held_.filled_qty += 1;
+                held_.timestamp_ns = event.timestamp_ns;
+                bump(conflated_);
+                holding_ = !tryPush(held_);
+                return;
+            }
+            pushWaiting(held_);
+            holding_ = false;
+        }
+        if (event.type != EngineEventType::Fill) {
+            pushWaiting(event);
+        } else if (!tryPush(event)) {
+            held_ = event;
+            holding_ = true;
+        }
+    }
+    
+    // Spin, then yield, until the event fits
+    void waitToPush(const EngineEvent& event);
+    
+    // Publisher thread body
+    void run();
+    void deliver(const EngineEvent& event);
+};
+
+/**
+ * @brief Engine listener that hands every fill and order update to an
+ *        AsyncPublisher
+ */
+class AsyncListener : public NullListener {
+public:
+    AsyncListener() = default;
+    explicit AsyncListener(AsyncPublisher* publisher) : publisher_(publisher) {}
+    
+    void onFill(const Fill& fill) { publisher_->publishFill(fill); }
+    void onOrder(const Order& order) { publisher_->publishOrder(order); }
+
+private:
+    AsyncPublisher* publisher_ = nullptr;
+};
+
+} // namespace trading
+
+#endif // TRADING_ASYNC_PUBLISHER_HPP
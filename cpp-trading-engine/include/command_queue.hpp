@@ -0,0 +1,285 @@
+#ifndef TRADING_COMMAND_QUEUE_HPP
+#define TRADING_COMMAND_QUEUE_HPP
+
+#include "engine_command.hpp"
+#include "spsc_ring.hpp"
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief How an engine thread waits for commands when its queue is empty
+ */
+enum class WaitStrategy : uint8_t {
+    BusySpin = 0,     // Poll continuously: lowest latency, burns a core
+    SpinYield = 1,    // Poll for a while, then yield the core between polls
+    Block = 2         // Poll for a while, then sleep on a futex until woken
+};
+
+inline const char* to_string(WaitStrategy wait) {
+    switch (wait) {
+        case WaitStrategy::BusySpin: return "BUSY_SPIN";
+        case WaitStrategy::SpinYield: return "SPIN_YIELD";
+        case WaitStrategy::Block: return "BLOCK";
+        default: return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief Tell the core this thread is spinning (pause / yield hint)
+ */
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Where a queue's single consumer waits for work
+ *
+ * wait() polls a readiness check per the strategy. With
+ * WaitStrategy::Block an idle consumer publishes that it is asleep and
+ * sleeps on a futex (Linux); producers call notify() after publishing
+ * and pay for a wake-up syscall only when they see that flag. Other
+ * platforms fall back to yielding.
+ */
+class QueueWaiter {
+public:
+    // Empty polls before a waiting thread yields or sleeps
+    static constexpr size_t SPIN_LIMIT = 1024;
+    
+    explicit QueueWaiter(WaitStrategy strategy) : strategy_(strategy) {}
+    
+    /**
+     * @brief Wait until ready() or stop is set (consumer thread only)
+     * @return ready(), checked once more after stop was seen
+     */
+    template <typename Ready>
+    bool wait(Ready&& ready, const std::atomic<bool>& stop) {
+        for (size_t spins = 0;; ++spins) {
+            if (ready()) {
+                return true;
+            }
+            if (stop.load(std::memory_order_acquire)) {
+                // Producers are done once stop is set: one last look
+                return ready();
+            }
+            
+            if (strategy_ == WaitStrategy::BusySpin || spins < SPIN_LIMIT) {
+                cpuRelax();
+                continue;
+            }
+            if (strategy_ == WaitStrategy::SpinYield) {
+                std::this_thread::yield();
+                continue;
+            }
+            
+            // Block: announce the sleep, then check again before sleeping
+            sleeping_.store(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ready() || stop.load(std::memory_order_seq_cst)) {
+                sleeping_.store(0, std::memory_order_relaxed);
+                continue;
+            }
+            sleep();
+        }
+    }
+    
+    /**
+     * @brief Wake the consumer if it is asleep (producers, after publishing)
+     */
+    void notify() {
+        if (strategy_ != WaitStrategy::Block) {
+            return;
+        }
+        // Pairs with the fence in wait(): either the consumer sees the
+        // published work or this thread sees the flag
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed) != 0) {
+            wake();
+        }
+    }
+    
+    /**
+     * @brief Wake the consumer unconditionally (any thread); call it after
+     *        setting the stop flag
+     */
+    void wake();
+    
+    WaitStrategy strategy() const { return strategy_; }
+    
+    /**
+     * @brief Times the consumer went to sleep on the futex / was woken
+     */
+    uint64_t sleeps() const { return sleeps_.load(std::memory_order_relaxed); }
+    uint64_t wakeups() const { return wakeups_.load(std::memory_order_relaxed); }
+
+private:
+    const WaitStrategy strategy_;
+    
+    // 1 while the consumer is (about to be) asleep on the futex
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> sleeping_{0};
+    std::atomic<uint64_t> sleeps_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    
+    // Sleep on the futex while the flag is still set
+    void sleep();
+};
+
+/**
+ * @brief Bounded SPSC queue of engine commands with a consumer wait strategy
+ *
+ * A gateway thread pushes fixed-size EngineCommand records; the engine
+ * thread drains them in batches (see EngineLoop). The ring's indices sit
+ * on separate cache lines and nothing allocates after construction.
+ * A producer that finds the queue full spins, then yields.
+ */
+class CommandQueue {
+public:
+    explicit CommandQueue(size_t capacity, WaitStrategy wait = WaitStrategy::SpinYield)
+        : ring_(capacity), waiter_(wait) {}
+    
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+    
+    /**
+     * @brief Queue one command (producer thread only)
+     * @return false if the queue is full
+     */
+    bool tryPush(const EngineCommand& command) {
+        if (!ring_.tryPush(command)) {
+            return false;
+        }
+        waiter_.notify();
+        return true;
+    }
+    
+    /**
+     * @brief Queue one command, waiting while the queue is full
+     *        (producer thread only)
+     */
+    void push(const EngineCommand& command);
+    
+    /**
+     * @brief Hand up to max_commands queued commands to fn
+     *        (consumer thread only)
+     * @return Number of commands consumed
+     */
+    template <typename Fn>
+    size_t consume(Fn&& fn, size_t max_commands = static_cast<size_t>(-1)) {
+        return ring_.consume(std::forward<Fn>(fn), max_commands);
+    }
+    
+    /**
+     * @brief Wait, per the strategy, until a command is queued or stop is
+     *        set (consumer thread only)
+     * @return false if stop was set and the queue is empty
+     */
+    bool waitForCommands(const std::atomic<bool>& stop) {
+        return waiter_.wait([this]() { return !ring_.empty(); }, stop);
+    }
+    
+    /**
+     * @brief Wake a consumer sleeping in waitForCommands() (any thread);
+     *        call it after setting the stop flag
+     */
+    void wake() { waiter_.wake(); }
+    
+    size_t size() const { return ring_.size(); }
+    bool empty() const { return ring_.empty(); }
+    size_t capacity() const { return ring_.capacity(); }
+    WaitStrategy waitStrategy() const { return waiter_.strategy(); }
+    uint64_t sleeps() const { return waiter_.sleeps(); }
+    uint64_t wakeups() const { return waiter_.wakeups(); }
+
+private:
+    SpscRing<EngineCommand> ring_;
+    QueueWaiter waiter_;
+};
+
+/**
+ * @brief Engine thread run loop: applies queued commands in batches
+ *
+ * run() applies up to batch_size commands per pass and publishes its
+ * progress once per batch. It waits on the queue's strategy when idle and
+ * returns once stop() has been requested and the queue is drained. Each
+ * time the queue drains, the engine's journal (if any) is flushed, so a
+ * partial commit group does not wait for the next burst.
+ *
+ * Queue is CommandQueue or any queue with the same consume(),
+ * waitForCommands() and wake() (see CommandSequencer).
+ */
+template <typename Listener, typename Queue = CommandQueue>
+class EngineLoop {
+public:
+    EngineLoop(BasicMatchingEngine<Listener>& engine, Queue& queue,
+               size_t batch_size = 256)
+        : engine_(engine), queue_(queue), batch_size_(batch_size) {}
+    
+    EngineLoop(const EngineLoop&) = delete;
+    EngineLoop& operator=(const EngineLoop&) = delete;
+    
+    /**
+     * @brief Apply one batch of queued commands without waiting
+     * @return Number of commands applied
+     */
+    size_t runOnce() {
+        size_t applied = queue_.consume([this](const EngineCommand& command) {
+            applyCommand(engine_, command, fills_);
+        }, batch_size_);
+        if (applied > 0) {
+            processed_.fetch_add(applied, std::memory_order_release);
+            batches_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return applied;
+    }
+    
+    /**
+     * @brief Apply commands until stopped and drained (engine thread)
+     */
+    void run() {
+        for (;;) {
+            if (runOnce() > 0) {
+                continue;
+            }
+            if (engine_.journal()) {
+                engine_.journal()->flushIdle();
+            }
+            if (!queue_.waitForCommands(stop_)) {
+                return;
+            }
+        }
+    }
+    
+    /**
+     * @brief Ask run() to return once the queue is drained (any thread)
+     */
+    void stop() {
+        stop_.store(true, std::memory_order_seq_cst);
+        queue_.wake();
+    }
+    
+    /**
+     * @brief Commands applied so far (readable from any thread)
+     */
+    uint64_t processed() const { return processed_.load(std::memory_order_acquire); }
+    uint64_t batches() const { return batches_.load(std::memory_order_relaxed); }
+
+private:
+    BasicMatchingEngine<Listener>& engine_;
+    Queue& queue_;
+    const size_t batch_size_;
+    std::vector<Fill> fills_;    // Reused for every submit
+    std::atomic<bool> stop_{false};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> batches_{0};
+};
+
+} // namespace trading
+
+#endif // TRADING_COMMAND_QUEUE_HPP
@@ -0,0 +1,151 @@
+#ifndef TRADING_COMMAND_SEQUENCER_HPP
+#define TRADING_COMMAND_SEQUENCER_HPP
+
+#include "command_queue.hpp"
+#include <memory>
+
+namespace trading {
+
+/**
+ * @brief Multi-producer / single-consumer command ring that sequences its
+ *        input
+ *
+ * Any number of gateway threads publish commands; one engine thread
+ * drains them (see EngineLoop). A producer claims the next global
+ * sequence number with a single fetch_add, waits for that slot to be free,
+ * copies the command in and marks the slot published with its sequence.
+ * The consumer takes slots strictly in sequence order, stopping at the
+ * first one not yet published, so commands are applied - and journaled -
+ * in exactly the order their sequence numbers were handed out. No mutex
+ * is taken; producers only contend on the claim counter.
+ *
+ * Sequence numbers start at 1 and have no gaps: the n-th command the
+ * consumer takes is the one publish() returned n for.
+ */
+class CommandSequencer {
+public:
+    explicit CommandSequencer(size_t capacity, WaitStrategy wait = WaitStrategy::SpinYield)
+        : mask_(roundUp(capacity) - 1)
+        , slots_(new Slot[mask_ + 1])
+        , waiter_(wait) {}
+    
+    CommandSequencer(const CommandSequencer&) = delete;
+    CommandSequencer& operator=(const CommandSequencer&) = delete;
+    
+    /**
+     * @brief Sequence and queue one command (any thread), waiting while
+     *        the ring is full
+     * @return The command's global sequence number
+     */
+    uint64_t publish(const EngineCommand& command) {
+        uint64_t claim = claim_.fetch_add(1, std::memory_order_relaxed);
+        // The slot is free once the consumer has taken the command a lap ago
+        for (size_t spins = 0; claim - head_.load(std::memory_order_acquire) > mask_; ++spins) {
+            if (spins < QueueWaiter::SPIN_LIMIT) {
+                cpuRelax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        Slot& slot = slots_[claim & mask_];
+        slot.command = command;
+        slot.published.store(claim + 1, std::memory_order_release);
+        waiter_.notify();
+        return claim + 1;
+    }
+    
+    uint64_t submitOrder(const Order& order) { return publish(EngineCommand::submit(order)); }
+    uint64_t cancelOrder(SymbolId symbol, OrderId order_id) {
+        return publish(EngineCommand::cancel(symbol, order_id));
+    }
+    uint64_t modifyOrder(SymbolId symbol, OrderId order_id, Price new_price, Quantity new_quantity) {
+        return publish(EngineCommand::modify(symbol, order_id, new_price, new_quantity));
+    }
+    
+    /**
+     * @brief Hand up to max_commands published commands to fn in sequence
+     *        order (consumer thread only)
+     * @param fn Called as fn(const EngineCommand&); the sequence of each is
+     *        consumed() + 1 at the time of the call
+     * @return Number of commands consumed
+     */
+    template <typename Fn>
+    size_t consume(Fn&& fn, size_t max_commands = static_cast<size_t>(-1)) {
+        size_t count = 0;
+        while (count < max_commands && ready()) {
+            fn(static_cast<const EngineCommand&>(slots_[next_ & mask_].command));
+            ++next_;
+            ++count;
+        }
+        if (count > 0) {
+            head_.store(next_, std::memory_order_release);
+        }
+        return count;
+    }
+    
+    /**
+     * @brief Wait, per the strategy, until the next command is published or
+     *        stop is set (consumer thread only)
+     * @return false if stop was set and nothing is left to consume
+     */
+    bool waitForCommands(const std::atomic<bool>& stop) {
+        return waiter_.wait([this]() { return ready(); }, stop);
+    }
+    
+    /**
+     * @brief Wake a consumer sleeping in waitForCommands() (any thread)
+     */
+    void wake() { waiter_.wake(); }
+    
+    /**
+     * @brief Sequence numbers handed out so far (approximate while producers
+     *        are publishing)
+     */
+    uint64_t claimed() const { return claim_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Commands the consumer has taken (readable from any thread)
+     */
+    uint64_t consumed() const { return head_.load(std::memory_order_acquire); }
+    
+    size_t capacity() const { return mask_ + 1; }
+    WaitStrategy waitStrategy() const { return waiter_.strategy(); }
+    uint64_t sleeps() const { return waiter_.sleeps(); }
+    uint64_t wakeups() const { return waiter_.wakeups(); }
+
+private:
+    // One per cache line, so producers filling neighbouring slots do not
+    // share a line
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint64_t> published{0};    // Sequence of the command held, 0 = none yet
+        EngineCommand command;
+    };
+    
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        return size;
+    }
+    
+    bool ready() const {
+        return slots_[next_ & mask_].published.load(std::memory_order_acquire) == next_ + 1;
+    }
+    
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    
+    // Producers: next sequence to hand out (minus one)
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> claim_{0};
+    
+    // Consumer: commands taken, published for producers waiting on a full ring
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head_{0};
+    uint64_t next_ = 0;    // Consumer's own copy of head_
+    
+    QueueWaiter waiter_;
+};
+
+} // namespace trading
+
+#endif // TRADING_COMMAND_SEQUENCER_HPP
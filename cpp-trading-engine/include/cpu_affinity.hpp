@@ -0,0 +1,35 @@
+#ifndef TRADING_CPU_AFFINITY_HPP
+#define TRADING_CPU_AFFINITY_HPP
+
+#include <cstddef>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace trading {
+
+/**
+ * @brief Pin a thread to one CPU, wrapping around the available ones
+ * @return false if pinning is unsupported or failed; the thread then
+ *         keeps running unpinned
+ */
+inline bool pinThread(std::thread& thread, size_t cpu) {
+#if defined(__linux__)
+    size_t cpus = std::thread::hardware_concurrency();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus > 0 ? cpu % cpus : 0, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
+} // namespace trading
+
+#endif // TRADING_CPU_AFFINITY_HPP
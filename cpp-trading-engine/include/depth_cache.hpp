@@ -0,0 +1,54 @@
+#ifndef TRADING_DEPTH_CACHE_HPP
+#define TRADING_DEPTH_CACHE_HPP
+
+#include "price_ladder.hpp"
+
+namespace trading {
+
+/**
+ * @brief Top-N aggregated depth for one side, maintained incrementally
+ *
+ * The book reports every level it touches via update(); the cache patches
+ * the matching entry, inserts or drops it, and pulls the next level in
+ * from the ladder when one falls out of a full cache. Readers get the
+ * top LEVELS without walking the ladder.
+ */
+class DepthCache {
+public:
+    static constexpr size_t LEVELS = 10;
+    
+    explicit DepthCache(Side side) : side_(side) {}
+    
+    /**
+     * @brief Reflect the current state of one price level
+     * @param ladder The side's ladder, already updated
+     * @param price Price of the level that changed
+     * @param level The level, or nullptr if it was removed
+     */
+    void update(const PriceLadder& ladder, Price price, const PriceLevel* level);
+    
+    /**
+     * @brief Recompute the cache from the ladder
+     */
+    void rebuild(const PriceLadder& ladder);
+    
+    const DepthLevels<LEVELS>& levels() const { return depth_; }
+    bool full() const { return depth_.count == LEVELS; }
+
+private:
+    Side side_;
+    DepthLevels<LEVELS> depth_;
+    
+    bool better(Price a, Price b) const {
+        return side_ == Side::Buy ? a > b : a < b;
+    }
+    
+    static DepthLevel entry(const PriceLevel& level) {
+        return DepthLevel{level.price, level.total_quantity,
+                          static_cast<uint32_t>(level.order_count())};
+    }
+};
+
+} // namespace trading
+
+#endif // TRADING_DEPTH_CACHE_HPP
@@ -0,0 +1,93 @@
+#ifndef TRADING_ENGINE_COMMAND_HPP
+#define TRADING_ENGINE_COMMAND_HPP
+
+#include "matching_engine.hpp"
+#include "order_journal.hpp"
+
+namespace trading {
+
+/**
+ * @brief One submit / cancel / modify, 32 bytes, copied by value into
+ *        command rings
+ *
+ * Carries the same fields as a journal record without the sequence and
+ * checksum. The engine thread applies it with applyCommand(); Submit
+ * orders are timestamped there, not by the producer.
+ */
+struct EngineCommand {
+    OrderId order_id = 0;
+    Price price = 0;           // Limit price, or the new price of a Modify (0 keeps it)
+    Quantity quantity = 0;     // Order quantity, or the new quantity of a Modify (0 keeps it)
+    SymbolId symbol = INVALID_SYMBOL_ID;
+    CommandType type = CommandType::Submit;
+    Side side = Side::Buy;
+    OrderType order_type = OrderType::Limit;
+    uint8_t reserved = 0;
+    
+    static EngineCommand submit(const Order& order) {
+        EngineCommand command;
+        command.order_id = order.id;
+        command.price = order.price;
+        command.quantity = order.quantity;
+        command.symbol = order.symbol;
+        command.side = order.side;
+        command.order_type = order.type;
+        return command;
+    }
+    
+    static EngineCommand cancel(SymbolId symbol, OrderId order_id) {
+        EngineCommand command;
+        command.order_id = order_id;
+        command.symbol = symbol;
+        command.type = CommandType::Cancel;
+        return command;
+    }
+    
+    static EngineCommand modify(SymbolId symbol, OrderId order_id,
+                                Price new_price, Quantity new_quantity) {
+        EngineCommand command;
+        command.order_id = order_id;
+        command.price = new_price;
+        command.quantity = new_quantity;
+        command.symbol = symbol;
+        command.type = CommandType::Modify;
+        return command;
+    }
+    
+    /**
+     * @brief Rebuild the submitted order (Submit commands only)
+     */
+    Order toOrder() const {
+        return Order(order_id, symbol, side, order_type, price, quantity);
+    }
+};
+
+static_assert(sizeof(EngineCommand) == 32, "EngineCommand is a fixed 32-byte record");
+
+/**
+ * @brief Apply one command to an engine
+ * @param fills Cleared, then receives the fills of a Submit
+ * @return false if a Cancel / Modify found no such order, or the type is
+ *         not a command
+ */
+template <typename Listener>
+bool applyCommand(BasicMatchingEngine<Listener>& engine, const EngineCommand& command,
+                  std::vector<Fill>& fills) {
+    switch (command.type) {
+        case CommandType::Submit:
+            fills.clear();
+            engine.submitOrder(command.toOrder(), fills);
+            return true;
+        case CommandType::Cancel:
+            return engine.cancelOrder(command.symbol, command.order_id);
+        case CommandType::Modify:
+            return engine.modifyOrder(command.symbol, command.order_id,
+                                      command.price, command.quantity);
+        default:
+            return false;
+    }
+}
+
+} // namespace trading
+
+#endif // TRADING_ENGINE_COMMAND_HPP
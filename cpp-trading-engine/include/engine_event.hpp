@@ -0,0 +1,101 @@
+#ifndef TRADING_ENGINE_EVENT_HPP
+#define TRADING_ENGINE_EVENT_HPP
+
+#include "order.hpp"
+#include <chrono>
+
+namespace trading {
+
+/**
+ * @brief What an engine event carries
+ */
+enum class EngineEventType : uint8_t {
+    Fill = 0,          // An execution (see Fill)
+    Order = 1,         // Final state of a submitted order (see Order)
+    Gap = 2,           // Events were dropped here; quantity = how many
+    ConflatedFill = 3  // Fills of one order at one price, merged (see AsyncPublisher)
+};
+
+/**
+ * @brief One fill or order update, 56 bytes, copied by value into an
+ *        output ring (sharded engine shards, AsyncPublisher)
+ */
+struct EngineEvent {
+    OrderId order_id = 0;
+    OrderId counter_order_id = 0;   // Fill: the resting order; ConflatedFill: 0 (several)
+    Price price = 0;
+    Quantity quantity = 0;          // Fill: executed; Order: original quantity
+    Quantity filled_qty = 0;        // Order: quantity filled so far; ConflatedFill: fills merged
+    int64_t timestamp_ns = 0;       // Fill: execution time; Order: submission time
+    SymbolId symbol = INVALID_SYMBOL_ID;
+    EngineEventType type = EngineEventType::Fill;
+    Side side = Side::Buy;          // Fill: the aggressor's side
+    OrderStatus status = OrderStatus::New;
+    OrderType order_type = OrderType::Limit;
+    
+    static EngineEvent fill(const Fill& fill) {
+        EngineEvent event;
+        event.order_id = fill.order_id;
+        event.counter_order_id = fill.counter_order_id;
+        event.price = fill.price;
+        event.quantity = fill.quantity;
+        event.timestamp_ns = toNanos(fill.timestamp);
+        event.symbol = fill.symbol;
+        event.side = fill.side;
+        return event;
+    }
+    
+    static EngineEvent order(const Order& order) {
+        EngineEvent event;
+        event.order_id = order.id;
+        event.price = order.price;
+        event.quantity = order.quantity;
+        event.filled_qty = order.filled_qty;
+        event.timestamp_ns = toNanos(order.timestamp);
+        event.symbol = order.symbol;
+        event.type = EngineEventType::Order;
+        event.side = order.side;
+        event.status = order.status;
+        event.order_type = order.type;
+        return event;
+    }
+    
+    static EngineEvent gap(uint64_t dropped) {
+        EngineEvent event;
+        event.quantity = static_cast<Quantity>(dropped);
+        event.type = EngineEventType::Gap;
+        return event;
+    }
+    
+    /**
+     * @brief Rebuild the fill (Fill and ConflatedFill events only)
+     */
+    Fill toFill() const {
+        return Fill(order_id, counter_order_id, symbol, side, price, quantity, fromNanos());
+    }
+    
+    /**
+     * @brief Rebuild the order with its final state (Order events only)
+     */
+    Order toOrder() const {
+        Order order(order_id, symbol, side, order_type, price, quantity, fromNanos());
+        order.filled_qty = filled_qty;
+        order.status = status;
+        return order;
+    }
+
+private:
+    static int64_t toNanos(Timestamp timestamp) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            timestamp.time_since_epoch()).count();
+    }
+    
+    Timestamp fromNanos() const {
+        return Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+            std::chrono::nanoseconds(timestamp_ns)));
+    }
+};
+
+} // namespace trading
+
+#endif // TRADING_ENGINE_EVENT_HPP
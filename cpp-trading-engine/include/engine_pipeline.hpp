@@ -0,0 +1,496 @@
+#ifndef TRADING_ENGINE_PIPELINE_HPP
+#define TRADING_ENGINE_PIPELINE_HPP
+
+#include "command_queue.hpp"
+#include "cpu_affinity.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief Pipeline tuning
+ */
+struct PipelineOptions {
+    size_t capacity = 4096;        // Commands in flight across all stages
+    size_t batch_size = 256;       // Slots a stage takes per pass
+    bool pin_threads = false;      // Pin stage i to CPU first_cpu + i (Linux)
+    size_t first_cpu = 0;
+};
+
+/**
+ * @brief Listener of the pipeline's matching stage: keeps the final state
+ *        of the order being matched
+ */
+struct PipelineMatchListener : NullListener {
+    Order* target = nullptr;
+    
+    void onOrder(const Order& order) {
+        if (target) {
+            *target = order;
+        }
+    }
+};
+
+/**
+ * @brief Matching engine split into dependent stages over one ring of
+ *        command slots (Disruptor style)
+ *
+ * One thread publishes commands into the ring. Three stage threads then
+ * walk it in order, each behind the one before:
+ *
+ *   1. sequence: journals the command and runs RiskManager::checkOrder()
+ *   2. match:    applies the command to the books, recording fills in
+ *                the slot
+ *   3. publish:  hands fills and final order states to the listener and
+ *                applies RiskManager::updatePosition()
+ *
+ * Every stage publishes a cursor - the number of slots it has finished -
+ * and only reads slots below the cursor of the stage before it, so slots
+ * move between threads without locks. The publisher reuses a slot once
+ * the last stage has finished it. The matching thread only touches books;
+ * journaling and risk run on either side of it.
+ *
+ * The journal records the decisions the pipeline made, so it replays with
+ * replayJournal() to the pipeline's state. While no position or notional
+ * limit binds, those are the records a serial engine with the same journal
+ * and risk manager would write, in the same order. Like the engine it refuses commands while the journal
+ * has failed, and a stage 1 batch whose commit fails is not applied
+ * either: its commands are voided with Reject records before the stage's
+ * cursor moves past them. The risk manager is shared by the first and last
+ * stages and is switched to locking mode; checkOrder() sees positions as
+ * of the fills published so far, which may lag the fills of orders still
+ * in the ring. Once a position or notional limit binds, an order a serial
+ * engine would reject can be accepted (and the other way round), and the
+ * books and positions diverge from the serial engine's. Level updates and
+ * batch hooks are not forwarded.
+ */
+template <typename Listener = NullListener>
+class EnginePipeline {
+public:
+    explicit EnginePipeline(PipelineOptions options = PipelineOptions(),
+                            Listener listener = Listener())
+        : options_(options)
+        , mask_(roundUp(options.capacity) - 1)
+        , slots_(new Slot[mask_ + 1])
+        , listener_(std::move(listener)) {
+        if (options_.batch_size == 0) {
+            options_.batch_size = 1;
+        }
+    }
+    
+    ~EnginePipeline() { stop(); }    // Drains the ring and joins the stages
+    
+    EnginePipeline(const EnginePipeline&) = delete;
+    EnginePipeline& operator=(const EnginePipeline&) = delete;
+    
+    /**
+     * @name Configuration, before start()
+     * Each returns false once started.
+     * @{
+     */
+    bool setRiskManager(std::shared_ptr<RiskManager> risk_manager) {
+        if (started_) {
+            return false;
+        }
+        risk_manager_ = std::move(risk_manager);
+        if (risk_manager_) {
+            risk_manager_->setLocking(true);
+            engine_.forEachBook([this](const OrderBook& book) {
+                risk_manager_->setTickSize(book.symbol(), book.instrument().tick_size);
+            });
+        }
+        return true;
+    }
+    
+    bool setJournal(std::shared_ptr<OrderJournal> journal) {
+        if (started_) {
+            return false;
+        }
+        journal_ = std::move(journal);
+        return true;
+    }
+    
+    bool registerInstrument(const InstrumentSpec& spec, size_t expected_orders = 0) {
+        if (started_) {
+            return false;
+        }
+        BookHandle book = engine_.registerInstrument(spec, expected_orders);
+        markKnown(book.symbolId());
+        if (risk_manager_) {
+            risk_manager_->setTickSize(spec.symbol, spec.tick_size);
+        }
+        return true;
+    }
+    
+    bool registerSymbol(const Symbol& symbol, size_t expected_orders = 0) {
+        return registerInstrument(InstrumentSpec(symbol), expected_orders);
+    }
+    /** @} */
+    
+    /**
+     * @brief Journal the registered instruments and start the stage threads
+     * @return false if already started (a pipeline starts once)
+     */
+    bool start() {
+        if (started_) {
+            return false;
+        }
+        started_ = true;
+        stopping_.store(false, std::memory_order_release);
+        
+        // Replay needs the instrument behind every registered book
+        if (journal_) {
+            engine_.forEachBook([this](const OrderBook& book) {
+                journal_->appendInstrument(book.symbolId(), book.instrument());
+            });
+            journal_->commit();
+        }
+        
+        threads_[0] = std::thread([this]() {
+            runStage(published_, checked_, [this](uint64_t begin, uint64_t end) {
+                sequenceStage(begin, end);
+            });
+        });
+        threads_[1] = std::thread([this]() {
+            runStage(checked_, matched_, [this](uint64_t begin, uint64_t end) {
+                matchStage(begin, end);
+            });
+        });
+        threads_[2] = std::thread([this]() {
+            runStage(matched_, completed_, [this](uint64_t begin, uint64_t end) {
+                publishStage(begin, end);
+            });
+        });
+        if (options_.pin_threads) {
+            for (size_t i = 0; i < 3; ++i) {
+                // Best effort: the stage still runs, unpinned, if the CPU is unavailable
+                pinThread(threads_[i], options_.first_cpu + i);
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Finish every published command, then join the stage threads
+     *        (publishing thread)
+     */
+    void stop() {
+        if (!running()) {
+            return;
+        }
+        waitIdle();
+        stopping_.store(true, std::memory_order_release);
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+    }
+    
+    bool running() const { return started_ && !stopping_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @name Publishing thread only
+     * Each call puts one command in the next slot, waiting while the ring
+     * is full; false if the pipeline is not running.
+     * @{
+     */
+    bool submitOrder(const Order& order) { return publish(EngineCommand::submit(order)); }
+    bool cancelOrder(SymbolId symbol, OrderId order_id) {
+        return publish(EngineCommand::cancel(symbol, order_id));
+    }
+    bool modifyOrder(SymbolId symbol, OrderId order_id, Price new_price, Quantity new_quantity) {
+        return publish(EngineCommand::modify(symbol, order_id, new_price, new_quantity));
+    }
+    
+    bool publish(const EngineCommand& command) {
+        if (!running()) {
+            return false;
+        }
+        uint64_t sequence = next_;
+        // The slot is free once the last stage finished it a lap ago
+        waitFor(completed_, sequence - mask_);
+        Slot& slot = slots_[sequence & mask_];
+        slot.command = command;
+        next_ = sequence + 1;
+        published_.store(next_, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Wait until every stage has finished every command published
+     *        so far
+     */
+    void waitIdle() const { waitFor(completed_, next_); }
+    /** @} */
+    
+    /**
+     * @brief Cursors: commands published, journaled and risk checked,
+     *        matched, and fully published (readable from any thread)
+     */
+    uint64_t published() const { return published_.load(std::memory_order_acquire); }
+    uint64_t checked() const { return checked_.load(std::memory_order_acquire); }
+    uint64_t matched() const { return matched_.load(std::memory_order_acquire); }
+    uint64_t completed() const { return completed_.load(std::memory_order_acquire); }
+    
+    size_t capacity() const { return mask_ + 1; }
+    
+    /**
+     * @brief The books; only while stopped or idle (see waitIdle())
+     */
+    const BasicMatchingEngine<PipelineMatchListener>& engine() const { return engine_; }
+    
+    /**
+     * @brief Hash of the books and positions, as BasicMatchingEngine::
+     *        stateHash() (only while stopped or idle)
+     * 
+     * Equals the hash of the state the journal replays to. It equals a
+     * serial engine's given the same commands and risk manager only while
+     * no position or notional limit binds (see the class doc).
+     */
+    uint64_t stateHash() const {
+        uint64_t hash = 0;
+        engine_.forEachBook([this, &hash](const OrderBook& book) {
+            hash += symbolStateHash(book, risk_manager_.get());
+        });
+        return hash;
+    }
+    
+    /**
+     * @brief The listener; only while stopped or idle
+     */
+    Listener& listener() { return listener_; }
+    const Listener& listener() const { return listener_; }
+
+private:
+    // Written by the publisher, then filled in by the stages in turn
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        EngineCommand command;
+        Order order;                   // Submit: the order, final state after matching
+        std::vector<Fill> fills;       // Submit: its fills
+        bool rejected = false;         // Not to be applied: failed the risk check,
+                                       // unknown symbol id or failed journal
+        bool new_book = false;         // Submit: its Instrument record was journaled
+        uint64_t journaled = 0;        // Journal sequence of the command, 0 if none
+    };
+    
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        return size;
+    }
+    
+    // Spin, then yield, until cursor reaches target (wrap-safe for targets
+    // "below zero" while the ring is filling for the first time)
+    static void waitFor(const std::atomic<uint64_t>& cursor, uint64_t target) {
+        for (size_t spins = 0;
+             static_cast<int64_t>(target - cursor.load(std::memory_order_acquire)) > 0; ++spins) {
+            if (spins < QueueWaiter::SPIN_LIMIT) {
+                cpuRelax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+    
+    // Process slots in batches as the upstream cursor advances; returns once
+    // stopping with nothing left upstream
+    template <typename Process>
+    void runStage(const std::atomic<uint64_t>& upstream, std::atomic<uint64_t>& cursor,
+                  Process&& process) {
+        uint64_t next = cursor.load(std::memory_order_relaxed);
+        size_t spins = 0;
+        while (true) {
+            uint64_t available = upstream.load(std::memory_order_acquire);
+            if (available > next) {
+                uint64_t end = std::min<uint64_t>(available, next + options_.batch_size);
+                process(next, end);
+                next = end;
+                cursor.store(next, std::memory_order_release);
+                spins = 0;
+            } else if (stopping_.load(std::memory_order_acquire)) {
+                return;
+            } else if (++spins < QueueWaiter::SPIN_LIMIT) {
+                cpuRelax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+    
+    // Stage 1: journal and risk check, group-committing each batch
+    void sequenceStage(uint64_t begin, uint64_t end) {
+        for (uint64_t sequence = begin; sequence < end; ++sequence) {
+            Slot& slot = slots_[sequence & mask_];
+            const EngineCommand& command = slot.command;
+            // Like the engine: nothing is processed that the journal cannot cover
+            slot.rejected = journal_ && journal_->failed();
+            slot.new_book = false;
+            slot.journaled = 0;
+            if (command.type != CommandType::Submit) {
+                // Like the engine: commands for unknown symbols are not journaled
+                if (journal_ && !slot.rejected && isKnown(command.symbol)) {
+                    slot.journaled = journal_->append(command.type == CommandType::Cancel
+                        ? JournalRecord::cancel(command.symbol, command.order_id)
+                        : JournalRecord::modify(command.symbol, command.order_id,
+                                                command.price, command.quantity));
+                }
+                continue;
+            }
+            
+            slot.order = command.toOrder();
+            if (slot.rejected) {
+                continue;
+            }
+            if (!isKnown(command.symbol) && !isInternedSymbol(command.symbol)) {
+                // Like the engine: rejected and not journaled
+                slot.rejected = true;
+                continue;
+            }
+            slot.rejected = risk_manager_ && !risk_manager_->checkOrder(slot.order);
+            if (!slot.rejected && !isKnown(command.symbol)) {
+                // The matching stage creates the book on first sight; a
+                // rejected order creates none
+                markKnown(command.symbol);
+                if (journal_) {
+                    journal_->appendInstrument(command.symbol,
+                                               InstrumentSpec(symbolName(command.symbol)));
+                    slot.new_book = true;
+                }
+            }
+            if (journal_) {
+                slot.journaled = journal_->append(JournalRecord::submit(slot.order));
+                if (slot.rejected) {
+                    journal_->append(JournalRecord::reject(command.symbol, command.order_id,
+                                                           slot.journaled));
+                }
+            }
+        }
+        if (!journal_) {
+            return;
+        }
+        
+        // Caught up with the publisher: flush rather than leave the batch's
+        // records unsynced until the next one
+        bool written = published_.load(std::memory_order_acquire) == end
+            ? journal_->flushIdle() : journal_->commit();
+        if (!written) {
+            // Like the engine: a batch whose commit failed is not applied.
+            // Its records stay buffered, so each is voided by a Reject that
+            // replay honours should a later commit write them out.
+            for (uint64_t sequence = begin; sequence < end; ++sequence) {
+                Slot& slot = slots_[sequence & mask_];
+                if (slot.journaled && !slot.rejected) {
+                    journal_->append(JournalRecord::reject(slot.command.symbol,
+                                                           slot.command.order_id,
+                                                           slot.journaled));
+                    slot.rejected = true;
+                }
+            }
+        }
+    }
+    
+    // Stage 2: books only
+    void matchStage(uint64_t begin, uint64_t end) {
+        for (uint64_t sequence = begin; sequence < end; ++sequence) {
+            Slot& slot = slots_[sequence & mask_];
+            const EngineCommand& command = slot.command;
+            switch (command.type) {
+                case CommandType::Submit:
+                    slot.fills.clear();
+                    if (slot.rejected) {
+                        // A voided first submit still leaves its Instrument
+                        // record, from which replay creates the book
+                        if (slot.new_book) {
+                            engine_.getOrCreateOrderBook(command.symbol);
+                        }
+                        slot.order.reject();
+                    } else {
+                        engine_.listener().target = &slot.order;
+                        engine_.submitOrder(slot.order, slot.fills);
+                    }
+                    break;
+                case CommandType::Cancel:
+                    if (!slot.rejected) {
+                        engine_.cancelOrder(command.symbol, command.order_id);
+                    }
+                    break;
+                case CommandType::Modify:
+                    if (!slot.rejected) {
+                        engine_.modifyOrder(command.symbol, command.order_id,
+                                            command.price, command.quantity);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        engine_.listener().target = nullptr;
+    }
+    
+    // Stage 3: events and positions, in the order a serial engine gives them
+    void publishStage(uint64_t begin, uint64_t end) {
+        for (uint64_t sequence = begin; sequence < end; ++sequence) {
+            Slot& slot = slots_[sequence & mask_];
+            if (slot.command.type != CommandType::Submit) {
+                continue;
+            }
+            for (const Fill& fill : slot.fills) {
+                listener_.onFill(fill);
+                if (risk_manager_) {
+                    risk_manager_->updatePosition(fill.symbol, fill.side,
+                                                  fill.quantity, fill.price);
+                }
+            }
+            listener_.onOrder(slot.order);
+        }
+    }
+    
+    bool isKnown(SymbolId symbol) const { return symbol < known_.size() && known_[symbol]; }
+    
+    void markKnown(SymbolId symbol) {
+        if (symbol >= known_.size()) {
+            known_.resize(static_cast<size_t>(symbol) + 1, false);
+        }
+        known_[symbol] = true;
+    }
+    
+    PipelineOptions options_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    
+    // Stage 2 only once started
+    BasicMatchingEngine<PipelineMatchListener> engine_;
+    
+    // Shared by stages 1 and 3 (locking)
+    std::shared_ptr<RiskManager> risk_manager_;
+    
+    // Stage 1 only once started
+    std::shared_ptr<OrderJournal> journal_;
+    std::vector<bool> known_;    // By SymbolId: has a book (or will by the time stage 2 gets there)
+    
+    // Stage 3 only once started
+    Listener listener_;
+    
+    // Publisher's own copy of published_
+    uint64_t next_ = 0;
+    
+    // Slots finished by the publisher and each stage
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> published_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> checked_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> matched_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> completed_{0};
+    
+    bool started_ = false;
+    std::atomic<bool> stopping_{false};
+    std::thread threads_[3];
+};
+
+} // namespace trading
+
+#endif // TRADING_ENGINE_PIPELINE_HPP
@@ -0,0 +1,191 @@
+#ifndef TRADING_ENGINE_SNAPSHOT_HPP
+#define TRADING_ENGINE_SNAPSHOT_HPP
+
+#include "journal_replay.hpp"
+#include "mapped_file.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief What a snapshot holds and where in the journal it was taken
+ */
+struct SnapshotInfo {
+    bool ok = false;                 // Written, or read and restored, in full
+    uint64_t journal_sequence = 0;   // Last journal record the snapshot includes
+    uint64_t journal_offset = 0;     // Journal file offset just past that record
+    uint64_t state_hash = 0;         // Engine stateHash() when the snapshot was taken
+    bool has_risk = false;           // Risk limits, positions and counters included
+    size_t books = 0;
+    uint64_t orders = 0;             // Resting orders over all books
+    size_t risk_symbols = 0;
+};
+
+/**
+ * @brief Binary snapshot of every book's resting orders and the risk state
+ *
+ * The file is a versioned header followed by a checksummed body of
+ * fixed-size, 8-byte aligned records: per book its instrument and then
+ * each price level, best first, with its orders in time priority (id,
+ * quantity, filled quantity); then the global risk limits and rate
+ * counter, and each symbol's limits, position and exposure. Symbols are
+ * stored by name, so any process can restore the file.
+ *
+ * Reading maps the file and builds each book directly from its levels
+ * (OrderBook::restoreLevel()), in time linear in the number of orders and
+ * without matching, publishing or per-order depth updates.
+ *
+ * A snapshot records the journal position it corresponds to; replaying
+ * only the journal after that position recovers the engine, so recovery
+ * time is bounded by the snapshot interval rather than the journal's age.
+ */
+class EngineSnapshot {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    
+    /**
+     * @brief Write a snapshot, atomically replacing any file at path
+     * @param books Books to include
+     * @param risk Risk state to include, or nullptr
+     * @param info Journal position and state hash to record; the counts
+     *        are filled in
+     * @return false if the file cannot be written and synced
+     */
+    static bool write(const std::string& path, const std::vector<const OrderBook*>& books,
+                      const RiskManager* risk, SnapshotInfo& info);
+    
+    /**
+     * @brief Map a snapshot and check its header and checksum
+     * @return false if it is missing, of another version or corrupt
+     */
+    bool open(const std::string& path);
+    
+    const SnapshotInfo& info() const { return info_; }
+    
+    /**
+     * @brief Build the snapshot's books (timestamps are the restore time)
+     * @return false, with books left empty, if a book cannot be rebuilt
+     */
+    bool restoreBooks(std::vector<std::unique_ptr<OrderBook>>& books) const;
+    
+    /**
+     * @brief Overwrite a risk manager's limits, positions and counters
+     * @return false if the snapshot has no risk state
+     */
+    bool restoreRisk(RiskManager& risk) const;
+
+private:
+    MappedFile file_;
+    SnapshotInfo info_;
+    const char* books_begin_ = nullptr;   // First book record
+    const char* risk_begin_ = nullptr;    // First per-symbol risk record
+    const char* body_end_ = nullptr;
+};
+
+/**
+ * @brief Fix the point in the journal a snapshot is taken at
+ * @param books Filled with the engine's books
+ * @param info Journal position filled in (0 without a journal)
+ * @return false if the journal cannot be synced
+ *
+ * With a journal attached, records its current position, re-records
+ * every book's instrument after it (so a replay of the tail alone can map
+ * symbol ids) and syncs it, all before the snapshot is written.
+ */
+template <typename Listener>
+bool markSnapshotPoint(BasicMatchingEngine<Listener>& engine,
+                       std::vector<const OrderBook*>& books, SnapshotInfo& info) {
+    books.clear();
+    engine.forEachBook([&books](const OrderBook& book) { books.push_back(&book); });
+    
+    const auto& journal = engine.journal();
+    if (!journal) {
+        return true;
+    }
+    info.journal_sequence = journal->sequence();
+    info.journal_offset = journal->endOffset();
+    for (const OrderBook* book : books) {
+        journal->appendInstrument(book->symbolId(), book->instrument());
+    }
+    return journal->sync();
+}
+
+/**
+ * @brief Snapshot an engine's books and risk state
+ *
+ * Runs on the calling thread, between commands; see ForkSnapshot for
+ * writing it without holding up matching.
+ */
+template <typename Listener>
+SnapshotInfo saveSnapshot(const std::string& path, BasicMatchingEngine<Listener>& engine) {
+    SnapshotInfo info;
+    info.state_hash = engine.stateHash();
+    
+    std::vector<const OrderBook*> books;
+    if (markSnapshotPoint(engine, books, info)) {
+        info.ok = EngineSnapshot::write(path, books, engine.riskManager().get(), info);
+    }
+    return info;
+}
+
+/**
+ * @brief Load a snapshot into an engine that has no books yet
+ * @return Snapshot contents; ok is false if the file is unusable, or if
+ *         the engine's hash afterwards differs from the one recorded (only
+ *         checked when the engine's risk manager matches the snapshot's)
+ *
+ * Risk state goes to the engine's risk manager, if it has one.
+ */
+template <typename Listener>
+SnapshotInfo restoreSnapshot(const std::string& path, BasicMatchingEngine<Listener>& engine) {
+    EngineSnapshot snapshot;
+    std::vector<std::unique_ptr<OrderBook>> books;
+    if (!snapshot.open(path) || !snapshot.restoreBooks(books)) {
+        return SnapshotInfo();
+    }
+    
+    SnapshotInfo info = snapshot.info();
+    for (auto& book : books) {
+        if (!engine.adoptBook(std::move(book))) {
+            info.ok = false;
+        }
+    }
+    if (engine.riskManager() && info.has_risk) {
+        snapshot.restoreRisk(*engine.riskManager());
+    }
+    if (info.has_risk == (engine.riskManager() != nullptr)) {
+        info.ok = info.ok && engine.stateHash() == info.state_hash;
+    }
+    return info;
+}
+
+/**
+ * @brief Recover an engine from a snapshot and the journal written after it
+ * @return Result of replaying the journal tail; ok is false if the
+ *         snapshot was restored but the tail does not continue from it
+ *
+ * Without a usable snapshot (or one taken with no journal attached) any
+ * books it restored are dropped and the whole journal is replayed.
+ */
+template <typename Listener>
+ReplayResult recoverEngine(const std::string& snapshot_path, const std::string& journal_path,
+                           BasicMatchingEngine<Listener>& engine,
+                           ReplayOptions options = ReplayOptions()) {
+    SnapshotInfo info = restoreSnapshot(snapshot_path, engine);
+    bool resume = info.ok && info.journal_offset != 0;
+    options.start_sequence = resume ? info.journal_sequence : 0;
+    options.start_offset = resume ? info.journal_offset : 0;
+    if (!resume) {
+        engine.releaseBooks();
+        if (engine.riskManager()) {
+            engine.riskManager()->reset();
+        }
+    }
+    return replayJournal(journal_path, engine, options);
+}
+
+} // namespace trading
+
+#endif // TRADING_ENGINE_SNAPSHOT_HPP
@@ -0,0 +1,122 @@
+#ifndef TRADING_FORK_SNAPSHOT_HPP
+#define TRADING_FORK_SNAPSHOT_HPP
+
+#include "engine_snapshot.hpp"
+#include <chrono>
+#include <functional>
+#include <string>
+#include <sys/types.h>
+
+namespace trading {
+
+/**
+ * @brief Cost of one forked snapshot
+ */
+struct ForkSnapshotMetrics {
+    uint64_t stall_ns = 0;      // Caller blocked in start(): journal sync and fork()
+    uint64_t fork_ns = 0;       // fork() alone (copying the page tables)
+    uint64_t write_ns = 0;      // Child: hashing, serializing and syncing the file
+    uint64_t duration_ns = 0;   // fork() until poll() / wait() saw the child finish
+    uint64_t cow_bytes = 0;     // Memory duplicated by copy-on-write while the child ran
+};
+
+/**
+ * @brief Writes engine snapshots from a forked child process (Linux)
+ *
+ * start() fixes the journal position, then fork()s. The child sees the
+ * engine exactly as it was at the fork, through copy-on-write pages, and
+ * writes the snapshot file while the caller goes straight back to
+ * matching. The caller only pays for the journal sync and for fork()
+ * copying the page tables; each page either process writes to afterwards
+ * is duplicated once.
+ *
+ * The child measures the duplication itself, as the drop in its shared
+ * pages (from /proc/self/smaps_rollup; 0 if unavailable), and reports it
+ * with the snapshot result through a pipe.
+ *
+ * Only the calling thread exists in the child. The symbol registry lock is
+ * held across fork() so the child can look up names; other locks that
+ * threads may hold must not be needed by the child.
+ */
+class ForkSnapshot {
+public:
+    ForkSnapshot() = default;
+    ~ForkSnapshot();    // Waits for a running child
+    
+    ForkSnapshot(const ForkSnapshot&) = delete;
+    ForkSnapshot& operator=(const ForkSnapshot&) = delete;
+    
+    /**
+     * @brief Start writing a snapshot of the engine in a child process
+     * @return false if one is still running, or the journal sync or fork
+     *         failed
+     *
+     * Call it on the engine's thread, between commands.
+     */
+    template <typename Listener>
+    bool start(const std::string& path, BasicMatchingEngine<Listener>& engine);
+    
+    bool running() const { return child_ > 0; }
+    
+    /**
+     * @brief Check for the child finishing, without blocking
+     * @return true once the snapshot is finished (info() and metrics() hold
+     *         its outcome); false while it is still being written
+     */
+    bool poll();
+    
+    /**
+     * @brief Block until the child finishes
+     * @return info().ok
+     */
+    bool wait();
+    
+    /**
+     * @brief Outcome of the last finished snapshot
+     */
+    const SnapshotInfo& info() const { return info_; }
+    const ForkSnapshotMetrics& metrics() const { return metrics_; }
+
+private:
+    pid_t child_ = -1;
+    int result_fd_ = -1;
+    std::chrono::steady_clock::time_point forked_at_;
+    SnapshotInfo info_;
+    ForkSnapshotMetrics metrics_;
+    
+    // Fork; the child runs write and exits. Called with the stall clock running.
+    bool launch(const std::function<SnapshotInfo()>& write);
+    
+    // Collect the child's report once it has exited
+    void finish(int status);
+};
+
+template <typename Listener>
+bool ForkSnapshot::start(const std::string& path, BasicMatchingEngine<Listener>& engine) {
+    if (running()) {
+        return false;
+    }
+    auto started = std::chrono::steady_clock::now();
+    metrics_ = ForkSnapshotMetrics();
+    info_ = SnapshotInfo();
+    
+    SnapshotInfo info;
+    std::vector<const OrderBook*> books;
+    if (!markSnapshotPoint(engine, books, info)) {
+        return false;
+    }
+    
+    // Everything else, hashing included, happens in the child
+    bool launched = launch([&]() {
+        info.state_hash = engine.stateHash();
+        info.ok = EngineSnapshot::write(path, books, engine.riskManager().get(), info);
+        return info;
+    });
+    metrics_.stall_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    return launched;
+}
+
+} // namespace trading
+
+#endif // TRADING_FORK_SNAPSHOT_HPP
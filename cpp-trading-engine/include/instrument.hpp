@@ -0,0 +1,95 @@
+#ifndef TRADING_INSTRUMENT_HPP
+#define TRADING_INSTRUMENT_HPP
+
+#include "types.hpp"
+#include <cmath>
+
+namespace trading {
+
+// Default tick size (one cent) used when a symbol has no explicit spec
+constexpr double DEFAULT_TICK_SIZE = 0.01;
+constexpr int DEFAULT_PRICE_DECIMALS = 2;
+
+/**
+ * @brief Convert a decimal price to integer ticks
+ * @param price Price in currency units
+ * @param tick_size Currency value of one tick
+ * @return Nearest tick count
+ */
+inline Price toTicks(double price, double tick_size = DEFAULT_TICK_SIZE) {
+    return static_cast<Price>(std::llround(price / tick_size));
+}
+
+/**
+ * @brief Convert integer ticks back to a decimal price
+ * @param ticks Price in ticks
+ * @param tick_size Currency value of one tick
+ * @return Price in currency units
+ */
+inline double fromTicks(Price ticks, double tick_size = DEFAULT_TICK_SIZE) {
+    return static_cast<double>(ticks) * tick_size;
+}
+
+/**
+ * @brief Price level container backing an order book
+ */
+enum class BookLayout : uint8_t {
+    Map = 0,        // Ordered tree of levels, any price accepted
+    Array = 1       // Contiguous tick-indexed ladder over a fixed price band
+};
+
+/**
+ * @brief Static per-symbol instrument metadata
+ *
+ * All prices inside the engine are integer tick counts. The spec carries
+ * the scaling needed to translate them to and from currency units at the
+ * gateway and reporting edges.
+ */
+struct InstrumentSpec {
+    Symbol symbol;           // Trading symbol (e.g., "AAPL")
+    double tick_size;        // Currency value of one tick
+    int price_decimals;      // Decimal places used when displaying prices
+    BookLayout layout;       // Level container used by the order book
+    Price band_low;          // Lowest price (ticks) an Array book accepts
+    Price band_ticks;        // Number of ticks an Array book covers
+    
+    InstrumentSpec()
+        : symbol("")
+        , tick_size(DEFAULT_TICK_SIZE)
+        , price_decimals(DEFAULT_PRICE_DECIMALS)
+        , layout(BookLayout::Map)
+        , band_low(0)
+        , band_ticks(0)
+    {}
+    
+    explicit InstrumentSpec(const Symbol& symbol,
+                            double tick_size = DEFAULT_TICK_SIZE,
+                            int price_decimals = DEFAULT_PRICE_DECIMALS)
+        : symbol(symbol)
+        , tick_size(tick_size)
+        , price_decimals(price_decimals)
+        , layout(BookLayout::Map)
+        , band_low(0)
+        , band_ticks(0)
+    {}
+    
+    /**
+     * @brief Select the tick-indexed array layout
+     * @param low Lowest price in ticks the book will accept
+     * @param ticks Width of the band; orders outside it are rejected
+     * @return Reference to this spec for chaining
+     */
+    InstrumentSpec& withArrayLadder(Price low, Price ticks) {
+        layout = BookLayout::Array;
+        band_low = low;
+        band_ticks = ticks;
+        return *this;
+    }
+    
+    Price toTicks(double price) const { return trading::toTicks(price, tick_size); }
+    double toDouble(Price ticks) const { return fromTicks(ticks, tick_size); }
+};
+
+} // namespace trading
+
+#endif // TRADING_INSTRUMENT_HPP
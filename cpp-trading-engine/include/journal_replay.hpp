@@ -0,0 +1,136 @@
+#ifndef TRADING_JOURNAL_REPLAY_HPP
+#define TRADING_JOURNAL_REPLAY_HPP
+
+#include "matching_engine.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace trading {
+
+struct ReplayOptions {
+    // Worker threads; 0 uses one per hardware thread. Never more than the
+    // number of symbols with commands.
+    size_t threads = 0;
+    
+    // Rebuild RiskManager positions from the fills. Must match whether the
+    // journaling engine had a risk manager, or checkpoints will not verify.
+    bool positions = true;
+    
+    // Where to start reading: just past the record with this sequence, at
+    // this file offset (an OrderJournal's sequence() and endOffset() when a
+    // snapshot was taken). 0 reads the whole journal.
+    uint64_t start_sequence = 0;
+    uint64_t start_offset = 0;
+};
+
+struct ReplayResult {
+    bool ok = false;                 // Journal read and every hash verified
+    bool truncated = false;          // Reading stopped at a torn or corrupt record
+    uint64_t last_sequence = 0;      // Last valid record in the journal
+    uint64_t commands = 0;           // Submits, cancels and modifies applied
+    uint64_t rejected = 0;           // Commands skipped: not applied when journaled
+    uint64_t unknown_symbol = 0;     // Commands for a symbol id with no Instrument record
+    uint64_t fills = 0;
+    size_t books = 0;
+    size_t partitions = 0;           // Worker threads used
+    size_t checkpoints = 0;          // Checkpoint records verified
+    uint64_t mismatch_sequence = 0;  // First checkpoint whose hash differed (0 if none)
+    uint64_t state_hash = 0;         // Hash of the rebuilt state (see stateHash())
+};
+
+/**
+ * @brief Rebuilds order books and positions from an order journal
+ *
+ * Books are independent, so the symbols are split into partitions of
+ * roughly equal command counts and each partition is replayed by its own
+ * worker thread, through its own BasicMatchingEngine. Workers install no
+ * callbacks and no risk checks (the journal records which submits risk
+ * rejected), and their books never read the clock. Each worker keeps the
+ * positions of its own symbols, which are summed afterwards.
+ *
+ * Checkpoint records are verified as well: every worker hashes its share
+ * of the state when it passes one, and the shares must add up to the hash
+ * the live engine recorded.
+ *
+ * Replay starts from empty books and reads the whole journal, or from
+ * seeded books (restored from a snapshot) and reads only the journal tail
+ * written after them.
+ */
+class JournalReplay {
+public:
+    explicit JournalReplay(ReplayOptions options = ReplayOptions());
+    
+    /**
+     * @brief Start the next run() from existing books
+     * @param books Books as of options.start_sequence; run() hands them
+     *        back through books() with the journal tail applied
+     * @param base Positions as of options.start_sequence, or nullptr if
+     *        flat. Read during run(); positions() holds only the change.
+     */
+    void seed(std::vector<std::unique_ptr<OrderBook>> books, const RiskManager* base);
+    
+    /**
+     * @brief Replay a journal file
+     * @return Counts and verification results; ok is false if the file is
+     *         not a journal or a checkpoint did not match
+     */
+    ReplayResult run(const std::string& path);
+    
+    /**
+     * @brief Books rebuilt by the last run(), ready to hand to an engine
+     */
+    std::vector<std::unique_ptr<OrderBook>>& books() { return books_; }
+    
+    /**
+     * @brief Positions rebuilt by the last run() (with options.positions)
+     */
+    const RiskManager& positions() const { return positions_; }
+
+private:
+    ReplayOptions options_;
+    std::vector<std::unique_ptr<OrderBook>> books_;
+    RiskManager positions_;
+    std::vector<std::unique_ptr<OrderBook>> seed_books_;
+    const RiskManager* base_ = nullptr;
+};
+
+/**
+ * @brief Recover an engine from its journal
+ * @param engine Engine to receive the books. Books it already has are the
+ *        starting state (see restoreSnapshot()); without them, set no
+ *        start position. Positions are added to its risk manager, if it
+ *        has one.
+ * @return Replay results; state_hash is the engine's hash after recovery,
+ *         and ok is false unless it equals the hash of the replayed state
+ *
+ * Attach the journal (reopened for appending) after recovery so new
+ * commands continue its sequence.
+ */
+template <typename Listener>
+ReplayResult replayJournal(const std::string& path, BasicMatchingEngine<Listener>& engine,
+                           ReplayOptions options = ReplayOptions()) {
+    options.positions = engine.riskManager() != nullptr;
+    JournalReplay replay(options);
+    replay.seed(engine.releaseBooks(), engine.riskManager().get());
+    ReplayResult result = replay.run(path);
+    
+    uint64_t replayed_hash = result.state_hash;
+    for (auto& book : replay.books()) {
+        if (!engine.adoptBook(std::move(book))) {
+            result.ok = false;
+        }
+    }
+    replay.books().clear();
+    if (engine.riskManager()) {
+        engine.riskManager()->addPositions(replay.positions());
+    }
+    
+    result.state_hash = engine.stateHash();
+    result.ok = result.ok && result.state_hash == replayed_hash;
+    return result;
+}
+
+} // namespace trading
+
+#endif // TRADING_JOURNAL_REPLAY_HPP
@@ -0,0 +1,119 @@
+#ifndef TRADING_LEVEL_UPDATE_HPP
+#define TRADING_LEVEL_UPDATE_HPP
+
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief Market-by-price delta: the new aggregate state of one level
+ *
+ * A quantity of zero means the level is gone.
+ */
+struct LevelUpdate {
+    SymbolId symbol = INVALID_SYMBOL_ID;
+    Side side = Side::Buy;
+    Price price = 0;
+    Quantity quantity = 0;       // New total resting quantity
+    uint32_t order_count = 0;    // New number of resting orders
+};
+
+/**
+ * @brief Levels changed since the last flush, in first-change order
+ *
+ * Each entry holds the latest state recorded for its level, so any number
+ * of changes to a level between flushes collapse into one update carrying
+ * its final aggregate. A flat open-addressing index keyed by (side, price)
+ * finds a level's entry in constant time, so a sweep touching many levels
+ * stays linear. Storage is reused across flushes.
+ */
+class LevelChangeSet {
+public:
+    LevelChangeSet() {
+        changed_.reserve(16);
+        rehash(64);
+    }
+    
+    void record(Side side, Price price, Quantity quantity, uint32_t order_count) {
+        uint64_t key = keyOf(side, price);
+        size_t pos = home(key);
+        for (; slots_[pos]; pos = (pos + 1) & mask_) {
+            LevelUpdate& update = changed_[slots_[pos] - 1];
+            if (update.price == price && update.side == side) {
+                update.quantity = quantity;
+                update.order_count = order_count;
+                return;
+            }
+        }
+        
+        LevelUpdate update;
+        update.side = side;
+        update.price = price;
+        update.quantity = quantity;
+        update.order_count = order_count;
+        changed_.push_back(update);
+        slots_[pos] = static_cast<uint32_t>(changed_.size());
+        if (changed_.size() * 2 > slots_.size()) {
+            rehash(slots_.size() * 2);
+        }
+    }
+    
+    bool empty() const { return changed_.empty(); }
+    size_t size() const { return changed_.size(); }
+    
+    void clear() {
+        // Only the slots in use need resetting
+        for (const LevelUpdate& update : changed_) {
+            size_t pos = home(keyOf(update.side, update.price));
+            while (slots_[pos]) {
+                slots_[pos] = 0;
+                pos = (pos + 1) & mask_;
+            }
+        }
+        changed_.clear();
+    }
+    
+    const LevelUpdate* begin() const { return changed_.data(); }
+    const LevelUpdate* end() const { return changed_.data() + changed_.size(); }
+
+private:
+    std::vector<LevelUpdate> changed_;
+    
+    // Position in changed_ plus one; zero marks an empty slot. Kept at most
+    // half full so probes stay short
+    std::vector<uint32_t> slots_;
+    size_t mask_ = 0;
+    unsigned shift_ = 0;
+    
+    static uint64_t keyOf(Side side, Price price) {
+        return (static_cast<uint64_t>(price) << 1) | static_cast<uint64_t>(side);
+    }
+    
+    // Fibonacci hashing spreads adjacent prices across the table
+    size_t home(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+    
+    void rehash(size_t capacity) {
+        slots_.assign(capacity, 0);
+        mask_ = capacity - 1;
+        shift_ = 64;
+        for (size_t size = capacity; size > 1; size >>= 1) {
+            --shift_;
+        }
+        for (size_t i = 0; i < changed_.size(); ++i) {
+            size_t pos = home(keyOf(changed_[i].side, changed_[i].price));
+            while (slots_[pos]) {
+                pos = (pos + 1) & mask_;
+            }
+            slots_[pos] = static_cast<uint32_t>(i + 1);
+        }
+    }
+};
+
+} // namespace trading
+
+#endif // TRADING_LEVEL_UPDATE_HPP
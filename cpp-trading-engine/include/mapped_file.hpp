@@ -0,0 +1,74 @@
+#ifndef TRADING_MAPPED_FILE_HPP
+#define TRADING_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace trading {
+
+/**
+ * @brief Read-only memory mapping of a file
+ *
+ * Used by journal replay and snapshot restore to read files in place,
+ * without copying them through stdio buffers.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { unmap(); }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    /**
+     * @brief Map the first size bytes of a file (0 maps all of it)
+     * @return false if it cannot be opened or mapped, or is empty
+     */
+    bool map(const std::string& path, size_t size = 0) {
+        unmap();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        if (size == 0) {
+            struct stat info;
+            if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+                ::close(fd);
+                return false;
+            }
+            size = static_cast<size_t>(info.st_size);
+        }
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        ::madvise(data, size, MADV_SEQUENTIAL);
+        data_ = data;
+        size_ = size;
+        return true;
+    }
+    
+    void unmap() {
+        if (data_) {
+            ::munmap(data_, size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+    
+    const char* data() const { return static_cast<const char*>(data_); }
+    size_t size() const { return size_; }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace trading
+
+#endif // TRADING_MAPPED_FILE_HPP
@@ -3,8 +3,13 @@
 
 #include "order_book.hpp"
 #include "risk_manager.hpp"
+#include "order_journal.hpp"
+#include "span.hpp"
 #include <memory>
 #include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace trading {
 
@@ -18,20 +23,194 @@ using FillCallback = std::function<void(const Fill&)>;
  */
 using OrderCallback = std::function<void(const Order&)>;
 
+/**
+ * @brief Callback type for batch submissions: final orders and their fills
+ */
+using BatchCallback = std::function<void(Span<const Order>, Span<const Fill>)>;
+
+/**
+ * @brief Callback type for market-by-price level updates
+ */
+using LevelUpdateCallback = std::function<void(const LevelUpdate&)>;
+
+/**
+ * @brief Listener that ignores all events
+ * 
+ * Also a convenient base for listeners that only care about some events.
+ */
+struct NullListener {
+    void onFill(const Fill&) {}
+    void onOrder(const Order&) {}
+};
+
+/**
+ * @brief Listener that forwards events to runtime std::function callbacks
+ * 
+ * Batch submissions go to the batch callback when one is set; otherwise
+ * they are replayed through the fill and order callbacks in the order a
+ * sequential submission would have produced, using the per-order fill
+ * counts the engine hands over with the batch.
+ */
+class CallbackListener {
+public:
+    void setFillCallback(FillCallback callback) { fill_callback_ = std::move(callback); }
+    void setOrderCallback(OrderCallback callback) { order_callback_ = std::move(callback); }
+    void setBatchCallback(BatchCallback callback) { batch_callback_ = std::move(callback); }
+    void setLevelUpdateCallback(LevelUpdateCallback callback) {
+        level_callback_ = std::move(callback);
+    }
+    
+    void onFill(const Fill& fill) {
+        if (fill_callback_) {
+            fill_callback_(fill);
+        }
+    }
+    
+    void onOrder(const Order& order) {
+        if (order_callback_) {
+            order_callback_(order);
+        }
+    }
+    
+    void onLevelUpdate(const LevelUpdate& update) {
+        if (level_callback_) {
+            level_callback_(update);
+        }
+    }
+    
+    void onBatch(Span<const Order> orders, Span<const Fill> fills,
+                 Span<const size_t> fill_counts) {
+        if (batch_callback_) {
+            batch_callback_(orders, fills);
+            return;
+        }
+        
+        // Each order's fills directly precede it; the counts mark where they
+        // end (ids cannot, since a batch may repeat one)
+        size_t next_fill = 0;
+        for (size_t i = 0; i < orders.size(); ++i) {
+            for (size_t end = next_fill + fill_counts[i]; next_fill < end; ++next_fill) {
+                onFill(fills[next_fill]);
+            }
+            onOrder(orders[i]);
+        }
+    }
+
+private:
+    FillCallback fill_callback_;
+    OrderCallback order_callback_;
+    BatchCallback batch_callback_;
+    LevelUpdateCallback level_callback_;
+};
+
+/**
+ * @brief True if a listener takes batch notifications
+ * 
+ * A listener opts in by defining onBatch(Span<const Order> orders,
+ * Span<const Fill> fills, Span<const size_t> fill_counts), where
+ * fill_counts[i] is the number of fills orders[i] produced (its fills come
+ * right before the next order's). Batch submissions then call it once per
+ * batch instead of calling onFill/onOrder per event.
+ */
+template <typename L, typename = void>
+struct HasBatchHook : std::false_type {};
+
+template <typename L>
+struct HasBatchHook<L, std::void_t<decltype(std::declval<L&>().onBatch(
+    std::declval<Span<const Order>>(), std::declval<Span<const Fill>>(),
+    std::declval<Span<const size_t>>()))>>
+    : std::true_type {};
+
+/**
+ * @brief True if a listener takes market-by-price level updates
+ * 
+ * A listener opts in by defining onLevelUpdate(const LevelUpdate&). Books
+ * then record which levels each call changes, and the engine reports every
+ * changed level once, with its final aggregate, when the call returns.
+ * Listeners without the hook pay nothing for it.
+ */
+template <typename L, typename = void>
+struct HasLevelHook : std::false_type {};
+
+template <typename L>
+struct HasLevelHook<L, std::void_t<decltype(std::declval<L&>().onLevelUpdate(
+    std::declval<const LevelUpdate&>()))>>
+    : std::true_type {};
+
+/**
+ * @brief One entry of a batch modify request
+ */
+struct OrderModify {
+    OrderId order_id;
+    Price new_price;         // New price (or 0 to keep current)
+    Quantity new_quantity;   // New quantity (or 0 to keep current)
+};
+
+template <typename Listener>
+class BasicMatchingEngine;
+
+/**
+ * @brief Stable reference to one engine's order book
+ * 
+ * Returned when a symbol is registered. Passing it to the handle overloads
+ * goes straight to the book with no symbol lookup. Books are never removed,
+ * so a handle stays valid for the lifetime of the engine that issued it.
+ * A default-constructed handle is invalid.
+ */
+class BookHandle {
+public:
+    BookHandle() = default;
+    
+    bool valid() const { return book_ != nullptr; }
+    explicit operator bool() const { return valid(); }
+    SymbolId symbolId() const { return symbol_; }
+    
+    bool operator==(const BookHandle& other) const { return book_ == other.book_; }
+    bool operator!=(const BookHandle& other) const { return book_ != other.book_; }
+
+private:
+    template <typename Listener>
+    friend class BasicMatchingEngine;
+    
+    BookHandle(OrderBook* book, SymbolId symbol) : book_(book), symbol_(symbol) {}
+    
+    OrderBook* book_ = nullptr;
+    SymbolId symbol_ = INVALID_SYMBOL_ID;
+};
+
 /**
  * @brief High-performance matching engine
  * 
  * Processes orders using price-time priority matching algorithm.
- * Single-threaded design optimized for low latency.
+ * Single-threaded design optimized for low latency. Books are indexed
+ * directly by SymbolId; the Symbol overloads resolve the name through
+ * the symbol registry first, and the BookHandle overloads skip the lookup
+ * entirely.
+ * 
+ * Fill and order notifications go to a Listener resolved at compile time:
+ * any type with onFill(const Fill&) and onOrder(const Order&) members.
+ * The calls are direct, so the compiler can inline them into the
+ * matching loop. MatchingEngine is the CallbackListener instantiation
+ * for code that wants to install std::function callbacks at runtime.
+ * Fills are reported once the order is fully placed: its sweep of the
+ * book has finished and any remainder is resting. A listener therefore
+ * sees the book a replay of the journal would produce, and may call back
+ * into the engine to submit, cancel or modify; a nested call completes,
+ * with its own notifications, before the outer order's remaining ones.
+ * 
+ * A listener with onLevelUpdate(const LevelUpdate&) also gets aggregated
+ * price level deltas: one update per level changed by a submit, cancel or
+ * modify call (or by a whole batch), however many orders it touched.
  */
-class MatchingEngine {
+template <typename Listener>
+class BasicMatchingEngine {
 public:
-    MatchingEngine();
-    ~MatchingEngine() = default;
+    explicit BasicMatchingEngine(Listener listener = Listener());
+    ~BasicMatchingEngine() = default;
     
     // Non-copyable
-    MatchingEngine(const MatchingEngine&) = delete;
-    MatchingEngine& operator=(const MatchingEngine&) = delete;
+    BasicMatchingEngine(const BasicMatchingEngine&) = delete;
+    BasicMatchingEngine& operator=(const BasicMatchingEngine&) = delete;
     
     /**
      * @brief Submit a new order
@@ -40,12 +219,66 @@ public:
      */
     std::vector<Fill> submitOrder(Order order);
     
+    /**
+     * @brief Submit a new order, appending fills to a caller-owned buffer
+     * @param order The order to submit
+     * @param fills Buffer the fills are appended to (not cleared); reuse
+     *        it across calls to keep the matching path allocation-free
+     * @return Final state of the order (filled, resting, cancelled, ...)
+     */
+    OrderStatus submitOrder(Order order, std::vector<Fill>& fills);
+    
+    /**
+     * @brief Submit a new order to a registered book
+     * @param book Handle from registerInstrument() / registerSymbol()
+     * @param order The order to submit (its symbol is taken from the handle)
+     * @param fills Buffer the fills are appended to (not cleared)
+     * @return Final state of the order; Rejected if the handle is invalid
+     */
+    OrderStatus submitOrder(BookHandle book, Order order, std::vector<Fill>& fills);
+    std::vector<Fill> submitOrder(BookHandle book, Order order);
+    
+    /**
+     * @brief Submit a burst of orders
+     * @param orders Orders to submit; each is updated in place with its
+     *        final status and filled quantity
+     * @param fills Buffer the fills are appended to (not cleared)
+     * @return Number of fills appended
+     * 
+     * Orders are processed in sequence, so books, risk state, fills and
+     * final statuses are identical to calling submitOrder() on each.
+     * Consecutive orders for the same symbol share one book lookup. A
+     * listener with an onBatch hook is notified once for the whole batch;
+     * otherwise it sees the same per-event calls as sequential submission.
+     * With a journal attached, the orders for existing books are committed
+     * as one group before any is processed. An order for a symbol with no
+     * book is journaled when it is reached, so its records follow the
+     * group rather than sit in submission order; books are independent,
+     * so replay rebuilds the same state either way.
+     */
+    size_t submitOrders(Span<Order> orders, std::vector<Fill>& fills);
+    
+    /**
+     * @brief Submit a burst of orders to one registered book
+     * @return Number of fills appended; all orders are rejected if the
+     *         handle is invalid
+     */
+    size_t submitOrders(BookHandle book, Span<Order> orders, std::vector<Fill>& fills);
+    
     /**
      * @brief Cancel an existing order
      * @param symbol The symbol
      * @param order_id The order ID to cancel
      * @return true if order was found and cancelled
      */
+    bool cancelOrder(BookHandle book, OrderId order_id);
+    
+    /**
+     * @brief Cancel several orders in one book
+     * @return Number of orders found and cancelled
+     */
+    size_t cancelOrders(BookHandle book, Span<const OrderId> order_ids);
+    bool cancelOrder(SymbolId symbol, OrderId order_id);
     bool cancelOrder(const Symbol& symbol, OrderId order_id);
     
     /**
@@ -56,76 +289,377 @@ public:
      * @param new_quantity New quantity (or 0 to keep current)
      * @return true if order was found and modified
      */
+    bool modifyOrder(BookHandle book, OrderId order_id,
+                     Price new_price, Quantity new_quantity);
+    
+    /**
+     * @brief Apply several modifications in one book, in order
+     * @return Number of orders found and modified
+     */
+    size_t modifyOrders(BookHandle book, Span<const OrderModify> modifies);
+    bool modifyOrder(SymbolId symbol, OrderId order_id,
+                     Price new_price, Quantity new_quantity);
     bool modifyOrder(const Symbol& symbol, OrderId order_id, 
                      Price new_price, Quantity new_quantity);
     
+    /**
+     * @brief Register an instrument and create its order book
+     * @param spec Instrument metadata (tick size, display scaling)
+     * @return true if the book was created, false if the symbol already exists
+     */
+    bool addInstrument(const InstrumentSpec& spec);
+    
+    /**
+     * @brief Register an instrument up front and get a handle to its book
+     * @param spec Instrument metadata (ignored if the book already exists)
+     * @param expected_orders Resting orders to pre-allocate storage for, so
+     *        the first orders do not pay for book or pool growth
+     * @return Handle to the (new or existing) book
+     */
+    BookHandle registerInstrument(const InstrumentSpec& spec, size_t expected_orders = 0);
+    
+    /**
+     * @brief Register a symbol with default instrument settings
+     * @param symbol The symbol
+     * @param expected_orders Resting orders to pre-allocate storage for
+     * @return Handle to the (new or existing) book
+     */
+    BookHandle registerSymbol(const Symbol& symbol, size_t expected_orders = 0);
+    
+    /**
+     * @brief Look up the handle of an existing book
+     * @return Handle, invalid if the symbol has no book
+     */
+    BookHandle getBookHandle(SymbolId symbol) const;
+    BookHandle getBookHandle(const Symbol& symbol) const;
+    
     /**
      * @brief Get order book for a symbol
      * @param symbol The symbol to look up
      * @return Pointer to order book, nullptr if not found
      */
+    const OrderBook* getOrderBook(BookHandle book) const { return book.book_; }
+    const OrderBook* getOrderBook(SymbolId symbol) const;
     const OrderBook* getOrderBook(const Symbol& symbol) const;
     
     /**
      * @brief Get or create order book for a symbol
      * @param symbol The symbol
-     * @return Reference to the order book
+     * @return Pointer to the order book, nullptr if the id was never
+     *         issued by the symbol registry
      */
-    OrderBook& getOrCreateOrderBook(const Symbol& symbol);
+    OrderBook* getOrCreateOrderBook(SymbolId symbol);
+    OrderBook* getOrCreateOrderBook(const Symbol& symbol);
     
     /**
-     * @brief Set fill callback
+     * @brief Take over a book built elsewhere (e.g. by journal replay)
+     * @return Handle to the adopted book; invalid, and the book discarded,
+     *         if this engine already has a book for the symbol
+     */
+    BookHandle adoptBook(std::unique_ptr<OrderBook> book);
+    
+    /**
+     * @brief Hand over every book, leaving the engine without any
+     * 
+     * Handles issued by this engine are invalid afterwards.
+     */
+    std::vector<std::unique_ptr<OrderBook>> releaseBooks();
+    
+    /**
+     * @brief Visit every book, in symbol id order
+     * @param visit Called as visit(const OrderBook&)
+     */
+    template <typename Visitor>
+    void forEachBook(Visitor&& visit) const {
+        for (const auto& book : order_books_) {
+            if (book) {
+                visit(*book);
+            }
+        }
+    }
+    
+    /**
+     * @brief Access the listener receiving fill and order events
+     */
+    Listener& listener() { return listener_; }
+    const Listener& listener() const { return listener_; }
+    
+    /**
+     * @brief Set fill callback (CallbackListener engines only)
      * @param callback Function to call on each fill
      */
-    void setFillCallback(FillCallback callback);
+    void setFillCallback(FillCallback callback) {
+        listener_.setFillCallback(std::move(callback));
+    }
     
     /**
-     * @brief Set order callback
+     * @brief Set order callback (CallbackListener engines only)
      * @param callback Function to call on order status changes
      */
-    void setOrderCallback(OrderCallback callback);
+    void setOrderCallback(OrderCallback callback) {
+        listener_.setOrderCallback(std::move(callback));
+    }
+    
+    /**
+     * @brief Set batch callback (CallbackListener engines only)
+     * @param callback Function to call once per submitOrders() batch
+     */
+    void setBatchCallback(BatchCallback callback) {
+        listener_.setBatchCallback(std::move(callback));
+    }
+    
+    /**
+     * @brief Set level update callback (CallbackListener engines only)
+     * @param callback Function to call once per changed price level
+     */
+    void setLevelUpdateCallback(LevelUpdateCallback callback) {
+        listener_.setLevelUpdateCallback(std::move(callback));
+    }
     
     /**
      * @brief Set risk manager
      * @param risk_manager Shared pointer to risk manager
      */
     void setRiskManager(std::shared_ptr<RiskManager> risk_manager);
+    const std::shared_ptr<RiskManager>& riskManager() const { return risk_manager_; }
+    
+    /**
+     * @brief Write every inbound command to a journal before acting on it
+     * @param journal Open journal, or nullptr to stop journaling
+     * 
+     * Submits, cancels and modifies are appended before they are
+     * processed, and book creation is recorded with its instrument spec.
+     * Batch calls commit the whole batch before processing any of it;
+     * single commands are committed in groups per the journal's options.
+     * Books that already exist are recorded when the journal is attached,
+     * but their resting orders are not, so attach it before trading starts.
+     * 
+     * Loss window: with the default group_size of 1 every single command
+     * is written before it is processed. A larger group_size lets up to
+     * group_size - 1 commands be processed, and their fills published,
+     * while still in memory, until the group fills or journal()->
+     * flushIdle() runs (EngineLoop calls it whenever its queue drains).
+     * Durability past a process crash then follows the fsync policy;
+     * under Periodic, written commands reach stable storage within
+     * sync_interval of a later commit, or at the next flushIdle().
+     * 
+     * Risk decisions depend on limits and the wall clock, so a submit the
+     * risk manager rejects is followed by a Reject record; replay applies
+     * the recorded decision instead of checking again.
+     */
+    void setJournal(std::shared_ptr<OrderJournal> journal);
+    const std::shared_ptr<OrderJournal>& journal() const { return journal_; }
+    
+    /**
+     * @brief True while the attached journal has a failed write or sync
+     * 
+     * Commands the journal cannot cover are not processed: submits are
+     * rejected (and not journaled), cancels and modifies return false.
+     * That includes the command, or batch, whose own commit failed: it
+     * stays buffered, so it is voided with Reject records that replay
+     * honours should the write go through later. Nothing already
+     * journaled is lost; trading resumes once a journal()->commit()
+     * succeeds.
+     */
+    bool journalFailed() const { return journal_ && journal_->failed(); }
+    
+    /**
+     * @brief Hash of every book's resting orders and, with a risk manager,
+     *        each symbol's position
+     * 
+     * Independent of symbol ids and book creation order, so an engine
+     * rebuilt by journal replay in another process hashes the same.
+     */
+    uint64_t stateHash() const;
+    
+    /**
+     * @brief Record the current state hash in the journal and commit it
+     * @return The hash (also returned when no journal is attached)
+     * 
+     * Replay verifies its rebuilt state against every checkpoint it passes.
+     */
+    uint64_t journalCheckpoint();
     
     /**
      * @brief Get statistics
      */
     uint64_t totalOrdersProcessed() const { return total_orders_; }
     uint64_t totalFillsGenerated() const { return total_fills_; }
-    
+
 private:
-    std::unordered_map<Symbol, std::unique_ptr<OrderBook>> order_books_;
+    // Indexed by SymbolId; nullptr for symbols without a book
+    std::vector<std::unique_ptr<OrderBook>> order_books_;
     std::shared_ptr<RiskManager> risk_manager_;
+    std::shared_ptr<OrderJournal> journal_;
     
-    FillCallback fill_callback_;
-    OrderCallback order_callback_;
+    Listener listener_;
     
     uint64_t total_orders_ = 0;
     uint64_t total_fills_ = 0;
     
+    // Journal sequence of the submit being processed, for Reject records
+    uint64_t journal_sequence_ = 0;
+    
+    // Fills per order of the batch being submitted, for the batch hook;
+    // reused so batches stay allocation-free
+    std::vector<size_t> batch_fill_counts_;
+    
+    // Journal sequence per order of a batch (0: journaled when reached),
+    // likewise reused
+    std::vector<uint64_t> batch_sequences_;
+    
+    // Batch submissions notify through onBatch when the listener has one
+    static constexpr bool kBatchHook = HasBatchHook<Listener>::value;
+    
+    // Books track changed levels only when someone consumes the deltas
+    static constexpr bool kLevelHook = HasLevelHook<Listener>::value;
+    
     /**
      * @brief Match an order against the book
      * @param book The order book
      * @param order The aggressor order
-     * @return Vector of fills generated
+     * @param fills Buffer the generated fills are appended to
+     */
+    template <bool Notify>
+    void matchOrder(OrderBook& book, Order& order, std::vector<Fill>& fills);
+    
+    /**
+     * @brief Risk check, match and notify for an order bound for a book
+     * @tparam Notify false when a batch hook will report the order instead
+     */
+    template <bool Notify>
+    OrderStatus processOrder(OrderBook& book, Order& order, std::vector<Fill>& fills);
+    
+    /**
+     * @brief Journal and process an order for an existing book
+     */
+    template <bool Notify>
+    OrderStatus submitToBook(OrderBook& book, Order& order, std::vector<Fill>& fills);
+    
+    /**
+     * @brief Submit an order for a symbol that has no book yet
+     * 
+     * Ids the symbol registry never issued are rejected, and so are
+     * orders the risk manager turns down; the book is created only for
+     * an order that goes on to match.
+     */
+    template <bool Notify>
+    OrderStatus submitToNewBook(Order& order, std::vector<Fill>& fills);
+    
+    /**
+     * @brief Reject an order before it is journaled, and report it
+     */
+    template <bool Notify>
+    OrderStatus refuseOrder(Order& order);
+    
+    /**
+     * @brief Refuse a whole batch (see refuseOrder())
+     * @return 0, the number of fills appended
+     */
+    size_t refuseBatch(Span<Order> orders, std::vector<Fill>& fills, size_t first_fill);
+    
+    /**
+     * @brief Reject an order, journaling the decision and reporting it
+     */
+    template <bool Notify>
+    OrderStatus rejectOrder(Order& order);
+    
+    /**
+     * @brief Match and notify for an order that passed the risk check
+     */
+    template <bool Notify>
+    OrderStatus executeOrder(OrderBook& book, Order& order, std::vector<Fill>& fills);
+    
+    bool passesRisk(const Order& order) {
+        return !risk_manager_ || risk_manager_->checkOrder(order);
+    }
+    
+    /**
+     * @brief Note how many fills the batch's latest order produced
+     */
+    void countBatchFills(const std::vector<Fill>& fills, size_t before) {
+        if constexpr (kBatchHook) {
+            batch_fill_counts_.push_back(fills.size() - before);
+        }
+    }
+    
+    /**
+     * @brief Report a finished batch through the listener's batch hook
+     */
+    void notifyBatch(Span<const Order> orders, const std::vector<Fill>& fills,
+                     size_t first_fill);
+    
+    /**
+     * @brief Append a command to the journal, if one is attached
+     * @return Sequence assigned to the command (0 without a journal)
      */
-    std::vector<Fill> matchOrder(OrderBook& book, Order& order);
+    uint64_t journalCommand(const JournalRecord& record) {
+        return journal_ ? journal_->append(record) : 0;
+    }
     
     /**
-     * @brief Notify fill via callback
+     * @brief Void the command just journaled if its commit failed
+     * @return true if the journal has failed; the caller must then not
+     *         apply the command
      */
-    void notifyFill(const Fill& fill);
+    bool journalLost(SymbolId symbol, OrderId order_id, uint64_t sequence) {
+        if (!journalFailed()) {
+            return false;
+        }
+        journal_->append(JournalRecord::reject(symbol, order_id, sequence));
+        return true;
+    }
     
     /**
-     * @brief Notify order status via callback
+     * @brief Report the levels a call changed in one book, then reset
      */
-    void notifyOrder(const Order& order);
+    void publishLevels(OrderBook& book) {
+        if constexpr (kLevelHook) {
+            book.flushLevelUpdates([this](const LevelUpdate& update) {
+                listener_.onLevelUpdate(update);
+            });
+        }
+    }
+    
+    /**
+     * @brief Create the book for a symbol id (which must be issued by the
+     *        registry and must not have a book yet)
+     */
+    OrderBook& createBook(SymbolId symbol, const InstrumentSpec& spec);
+    
+    /**
+     * @brief Book for a symbol id, nullptr if none has been created
+     */
+    OrderBook* findBook(SymbolId symbol) const {
+        return symbol < order_books_.size() ? order_books_[symbol].get() : nullptr;
+    }
 };
 
+/**
+ * @brief State hash contribution of one book (see stateHash())
+ * @param risk Risk manager whose position for the symbol is included, or
+ *        nullptr for the book alone
+ * 
+ * An engine's hash is the sum of its books' contributions, so disjoint
+ * sets of books can be hashed separately and added up.
+ */
+uint64_t symbolStateHash(const OrderBook& book, const RiskManager* risk);
+
+/**
+ * @brief State hash contribution of one book with a given position
+ */
+uint64_t symbolStateHash(const OrderBook& book, Quantity position);
+
+/**
+ * @brief Matching engine with runtime std::function callbacks
+ */
+using MatchingEngine = BasicMatchingEngine<CallbackListener>;
+
+// Compiled once in matching_engine.cpp
+extern template class BasicMatchingEngine<CallbackListener>;
+
 } // namespace trading
 
+#include "matching_engine_impl.hpp"
+
 #endif // TRADING_MATCHING_ENGINE_HPP
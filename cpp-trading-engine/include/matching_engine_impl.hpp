@@ -0,0 +1,636 @@
+#ifndef TRADING_MATCHING_ENGINE_IMPL_HPP
+#define TRADING_MATCHING_ENGINE_IMPL_HPP
+
+// Member definitions for BasicMatchingEngine; included by matching_engine.hpp
+
+namespace trading {
+
+template <typename Listener>
+BasicMatchingEngine<Listener>::BasicMatchingEngine(Listener listener)
+    : listener_(std::move(listener)) {}
+
+template <typename Listener>
+std::vector<Fill> BasicMatchingEngine<Listener>::submitOrder(Order order) {
+    std::vector<Fill> fills;
+    submitOrder(std::move(order), fills);
+    return fills;
+}
+
+template <typename Listener>
+OrderStatus BasicMatchingEngine<Listener>::submitOrder(Order order, std::vector<Fill>& fills) {
+    ++total_orders_;
+    if (journalFailed()) {
+        return refuseOrder<true>(order);
+    }
+    OrderBook* book = findBook(order.symbol);
+    if (!book) {
+        return submitToNewBook<true>(order, fills);
+    }
+    
+    OrderStatus status = submitToBook<true>(*book, order, fills);
+    publishLevels(*book);
+    return status;
+}
+
+template <typename Listener>
+template <bool Notify>
+OrderStatus BasicMatchingEngine<Listener>::submitToBook(OrderBook& book, Order& order,
+                                                        std::vector<Fill>& fills) {
+    journal_sequence_ = journalCommand(JournalRecord::submit(order));
+    if (journalLost(order.symbol, order.id, journal_sequence_)) {
+        return refuseOrder<Notify>(order);
+    }
+    return processOrder<Notify>(book, order, fills);
+}
+
+template <typename Listener>
+template <bool Notify>
+OrderStatus BasicMatchingEngine<Listener>::submitToNewBook(Order& order,
+                                                           std::vector<Fill>& fills) {
+    // An id the registry never issued has no name and no book; it is not
+    // journaled either, since replay could not map it
+    if (!isInternedSymbol(order.symbol)) {
+        return refuseOrder<Notify>(order);
+    }
+    
+    // Risk first, so a rejected order creates no book: the journal gets
+    // the submit and its Reject with no Instrument record
+    if (!passesRisk(order)) {
+        journal_sequence_ = journalCommand(JournalRecord::submit(order));
+        return rejectOrder<Notify>(order);
+    }
+    
+    OrderBook& book = createBook(order.symbol, InstrumentSpec(symbolName(order.symbol)));
+    journal_sequence_ = journalCommand(JournalRecord::submit(order));
+    if (journalLost(order.symbol, order.id, journal_sequence_)) {
+        return refuseOrder<Notify>(order);
+    }
+    OrderStatus status = executeOrder<Notify>(book, order, fills);
+    publishLevels(book);
+    return status;
+}
+
+template <typename Listener>
+OrderStatus BasicMatchingEngine<Listener>::submitOrder(BookHandle book, Order order,
+                                                       std::vector<Fill>& fills) {
+    ++total_orders_;
+    if (!book || journalFailed()) {
+        return refuseOrder<true>(order);
+    }
+    
+    order.symbol = book.symbol_;
+    OrderStatus status = submitToBook<true>(*book.book_, order, fills);
+    publishLevels(*book.book_);
+    return status;
+}
+
+template <typename Listener>
+std::vector<Fill> BasicMatchingEngine<Listener>::submitOrder(BookHandle book, Order order) {
+    std::vector<Fill> fills;
+    submitOrder(book, std::move(order), fills);
+    return fills;
+}
+
+template <typename Listener>
+size_t BasicMatchingEngine<Listener>::submitOrders(Span<Order> orders,
+                                                   std::vector<Fill>& fills) {
+    size_t first_fill = fills.size();
+    total_orders_ += orders.size();
+    batch_fill_counts_.clear();
+    if (journalFailed()) {
+        return refuseBatch(orders, fills, first_fill);
+    }
+    
+    // Group commit: orders for existing books are journaled, back to back,
+    // before any of the batch is processed. An order for a symbol with no
+    // book yet is journaled when it is reached, as submitOrder() journals
+    // it, so only an order that passes the risk check creates a book.
+    // The buffer is taken for the call, so a listener that submits a
+    // batch of its own gets a fresh one.
+    std::vector<uint64_t> sequences = std::move(batch_sequences_);
+    sequences.clear();
+    if (journal_) {
+        for (const Order& order : orders) {
+            sequences.push_back(findBook(order.symbol)
+                ? journal_->append(JournalRecord::submit(order)) : 0);
+        }
+        if (!journal_->commit()) {
+            for (size_t i = 0; i < orders.size(); ++i) {
+                if (sequences[i] != 0) {
+                    journal_->append(JournalRecord::reject(orders[i].symbol, orders[i].id,
+                                                           sequences[i]));
+                }
+            }
+            batch_sequences_ = std::move(sequences);
+            return refuseBatch(orders, fills, first_fill);
+        }
+    }
+    
+    // Runs of orders for the same symbol reuse the book found for the first;
+    // level changes are published once per run
+    OrderBook* book = nullptr;
+    SymbolId book_symbol = INVALID_SYMBOL_ID;
+    for (size_t i = 0; i < orders.size(); ++i) {
+        Order& order = orders[i];
+        if (!book || order.symbol != book_symbol) {
+            if (book) {
+                publishLevels(*book);
+            }
+            book = findBook(order.symbol);
+            book_symbol = order.symbol;
+        }
+        size_t before = fills.size();
+        if (!sequences.empty() && sequences[i] != 0) {
+            journal_sequence_ = sequences[i];
+            processOrder<!kBatchHook>(*book, order, fills);
+        } else if (!book) {
+            submitToNewBook<!kBatchHook>(order, fills);
+            book = findBook(order.symbol);
+        } else {
+            // No journal, or a book created since the batch was journaled
+            submitToBook<!kBatchHook>(*book, order, fills);
+        }
+        countBatchFills(fills, before);
+    }
+    batch_sequences_ = std::move(sequences);
+    
+    notifyBatch(orders, fills, first_fill);
+    if (book) {
+        publishLevels(*book);
+    }
+    return fills.size() - first_fill;
+}
+
+template <typename Listener>
+size_t BasicMatchingEngine<Listener>::submitOrders(BookHandle book, Span<Order> orders,
+                                                   std::vector<Fill>& fills) {
+    size_t first_fill = fills.size();
+    total_orders_ += orders.size();
+    batch_fill_counts_.clear();
+    if (!book || journalFailed()) {
+        return refuseBatch(orders, fills, first_fill);
+    }
+    
+    uint64_t first_sequence = 0;
+    if (journal_) {
+        first_sequence = journal_->sequence() + 1;
+        for (Order& order : orders) {
+            order.symbol = book.symbol_;
+            journal_->append(JournalRecord::submit(order));
+        }
+        if (!journal_->commit()) {
+            for (size_t i = 0; i < orders.size(); ++i) {
+                journal_->append(JournalRecord::reject(book.symbol_, orders[i].id,
+                                                       first_sequence + i));
+            }
+            return refuseBatch(orders, fills, first_fill);
+        }
+    }
+    
+    for (size_t i = 0; i < orders.size(); ++i) {
+        Order& order = orders[i];
+        size_t before = fills.size();
+        order.symbol = book.symbol_;
+        journal_sequence_ = first_sequence + i;
+        processOrder<!kBatchHook>(*book.book_, order, fills);
+        countBatchFills(fills, before);
+    }
+    
+    notifyBatch(orders, fills, first_fill);
+    publishLevels(*book.book_);
+    return fills.size() - first_fill;
+}
+
+template <typename Listener>
+size_t BasicMatchingEngine<Listener>::refuseBatch(Span<Order> orders,
+                                                  std::vector<Fill>& fills,
+                                                  size_t first_fill) {
+    for (Order& order : orders) {
+        refuseOrder<!kBatchHook>(order);
+        countBatchFills(fills, fills.size());
+    }
+    notifyBatch(orders, fills, first_fill);
+    return 0;
+}
+
+template <typename Listener>
+void BasicMatchingEngine<Listener>::notifyBatch(Span<const Order> orders,
+                                                const std::vector<Fill>& fills,
+                                                size_t first_fill) {
+    if constexpr (kBatchHook) {
+        listener_.onBatch(orders, Span<const Fill>(fills.data() + first_fill,
+                                                   fills.size() - first_fill),
+                          Span<const size_t>(batch_fill_counts_));
+    }
+}
+
+template <typename Listener>
+template <bool Notify>
+OrderStatus BasicMatchingEngine<Listener>::processOrder(OrderBook& book, Order& order,
+                                                        std::vector<Fill>& fills) {
+    // Risk check if risk manager is configured
+    if (!passesRisk(order)) {
+        return rejectOrder<Notify>(order);
+    }
+    return executeOrder<Notify>(book, order, fills);
+}
+
+template <typename Listener>
+template <bool Notify>
+OrderStatus BasicMatchingEngine<Listener>::refuseOrder(Order& order) {
+    order.reject();
+    if constexpr (Notify) {
+        listener_.onOrder(order);
+    }
+    return order.status;
+}
+
+template <typename Listener>
+template <bool Notify>
+OrderStatus BasicMatchingEngine<Listener>::rejectOrder(Order& order) {
+    order.reject();
+    if (journal_) {
+        journal_->append(JournalRecord::reject(order.symbol, order.id, journal_sequence_));
+    }
+    if constexpr (Notify) {
+        listener_.onOrder(order);
+    }
+    return order.status;
+}
+
+template <typename Listener>
+template <bool Notify>
+OrderStatus BasicMatchingEngine<Listener>::executeOrder(OrderBook& book, Order& order,
+                                                        std::vector<Fill>& fills) {
+    // Match the order (also updates the risk manager per fill)
+    matchOrder<Notify>(book, order, fills);
+    
+    // Notify order status
+    if constexpr (Notify) {
+        listener_.onOrder(order);
+    }
+    
+    return order.status;
+}
+
+template <typename Listener>
+bool BasicMatchingEngine<Listener>::cancelOrder(BookHandle book, OrderId order_id) {
+    if (!book || journalFailed()) {
+        return false;
+    }
+    
+    uint64_t sequence = journalCommand(JournalRecord::cancel(book.symbol_, order_id));
+    if (journalLost(book.symbol_, order_id, sequence) || !book.book_->cancelOrder(order_id)) {
+        return false;
+    }
+    
+    publishLevels(*book.book_);
+    return true;
+}
+
+template <typename Listener>
+size_t BasicMatchingEngine<Listener>::cancelOrders(BookHandle book,
+                                                   Span<const OrderId> order_ids) {
+    if (!book || journalFailed()) {
+        return 0;
+    }
+    
+    if (journal_) {
+        uint64_t first_sequence = journal_->sequence() + 1;
+        for (OrderId order_id : order_ids) {
+            journal_->append(JournalRecord::cancel(book.symbol_, order_id));
+        }
+        if (!journal_->commit()) {
+            for (size_t i = 0; i < order_ids.size(); ++i) {
+                journal_->append(JournalRecord::reject(book.symbol_, order_ids[i],
+                                                       first_sequence + i));
+            }
+            return 0;
+        }
+    }
+    
+    size_t cancelled = 0;
+    for (OrderId order_id : order_ids) {
+        cancelled += book.book_->cancelOrder(order_id) ? 1 : 0;
+    }
+    publishLevels(*book.book_);
+    return cancelled;
+}
+
+template <typename Listener>
+bool BasicMatchingEngine<Listener>::cancelOrder(SymbolId symbol, OrderId order_id) {
+    return cancelOrder(getBookHandle(symbol), order_id);
+}
+
+template <typename Listener>
+bool BasicMatchingEngine<Listener>::cancelOrder(const Symbol& symbol, OrderId order_id) {
+    return cancelOrder(findSymbol(symbol), order_id);
+}
+
+template <typename Listener>
+bool BasicMatchingEngine<Listener>::modifyOrder(BookHandle book, OrderId order_id,
+                                                Price new_price, Quantity new_quantity) {
+    if (!book || journalFailed()) {
+        return false;
+    }
+    
+    uint64_t sequence = journalCommand(JournalRecord::modify(book.symbol_, order_id,
+                                                             new_price, new_quantity));
+    if (journalLost(book.symbol_, order_id, sequence) ||
+        !book.book_->modifyOrder(order_id, new_price, new_quantity)) {
+        return false;
+    }
+    
+    publishLevels(*book.book_);
+    return true;
+}
+
+template <typename Listener>
+size_t BasicMatchingEngine<Listener>::modifyOrders(BookHandle book,
+                                                   Span<const OrderModify> modifies) {
+    if (!book || journalFailed()) {
+        return 0;
+    }
+    
+    if (journal_) {
+        uint64_t first_sequence = journal_->sequence() + 1;
+        for (const OrderModify& modify : modifies) {
+            journal_->append(JournalRecord::modify(book.symbol_, modify.order_id,
+                                                   modify.new_price, modify.new_quantity));
+        }
+        if (!journal_->commit()) {
+            for (size_t i = 0; i < modifies.size(); ++i) {
+                journal_->append(JournalRecord::reject(book.symbol_, modifies[i].order_id,
+                                                       first_sequence + i));
+            }
+            return 0;
+        }
+    }
+    
+    size_t modified = 0;
+    for (const OrderModify& modify : modifies) {
+        modified += book.book_->modifyOrder(modify.order_id, modify.new_price,
+                                            modify.new_quantity) ? 1 : 0;
+    }
+    publishLevels(*book.book_);
+    return modified;
+}
+
+template <typename Listener>
+bool BasicMatchingEngine<Listener>::modifyOrder(SymbolId symbol, OrderId order_id,
+                                                Price new_price, Quantity new_quantity) {
+    return modifyOrder(getBookHandle(symbol), order_id, new_price, new_quantity);
+}
+
+template <typename Listener>
+bool BasicMatchingEngine<Listener>::modifyOrder(const Symbol& symbol, OrderId order_id,
+                                                Price new_price, Quantity new_quantity) {
+    return modifyOrder(findSymbol(symbol), order_id, new_price, new_quantity);
+}
+
+template <typename Listener>
+bool BasicMatchingEngine<Listener>::addInstrument(const InstrumentSpec& spec) {
+    if (findBook(findSymbol(spec.symbol))) {
+        return false;
+    }
+    
+    registerInstrument(spec);
+    return true;
+}
+
+template <typename Listener>
+BookHandle BasicMatchingEngine<Listener>::registerInstrument(const InstrumentSpec& spec,
+                                                             size_t expected_orders) {
+    SymbolId id = internSymbol(spec.symbol);
+    OrderBook* book = findBook(id);
+    if (!book) {
+        book = &createBook(id, spec);
+        if (risk_manager_) {
+            risk_manager_->setTickSize(spec.symbol, spec.tick_size);
+        }
+    }
+    
+    if (expected_orders > 0) {
+        book->reserveOrders(expected_orders);
+    }
+    return BookHandle(book, id);
+}
+
+template <typename Listener>
+BookHandle BasicMatchingEngine<Listener>::registerSymbol(const Symbol& symbol,
+                                                         size_t expected_orders) {
+    return registerInstrument(InstrumentSpec(symbol), expected_orders);
+}
+
+template <typename Listener>
+BookHandle BasicMatchingEngine<Listener>::getBookHandle(SymbolId symbol) const {
+    OrderBook* book = findBook(symbol);
+    return book ? BookHandle(book, symbol) : BookHandle();
+}
+
+template <typename Listener>
+BookHandle BasicMatchingEngine<Listener>::getBookHandle(const Symbol& symbol) const {
+    return getBookHandle(findSymbol(symbol));
+}
+
+template <typename Listener>
+const OrderBook* BasicMatchingEngine<Listener>::getOrderBook(SymbolId symbol) const {
+    return findBook(symbol);
+}
+
+template <typename Listener>
+const OrderBook* BasicMatchingEngine<Listener>::getOrderBook(const Symbol& symbol) const {
+    return findBook(findSymbol(symbol));
+}
+
+template <typename Listener>
+OrderBook* BasicMatchingEngine<Listener>::getOrCreateOrderBook(SymbolId symbol) {
+    if (OrderBook* book = findBook(symbol)) {
+        return book;
+    }
+    if (!isInternedSymbol(symbol)) {
+        return nullptr;
+    }
+    
+    return &createBook(symbol, InstrumentSpec(symbolName(symbol)));
+}
+
+template <typename Listener>
+OrderBook* BasicMatchingEngine<Listener>::getOrCreateOrderBook(const Symbol& symbol) {
+    return getOrCreateOrderBook(internSymbol(symbol));
+}
+
+template <typename Listener>
+BookHandle BasicMatchingEngine<Listener>::adoptBook(std::unique_ptr<OrderBook> book) {
+    SymbolId symbol = book ? book->symbolId() : INVALID_SYMBOL_ID;
+    if (!book || !isInternedSymbol(symbol) || findBook(symbol)) {
+        return BookHandle();
+    }
+    
+    if (symbol >= order_books_.size()) {
+        order_books_.resize(static_cast<size_t>(symbol) + 1);
+    }
+    book->trackLevelChanges(kLevelHook);
+    if (risk_manager_) {
+        risk_manager_->setTickSize(book->symbol(), book->instrument().tick_size);
+    }
+    if (journal_) {
+        journal_->appendInstrument(symbol, book->instrument());
+    }
+    order_books_[symbol] = std::move(book);
+    return BookHandle(order_books_[symbol].get(), symbol);
+}
+
+template <typename Listener>
+std::vector<std::unique_ptr<OrderBook>> BasicMatchingEngine<Listener>::releaseBooks() {
+    std::vector<std::unique_ptr<OrderBook>> books;
+    for (auto& book : order_books_) {
+        if (book) {
+            books.push_back(std::move(book));
+        }
+    }
+    order_books_.clear();
+    return books;
+}
+
+template <typename Listener>
+OrderBook& BasicMatchingEngine<Listener>::createBook(SymbolId symbol,
+                                                     const InstrumentSpec& spec) {
+    if (symbol >= order_books_.size()) {
+        order_books_.resize(static_cast<size_t>(symbol) + 1);
+    }
+    order_books_[symbol] = std::make_unique<OrderBook>(spec);
+    order_books_[symbol]->trackLevelChanges(kLevelHook);
+    if (journal_) {
+        journal_->appendInstrument(symbol, spec);
+    }
+    return *order_books_[symbol];
+}
+
+template <typename Listener>
+void BasicMatchingEngine<Listener>::setRiskManager(std::shared_ptr<RiskManager> risk_manager) {
+    risk_manager_ = std::move(risk_manager);
+    
+    // Notional checks need the tick size of every known instrument
+    if (risk_manager_) {
+        for (const auto& book : order_books_) {
+            if (book) {
+                risk_manager_->setTickSize(book->symbol(), book->instrument().tick_size);
+            }
+        }
+    }
+}
+
+template <typename Listener>
+void BasicMatchingEngine<Listener>::setJournal(std::shared_ptr<OrderJournal> journal) {
+    journal_ = std::move(journal);
+    
+    // Replay needs the instrument behind every symbol id it will see
+    if (journal_) {
+        for (size_t id = 0; id < order_books_.size(); ++id) {
+            if (order_books_[id]) {
+                journal_->appendInstrument(static_cast<SymbolId>(id),
+                                           order_books_[id]->instrument());
+            }
+        }
+        journal_->commit();
+    }
+}
+
+template <typename Listener>
+uint64_t BasicMatchingEngine<Listener>::stateHash() const {
+    // A sum, so the result does not depend on the order books are visited in
+    uint64_t hash = 0;
+    for (const auto& book : order_books_) {
+        if (book) {
+            hash += symbolStateHash(*book, risk_manager_.get());
+        }
+    }
+    return hash;
+}
+
+template <typename Listener>
+uint64_t BasicMatchingEngine<Listener>::journalCheckpoint() {
+    uint64_t hash = stateHash();
+    if (journal_) {
+        journal_->append(JournalRecord::checkpoint(hash));
+        journal_->commit();
+    }
+    return hash;
+}
+
+template <typename Listener>
+template <bool Notify>
+void BasicMatchingEngine<Listener>::matchOrder(OrderBook& book, Order& order,
+                                               std::vector<Fill>& fills) {
+    // Market orders: use maximum/minimum price to match all available liquidity
+    Price limit_price = order.price;
+    if (order.type == OrderType::Market) {
+        limit_price = (order.side == Side::Buy) ? MAX_PRICE : MIN_PRICE;
+    }
+    
+    // Fill-or-kill: without enough liquidity within the limit the order is
+    // killed before it touches the book
+    if (order.type == OrderType::FOK && order.remaining_qty() > 0 &&
+        book.availableLiquidity(order.side, limit_price, order.remaining_qty()) <
+            order.remaining_qty()) {
+        order.cancel();
+        return;
+    }
+    
+    // Try to match against resting orders; fills go straight to the buffer
+    size_t first_fill = fills.size();
+    if (order.remaining_qty() > 0) {
+        book.executeFill(order.side, order.remaining_qty(), limit_price, order.id,
+            [&](const Fill& fill) {
+                order.apply_fill(fill.quantity);
+                fills.push_back(fill);
+            });
+    }
+    size_t end_fill = fills.size();
+    
+    // Handle remaining quantity based on order type
+    if (order.remaining_qty() > 0) {
+        switch (order.type) {
+            case OrderType::Limit:
+                // Add remaining to book
+                book.addOrder(order);
+                break;
+            
+            case OrderType::Market:
+                // Cancel remaining (couldn't fill at any price)
+                order.cancel();
+                break;
+            
+            case OrderType::IOC:
+                // Cancel remaining (immediate-or-cancel)
+                order.cancel();
+                break;
+            
+            case OrderType::FOK:
+                // Not reached: the liquidity check above guarantees a full fill
+                order.cancel();
+                break;
+        }
+    }
+    
+    // Notify and update positions once the order is fully placed, so
+    // listeners see the book a replay of the journal would produce and may
+    // call back into the engine
+    for (size_t i = first_fill; i < end_fill; ++i) {
+        const Fill fill = fills[i];
+        if constexpr (Notify) {
+            listener_.onFill(fill);
+        }
+        ++total_fills_;
+        
+        if (risk_manager_) {
+            risk_manager_->updatePosition(fill.symbol, fill.side,
+                                          fill.quantity, fill.price);
+        }
+    }
+}
+
+} // namespace trading
+
+#endif // TRADING_MATCHING_ENGINE_IMPL_HPP
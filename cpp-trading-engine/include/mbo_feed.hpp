@@ -0,0 +1,57 @@
+#ifndef TRADING_MBO_FEED_HPP
+#define TRADING_MBO_FEED_HPP
+
+#include "types.hpp"
+#include "spsc_ring.hpp"
+
+namespace trading {
+
+/**
+ * @brief Market-by-order event kinds (ITCH-style L3 feed)
+ */
+enum class MboEventType : uint8_t {
+    Add = 0,       // New resting order: price, displayed quantity
+    Modify = 1,    // Resting quantity changed in place: new remaining quantity
+    Delete = 2,    // Order removed by cancel (or by a price change, then re-added)
+    Execute = 3    // Resting order traded: executed quantity at its price
+};
+
+inline const char* to_string(MboEventType type) {
+    switch (type) {
+        case MboEventType::Add: return "ADD";
+        case MboEventType::Modify: return "MODIFY";
+        case MboEventType::Delete: return "DELETE";
+        case MboEventType::Execute: return "EXECUTE";
+        default: return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief One book change, 40 bytes, copied by value into the feed ring
+ *
+ * Sequence numbers are per book and have no gaps at the source, so a
+ * consumer that sees a jump knows events were dropped on a full ring.
+ * An Execute that takes an order's remaining quantity to zero removes
+ * it; no separate Delete follows.
+ */
+struct MboEvent {
+    uint64_t sequence = 0;
+    OrderId order_id = 0;
+    Price price = 0;
+    Quantity quantity = 0;
+    SymbolId symbol = INVALID_SYMBOL_ID;
+    MboEventType type = MboEventType::Add;
+    Side side = Side::Buy;
+};
+
+/**
+ * @brief Preallocated ring a book publishes its MBO events into
+ *
+ * The book is the single producer; one consumer (any thread) drains it
+ * in bulk with consume() or drain().
+ */
+using MboFeed = SpscRing<MboEvent>;
+
+} // namespace trading
+
+#endif // TRADING_MBO_FEED_HPP
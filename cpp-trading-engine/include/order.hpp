@@ -2,6 +2,7 @@
 #define TRADING_ORDER_HPP
 
 #include "types.hpp"
+#include "symbol_registry.hpp"
 #include <iostream>
 
 namespace trading {
@@ -14,10 +15,10 @@ namespace trading {
  */
 struct Order {
     OrderId id;              // Unique order identifier
-    Symbol symbol;           // Trading symbol (e.g., "AAPL")
+    SymbolId symbol;         // Interned trading symbol (see SymbolRegistry)
     Side side;               // Buy or Sell
     OrderType type;          // Order type (Limit, Market, etc.)
-    Price price;             // Limit price (0 for market orders)
+    Price price;             // Limit price in ticks (0 for market orders)
     Quantity quantity;       // Original order quantity
     Quantity filled_qty;     // Quantity already filled
     OrderStatus status;      // Current order status
@@ -26,10 +27,10 @@ struct Order {
     // Default constructor
     Order() 
         : id(0)
-        , symbol("")
+        , symbol(INVALID_SYMBOL_ID)
         , side(Side::Buy)
         , type(OrderType::Limit)
-        , price(0.0)
+        , price(0)
         , quantity(0)
         , filled_qty(0)
         , status(OrderStatus::New)
@@ -37,7 +38,7 @@ struct Order {
     {}
     
     // Parameterized constructor
-    Order(OrderId id, const Symbol& symbol, Side side, OrderType type,
+    Order(OrderId id, SymbolId symbol, Side side, OrderType type,
           Price price, Quantity quantity)
         : id(id)
         , symbol(symbol)
@@ -50,6 +51,26 @@ struct Order {
         , timestamp(std::chrono::steady_clock::now())
     {}
     
+    // Replay constructor: takes the timestamp instead of reading the clock
+    Order(OrderId id, SymbolId symbol, Side side, OrderType type,
+          Price price, Quantity quantity, Timestamp timestamp)
+        : id(id)
+        , symbol(symbol)
+        , side(side)
+        , type(type)
+        , price(price)
+        , quantity(quantity)
+        , filled_qty(0)
+        , status(OrderStatus::New)
+        , timestamp(timestamp)
+    {}
+    
+    // Gateway constructor: interns the symbol name
+    Order(OrderId id, const Symbol& symbol, Side side, OrderType type,
+          Price price, Quantity quantity)
+        : Order(id, internSymbol(symbol), side, type, price, quantity)
+    {}
+    
     // Get remaining quantity to be filled
     Quantity remaining_qty() const {
         return quantity - filled_qty;
@@ -95,13 +116,13 @@ struct Order {
 struct Fill {
     OrderId order_id;        // Order that was filled
     OrderId counter_order_id; // Counter-party order
-    Symbol symbol;           // Trading symbol
+    SymbolId symbol;         // Interned trading symbol
     Side side;               // Side of the aggressor order
-    Price price;             // Execution price
+    Price price;             // Execution price in ticks
     Quantity quantity;       // Executed quantity
     Timestamp timestamp;     // Execution time
     
-    Fill(OrderId order_id, OrderId counter_id, const Symbol& symbol,
+    Fill(OrderId order_id, OrderId counter_id, SymbolId symbol,
          Side side, Price price, Quantity quantity)
         : order_id(order_id)
         , counter_order_id(counter_id)
@@ -111,12 +132,23 @@ struct Fill {
         , quantity(quantity)
         , timestamp(std::chrono::steady_clock::now())
     {}
+    
+    Fill(OrderId order_id, OrderId counter_id, SymbolId symbol,
+         Side side, Price price, Quantity quantity, Timestamp timestamp)
+        : order_id(order_id)
+        , counter_order_id(counter_id)
+        , symbol(symbol)
+        , side(side)
+        , price(price)
+        , quantity(quantity)
+        , timestamp(timestamp)
+    {}
 };
 
 // Stream output for Order
 inline std::ostream& operator<<(std::ostream& os, const Order& order) {
     os << "Order{id=" << order.id 
-       << ", symbol=" << order.symbol
+       << ", symbol=" << symbolName(order.symbol)
        << ", side=" << to_string(order.side)
        << ", type=" << to_string(order.type)
        << ", price=" << order.price
@@ -131,7 +163,7 @@ inline std::ostream& operator<<(std::ostream& os, const Order& order) {
 inline std::ostream& operator<<(std::ostream& os, const Fill& fill) {
     os << "Fill{order_id=" << fill.order_id
        << ", counter_id=" << fill.counter_order_id
-       << ", symbol=" << fill.symbol
+       << ", symbol=" << symbolName(fill.symbol)
        << ", side=" << to_string(fill.side)
        << ", price=" << fill.price
        << ", qty=" << fill.quantity
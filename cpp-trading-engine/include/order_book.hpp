@@ -2,40 +2,39 @@
 #define TRADING_ORDER_BOOK_HPP
 
 #include "order.hpp"
-#include <map>
-#include <list>
-#include <unordered_map>
+#include "instrument.hpp"
+#include "price_ladder.hpp"
+#include "depth_cache.hpp"
+#include "mbo_feed.hpp"
+#include "level_update.hpp"
+#include "top_of_book.hpp"
+#include "order_pool.hpp"
+#include "order_index.hpp"
+#include "span.hpp"
+#include <algorithm>
 #include <optional>
 #include <vector>
 
 namespace trading {
 
-/**
- * @brief Represents a price level in the order book
- * 
- * Contains all orders at a specific price, maintaining FIFO order
- * for time priority.
- */
-struct PriceLevel {
-    Price price;
-    Quantity total_quantity;
-    std::list<Order> orders;  // FIFO queue for time priority
-    
-    PriceLevel(Price p = 0.0) : price(p), total_quantity(0) {}
-    
-    bool empty() const { return orders.empty(); }
-    size_t order_count() const { return orders.size(); }
-};
-
 /**
  * @brief Order book implementation with price-time priority
  * 
  * Maintains separate bid and ask sides with efficient order lookup
- * and price level management.
+ * and price level management. The level container for both sides is
+ * chosen by the instrument's BookLayout (see PriceLadder).
+ * 
+ * The top DepthCache::LEVELS levels of each side are kept aggregated and
+ * updated in place by every mutation, and version() advances whenever the
+ * book changes, so pollers can skip books they have already seen.
+ * 
+ * With an MboFeed attached, every change to a resting order is also
+ * published as an MboEvent for consumers on other threads.
  */
 class OrderBook {
 public:
     explicit OrderBook(const Symbol& symbol);
+    explicit OrderBook(const InstrumentSpec& spec);
     ~OrderBook() = default;
     
     // Non-copyable
@@ -83,15 +82,16 @@ public:
     
     /**
      * @brief Get the current spread
-     * @return Optional spread value, empty if no two-sided market
+     * @return Optional spread in ticks, empty if no two-sided market
      */
     std::optional<Price> getSpread() const;
     
     /**
      * @brief Get mid price
-     * @return Optional mid price, empty if no two-sided market
+     * @return Optional mid price in (possibly fractional) ticks,
+     *         empty if no two-sided market
      */
-    std::optional<Price> getMidPrice() const;
+    std::optional<double> getMidPrice() const;
     
     /**
      * @brief Get order by ID
@@ -103,56 +103,463 @@ public:
     /**
      * @brief Get multiple price levels from bid side
      * @param levels Number of levels to retrieve
-     * @return Vector of price levels
+     * @return Copies of the price levels, including their orders
+     * 
+     * Copies every resting order on the requested levels; market data
+     * consumers that only need aggregates should use getDepth/visitDepth.
      */
-    std::vector<PriceLevel> getBidLevels(size_t levels = 5) const;
+    std::vector<PriceLevelSnapshot> getBidLevels(size_t levels = 5) const;
     
     /**
      * @brief Get multiple price levels from ask side
      * @param levels Number of levels to retrieve
-     * @return Vector of price levels
+     * @return Copies of the price levels, including their orders
+     */
+    std::vector<PriceLevelSnapshot> getAskLevels(size_t levels = 5) const;
+    
+    /**
+     * @brief Copy aggregate depth (price, quantity, order count) for a side
+     * @param side Side::Buy for bids, Side::Sell for asks
+     * @param out Array of at least max_levels entries, filled best first
+     * @param max_levels Maximum number of levels to copy
+     * @return Number of levels written
+     */
+    size_t getDepth(Side side, DepthLevel* out, size_t max_levels) const;
+    
+    /**
+     * @brief Aggregate depth in a fixed-capacity array returned by value
+     * @tparam N Capacity (and default number of levels)
+     */
+    template <size_t N>
+    DepthLevels<N> getDepth(Side side, size_t max_levels = N) const {
+        DepthLevels<N> depth;
+        depth.count = getDepth(side, depth.levels.data(), std::min(max_levels, N));
+        return depth;
+    }
+    
+    /**
+     * @brief Visit aggregate depth for a side, best level first
+     * @param visit Called as visit(const DepthLevel&) for up to max_levels
+     *        levels; return false to stop early
+     * @return Number of levels visited
+     */
+    template <typename Visitor>
+    size_t visitDepth(Side side, size_t max_levels, Visitor&& visit) const {
+        size_t visited = 0;
+        if (max_levels == 0) {
+            return 0;
+        }
+        
+        // The cache holds every level if it is not full
+        const DepthCache& cache = depthCache(side);
+        if (max_levels <= DepthCache::LEVELS || !cache.full()) {
+            for (const DepthLevel& level : cache.levels()) {
+                ++visited;
+                if (!visit(level) || visited == max_levels) {
+                    break;
+                }
+            }
+            return visited;
+        }
+        
+        levels(side).forEach([&](const PriceLevel& level) {
+            ++visited;
+            bool more = visit(DepthLevel{level.price, level.total_quantity,
+                                         static_cast<uint32_t>(level.order_count())});
+            return more && visited < max_levels;
+        });
+        return visited;
+    }
+    
+    /**
+     * @brief Quantity an aggressor could fill at or better than a price,
+     *        without changing the book
+     * @param aggressor_side Side of the incoming order (Buy looks at asks)
+     * @param limit_price Limit price (0 for market orders)
+     * @param needed Stop counting once this much is found
+     * @return Available quantity, at most needed
+     *
+     * Walks the cached top levels first and the ladder only when the
+     * answer lies deeper, so a check that is covered near the touch costs
+     * a few cache-resident reads.
+     */
+    Quantity availableLiquidity(Side aggressor_side, Price limit_price, Quantity needed) const {
+        Side passive_side = (aggressor_side == Side::Buy) ? Side::Sell : Side::Buy;
+        auto within = [aggressor_side, limit_price](Price price) {
+            return limit_price <= 0 || (aggressor_side == Side::Buy ? price <= limit_price
+                                                                    : price >= limit_price);
+        };
+        
+        Quantity available = 0;
+        const DepthCache& cache = depthCache(passive_side);
+        for (const DepthLevel& level : cache.levels()) {
+            if (!within(level.price)) {
+                return available;
+            }
+            available += level.quantity;
+            if (available >= needed) {
+                return needed;
+            }
+        }
+        
+        // The cache holds every level unless it is full
+        if (!cache.full()) {
+            return available;
+        }
+        available = 0;
+        levels(passive_side).forEach([&](const PriceLevel& level) {
+            if (!within(level.price)) {
+                return false;
+            }
+            available += level.total_quantity;
+            return available < needed;
+        });
+        return std::min(available, needed);
+    }
+    
+    /**
+     * @brief Visit every level of a side, best first, with its orders
+     * @param visit Called as visit(const PriceLevel&); level.orders iterates
+     *        the resting orders in time priority
+     */
+    template <typename Visitor>
+    void visitLevels(Side side, Visitor&& visit) const {
+        levels(side).forEach([&visit](const PriceLevel& level) {
+            visit(level);
+            return true;
+        });
+    }
+    
+    /**
+     * @brief Bulk-load one price level (snapshot restore)
+     * @param orders Resting orders for the level in time priority; their
+     *        side and price are taken from the arguments
+     * @return false if the price is outside the ladder, an order has no
+     *         remaining quantity or its id is already in the book
+     * 
+     * Orders are appended behind any already at the level. Nothing is
+     * published and the depth cache is not touched until finishRestore(),
+     * so a whole book loads in time linear in its orders.
+     */
+    bool restoreLevel(Side side, Price price, Span<const Order> orders);
+    
+    /**
+     * @brief Rebuild the depth caches and publish the top of book after
+     *        restoreLevel() calls
+     */
+    void finishRestore();
+    
+    /**
+     * @brief Cached top-of-book depth for a side, best level first
+     */
+    const DepthLevels<DepthCache::LEVELS>& cachedDepth(Side side) const {
+        return depthCache(side).levels();
+    }
+    
+    /**
+     * @brief Best bid and offer, safe to read from other threads
+     * 
+     * Republished by the book's own thread whenever a top level changes;
+     * use read() / tryRead() from strategy or monitoring threads instead
+     * of getBestBid() and friends, which are only safe on the book's thread.
+     */
+    const TopOfBook& topOfBook() const { return top_; }
+    
+    /**
+     * @brief Book version; increases on every change to resting orders
+     */
+    uint64_t version() const { return version_; }
+    
+    /**
+     * @brief Publish market-by-order events into a ring
+     * @param feed Ring owned by the caller (must outlive the attachment),
+     *        or nullptr to stop publishing. The book is its only producer.
+     * 
+     * Publishing never blocks: if the ring is full the event is dropped
+     * and counted, and the consumer sees a sequence gap.
+     */
+    void attachFeed(MboFeed* feed) { feed_ = feed; }
+    MboFeed* feed() const { return feed_; }
+    
+    /**
+     * @brief Record which levels change, for market-by-price deltas
+     * @param enabled When false (the default) nothing is recorded
+     */
+    void trackLevelChanges(bool enabled) {
+        track_levels_ = enabled;
+        changed_levels_.clear();
+    }
+    
+    /**
+     * @brief Emit one update per level changed since the last flush
+     * @param sink Called as sink(const LevelUpdate&) with each level's
+     *        final aggregate state, in first-change order
+     * @return Number of updates emitted
+     * 
+     * However many orders were added, cancelled or traded at a level,
+     * only its final state is reported.
+     */
+    template <typename Sink>
+    size_t flushLevelUpdates(Sink&& sink) {
+        size_t emitted = changed_levels_.size();
+        for (const LevelUpdate& change : changed_levels_) {
+            LevelUpdate update = change;
+            update.symbol = symbol_id_;
+            sink(static_cast<const LevelUpdate&>(update));
+        }
+        changed_levels_.clear();
+        return emitted;
+    }
+    
+    size_t pendingLevelUpdates() const { return changed_levels_.size(); }
+    
+    /**
+     * @brief Stamp fills and re-priced orders with the current time
+     * @param enabled When false (journal replay) they get a zero timestamp
+     *        and the clock is never read
      */
-    std::vector<PriceLevel> getAskLevels(size_t levels = 5) const;
+    void setTimestamping(bool enabled) { timestamping_ = enabled; }
+    bool timestamping() const { return timestamping_; }
     
     /**
-     * @brief Execute a fill against the best price level
-     * @param side Side to execute against (opposite of aggressor)
+     * @brief Hash of the resting orders, in priority order on both sides
+     * 
+     * Covers every order's id, price, quantity and fills, so two books hash
+     * equal exactly when they would match future orders identically. It
+     * does not depend on the ladder layout, symbol id or process.
+     */
+    uint64_t stateHash() const;
+    
+    /**
+     * @brief Sequence number of the last event published
+     */
+    uint64_t feedSequence() const { return feed_sequence_; }
+    
+    /**
+     * @brief Events dropped because the ring was full
+     */
+    uint64_t feedDropped() const { return feed_dropped_; }
+    
+    /**
+     * @brief Match an aggressor against the opposite side of the book
+     * @param aggressor_side Side of the incoming order
      * @param quantity Maximum quantity to fill
      * @param limit_price Limit price (0 for market orders)
+     * @param aggressor_id Id of the incoming order
+     * @param sink Called as sink(const Fill&) for each fill, in match order
+     * @return Total quantity filled
+     * 
+     * Fills are handed to the sink as they are generated; nothing is
+     * allocated on this path once the book has reached its working size.
+     * The sweep is still in progress when the sink runs, so the sink must
+     * not read or modify this book; collect the fills and act on them
+     * once executeFill() returns.
+     */
+    template <typename Sink>
+    Quantity executeFill(Side aggressor_side, Quantity quantity,
+                         Price limit_price, OrderId aggressor_id, Sink&& sink) {
+        Quantity remaining = quantity;
+        
+        // All fills of one aggressor share a match time, read at the first fill
+        Timestamp match_time{};
+        bool stamped = !timestamping_;
+        
+        // Buy orders match against the ask side, sell orders against the bids
+        Side passive_side = (aggressor_side == Side::Buy) ? Side::Sell : Side::Buy;
+        auto& ladder = levels(passive_side);
+        
+        while (remaining > 0) {
+            PriceLevel* best = ladder.best();
+            if (!best) {
+                break;
+            }
+            auto& level = *best;
+            
+            // Check price limit
+            if (limit_price > 0) {
+                bool outside = (aggressor_side == Side::Buy) ? level.price > limit_price
+                                                             : level.price < limit_price;
+                if (outside) {
+                    break;
+                }
+            }
+            
+            // Match against orders at this price level
+            while (remaining > 0 && !level.orders.empty()) {
+                OrderNode* passive_node = level.orders.front();
+                auto& passive_order = passive_node->order;
+                
+                Quantity fill_qty = std::min(remaining, passive_order.remaining_qty());
+                
+                // Update passive order
+                passive_order.apply_fill(fill_qty);
+                level.total_quantity -= fill_qty;
+                remaining -= fill_qty;
+                
+                publish(MboEventType::Execute, passive_order.id, passive_side,
+                        level.price, fill_qty);
+                if (!stamped) {
+                    match_time = std::chrono::steady_clock::now();
+                    stamped = true;
+                }
+                sink(Fill(aggressor_id, passive_order.id, symbol_id_,
+                          aggressor_side, level.price, fill_qty, match_time));
+                
+                // Remove filled order
+                if (passive_order.is_filled()) {
+                    OrderId filled_id = passive_order.id;
+                    level.orders.pop_front();
+                    order_pool_.release(passive_node);
+                    order_lookup_.erase(filled_id);
+                    --sideCount(passive_side);
+                }
+            }
+            
+            // Remove empty price level
+            Price level_price = level.price;
+            bool emptied = level.orders.empty();
+            if (emptied) {
+                ladder.erase(level_price);
+            }
+            levelChanged(passive_side, level_price, emptied ? nullptr : &level);
+        }
+        
+        if (remaining != quantity) {
+            ++version_;
+            publishTop();
+        }
+        return quantity - remaining;
+    }
+    
+    /**
+     * @brief Match an aggressor, appending fills to a caller-owned buffer
+     * @param fills Buffer the fills are appended to (not cleared); reusing
+     *        one buffer across calls avoids allocating per order
+     * @return Total quantity filled
+     */
+    Quantity executeFill(Side aggressor_side, Quantity quantity,
+                         Price limit_price, OrderId aggressor_id,
+                         std::vector<Fill>& fills);
+    
+    /**
+     * @brief Match an aggressor and return its fills in a new vector
      * @return Vector of fills generated
      */
     std::vector<Fill> executeFill(Side aggressor_side, Quantity quantity, 
                                   Price limit_price, OrderId aggressor_id);
     
     // Accessors
-    const Symbol& symbol() const { return symbol_; }
-    size_t bidOrderCount() const { return bid_orders_.size(); }
-    size_t askOrderCount() const { return ask_orders_.size(); }
+    const Symbol& symbol() const { return spec_.symbol; }
+    SymbolId symbolId() const { return symbol_id_; }
+    const InstrumentSpec& instrument() const { return spec_; }
+    size_t bidOrderCount() const { return bid_count_; }
+    size_t askOrderCount() const { return ask_count_; }
     size_t totalOrderCount() const { return order_lookup_.size(); }
+    size_t levelCount(Side side) const { return levels(side).levelCount(); }
     
+    /**
+     * @brief Pre-allocate order storage for the expected resting depth
+     * @param orders Number of additional resting orders to make room for
+     */
+    void reserveOrders(size_t orders) {
+        order_pool_.reserve(orders);
+        order_lookup_.reserve(order_lookup_.size() + orders);
+    }
+
 private:
-    Symbol symbol_;
+    InstrumentSpec spec_;
+    SymbolId symbol_id_;
+    
+    // Bid side: best (highest) price first
+    PriceLadder bid_levels_;
+    
+    // Ask side: best (lowest) price first
+    PriceLadder ask_levels_;
+    
+    // Storage for resting orders, recycled through a free list
+    OrderPool order_pool_;
+    
+    // Order ID to node lookup for O(1) cancel; nodes know their level
+    OrderIndex order_lookup_;
+    
+    // Resting order counts by side
+    size_t bid_count_ = 0;
+    size_t ask_count_ = 0;
+    
+    // Aggregated top levels per side and the change counter
+    DepthCache bid_depth_{Side::Buy};
+    DepthCache ask_depth_{Side::Sell};
+    uint64_t version_ = 0;
+    
+    // Read the clock for fills and re-priced orders
+    bool timestamping_ = true;
+    
+    // Levels changed since the last flush (only while tracking)
+    bool track_levels_ = false;
+    LevelChangeSet changed_levels_;
+    
+    // Keep the depth cache and change set in step with a level
+    void levelChanged(Side side, Price price, const PriceLevel* level) {
+        depthCache(side).update(levels(side), price, level);
+        if (track_levels_) {
+            changed_levels_.record(side, price, level ? level->total_quantity : 0,
+                                   level ? static_cast<uint32_t>(level->order_count()) : 0);
+        }
+    }
+    
+    // Cross-thread best bid and offer
+    TopOfBook top_;
+    
+    // Republish the top of book if either best level changed
+    void publishTop() {
+        const auto& bids = bid_depth_.levels();
+        const auto& asks = ask_depth_.levels();
+        top_.publish(bids.count ? bids[0].price : 0, bids.count ? bids[0].quantity : 0,
+                     asks.count ? asks[0].price : 0, asks.count ? asks[0].quantity : 0);
+    }
+    
+    // Market-by-order publishing (optional)
+    MboFeed* feed_ = nullptr;
+    uint64_t feed_sequence_ = 0;
+    uint64_t feed_dropped_ = 0;
+    
+    void publish(MboEventType type, OrderId order_id, Side side,
+                 Price price, Quantity quantity) {
+        if (!feed_) {
+            return;
+        }
+        MboEvent event;
+        event.sequence = ++feed_sequence_;
+        event.order_id = order_id;
+        event.price = price;
+        event.quantity = quantity;
+        event.symbol = symbol_id_;
+        event.type = type;
+        event.side = side;
+        if (!feed_->tryPush(event)) {
+            ++feed_dropped_;
+        }
+    }
     
-    // Bid side: sorted by price descending (highest first)
-    std::map<Price, PriceLevel, std::greater<Price>> bid_levels_;
+    PriceLadder& levels(Side side) {
+        return side == Side::Buy ? bid_levels_ : ask_levels_;
+    }
     
-    // Ask side: sorted by price ascending (lowest first)
-    std::map<Price, PriceLevel> ask_levels_;
+    const PriceLadder& levels(Side side) const {
+        return side == Side::Buy ? bid_levels_ : ask_levels_;
+    }
     
-    // Order ID to iterator lookup for O(1) cancel
-    struct OrderLocation {
-        Side side;
-        Price price;
-        std::list<Order>::iterator iter;
-    };
-    std::unordered_map<OrderId, OrderLocation> order_lookup_;
+    DepthCache& depthCache(Side side) {
+        return side == Side::Buy ? bid_depth_ : ask_depth_;
+    }
     
-    // Order tracking by side
-    std::unordered_map<OrderId, Order*> bid_orders_;
-    std::unordered_map<OrderId, Order*> ask_orders_;
+    const DepthCache& depthCache(Side side) const {
+        return side == Side::Buy ? bid_depth_ : ask_depth_;
+    }
     
-    // Helper to clean up empty price levels
-    void cleanupLevel(Side side, Price price);
+    size_t& sideCount(Side side) {
+        return side == Side::Buy ? bid_count_ : ask_count_;
+    }
     
     // Helper to validate order parameters
     bool isValidOrder(const Order& order) const;
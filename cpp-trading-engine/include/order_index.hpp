@@ -0,0 +1,147 @@
+#ifndef TRADING_ORDER_INDEX_HPP
+#define TRADING_ORDER_INDEX_HPP
+
+#include "types.hpp"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace trading {
+
+struct OrderNode;
+
+/**
+ * @brief Flat open-addressing map from OrderId to resting order node
+ *
+ * Robin Hood hashing over a power-of-two slot array: on insert an entry
+ * that is further from its home slot takes the place of a closer one, so
+ * probe lengths stay short and lookups can stop early. Erase uses backward
+ * shift deletion instead of tombstones, so long cancel-heavy runs never
+ * degrade lookups or force a cleanup rehash. Slots are 16 bytes (id and
+ * node pointer), four to a cache line, and nothing is allocated per entry.
+ */
+class OrderIndex {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+    
+    explicit OrderIndex(size_t capacity = DEFAULT_CAPACITY) {
+        rehash(capacity);
+    }
+    
+    /**
+     * @brief Look up the node for an order
+     * @return Node pointer, nullptr if the order is not indexed
+     */
+    OrderNode* find(OrderId id) const {
+        size_t pos = home(id);
+        for (size_t dist = 0;; ++dist, pos = (pos + 1) & mask_) {
+            const Slot& slot = slots_[pos];
+            if (!slot.node || probeDistance(slot.id, pos) < dist) {
+                return nullptr;
+            }
+            if (slot.id == id) {
+                return slot.node;
+            }
+        }
+    }
+    
+    bool contains(OrderId id) const { return find(id) != nullptr; }
+    
+    /**
+     * @brief Index a new order
+     * @return false if the id is already present
+     */
+    bool insert(OrderId id, OrderNode* node) {
+        if ((size_ + 1) * MAX_LOAD_DEN > slots_.size() * MAX_LOAD_NUM) {
+            rehash(slots_.size() * 2);
+        }
+        
+        Slot entry{id, node};
+        size_t pos = home(id);
+        for (size_t dist = 0;; ++dist, pos = (pos + 1) & mask_) {
+            Slot& slot = slots_[pos];
+            if (!slot.node) {
+                slot = entry;
+                ++size_;
+                return true;
+            }
+            if (slot.id == entry.id) {
+                return false;
+            }
+            
+            // Rob the richer entry: it continues probing in our place
+            size_t existing = probeDistance(slot.id, pos);
+            if (existing < dist) {
+                std::swap(slot, entry);
+                dist = existing;
+            }
+        }
+    }
+    
+    /**
+     * @brief Remove an order from the index
+     * @return false if the id was not present
+     */
+    bool erase(OrderId id) {
+        size_t pos = home(id);
+        for (size_t dist = 0;; ++dist, pos = (pos + 1) & mask_) {
+            Slot& slot = slots_[pos];
+            if (!slot.node || probeDistance(slot.id, pos) < dist) {
+                return false;
+            }
+            if (slot.id == id) {
+                break;
+            }
+        }
+        
+        // Backward shift: pull displaced followers one slot closer to home
+        size_t next = (pos + 1) & mask_;
+        while (slots_[next].node && probeDistance(slots_[next].id, next) > 0) {
+            slots_[pos] = slots_[next];
+            pos = next;
+            next = (next + 1) & mask_;
+        }
+        slots_[pos] = Slot{};
+        --size_;
+        return true;
+    }
+    
+    /**
+     * @brief Size the table for n entries without exceeding the load limit
+     */
+    void reserve(size_t entries);
+    
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    struct Slot {
+        OrderId id = 0;
+        OrderNode* node = nullptr;  // nullptr marks an empty slot
+    };
+    
+    // Grow when more than 7/8 of the slots are in use
+    static constexpr size_t MAX_LOAD_NUM = 7;
+    static constexpr size_t MAX_LOAD_DEN = 8;
+    
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    unsigned shift_ = 0;
+    size_t size_ = 0;
+    
+    // Fibonacci hashing spreads sequential ids across the table
+    size_t home(OrderId id) const {
+        return static_cast<size_t>((id * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+    
+    size_t probeDistance(OrderId id, size_t pos) const {
+        return (pos - home(id)) & mask_;
+    }
+    
+    void rehash(size_t capacity);
+};
+
+} // namespace trading
+
+#endif // TRADING_ORDER_INDEX_HPP
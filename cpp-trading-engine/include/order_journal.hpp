@@ -0,0 +1,348 @@
+#ifndef TRADING_ORDER_JOURNAL_HPP
+#define TRADING_ORDER_JOURNAL_HPP
+
+#include "order.hpp"
+#include "instrument.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief Kinds of inbound command recorded in the journal
+ */
+enum class CommandType : uint8_t {
+    Submit = 1,       // New order: every Order field needed to re-submit it
+    Cancel = 2,       // Cancel order_id in symbol
+    Modify = 3,       // Modify order_id: price / quantity (0 keeps current)
+    Instrument = 4,   // Book created: symbol id, name and spec in the payload
+    Reject = 5,       // The command whose sequence is in quantity was not applied
+                      // (risk failed the Submit, or its commit failed)
+    Checkpoint = 6    // Engine state hash (in order_id) after every earlier command
+};
+
+inline const char* to_string(CommandType type) {
+    switch (type) {
+        case CommandType::Submit: return "SUBMIT";
+        case CommandType::Cancel: return "CANCEL";
+        case CommandType::Modify: return "MODIFY";
+        case CommandType::Instrument: return "INSTRUMENT";
+        case CommandType::Reject: return "REJECT";
+        case CommandType::Checkpoint: return "CHECKPOINT";
+        default: return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief One journal entry, 48 bytes, written to disk as is
+ *
+ * Instrument records are followed by payload_size bytes: a
+ * JournalInstrument and then the symbol name. Symbol ids are those of the
+ * writing process; the Instrument records map them back to names.
+ */
+struct JournalRecord {
+    uint64_t sequence = 0;     // 1, 2, 3, ... across the whole journal
+    OrderId order_id = 0;
+    Price price = 0;
+    Quantity quantity = 0;
+    SymbolId symbol = INVALID_SYMBOL_ID;
+    CommandType type = CommandType::Submit;
+    Side side = Side::Buy;
+    OrderType order_type = OrderType::Limit;
+    uint8_t reserved = 0;
+    uint32_t payload_size = 0;
+    uint32_t checksum = 0;     // Over the record (this field zeroed) and payload
+    
+    static JournalRecord submit(const Order& order);
+    static JournalRecord cancel(SymbolId symbol, OrderId order_id);
+    static JournalRecord modify(SymbolId symbol, OrderId order_id,
+                                Price new_price, Quantity new_quantity);
+    static JournalRecord reject(SymbolId symbol, OrderId order_id, uint64_t submit_sequence);
+    static JournalRecord checkpoint(uint64_t state_hash);
+    
+    /**
+     * @brief Rebuild the submitted order (Submit records only)
+     */
+    Order toOrder() const {
+        return Order(order_id, symbol, side, order_type, price, quantity);
+    }
+    
+    /**
+     * @brief Rebuild the submitted order without reading the clock
+     */
+    Order toOrder(Timestamp timestamp) const {
+        return Order(order_id, symbol, side, order_type, price, quantity, timestamp);
+    }
+    
+    /**
+     * @brief Sequence of the command a Reject record refers to
+     */
+    uint64_t rejectedSequence() const { return static_cast<uint64_t>(quantity); }
+    
+    /**
+     * @brief State hash recorded by a Checkpoint record
+     */
+    uint64_t stateHash() const { return order_id; }
+};
+
+static_assert(sizeof(JournalRecord) == 48, "JournalRecord is a fixed 48-byte record");
+
+/**
+ * @brief Fixed part of an Instrument record's payload
+ */
+struct JournalInstrument {
+    double tick_size;
+    int32_t price_decimals;
+    BookLayout layout;
+    uint8_t reserved[3];
+    Price band_low;
+    Price band_ticks;
+};
+
+/**
+ * @brief When a commit also forces the journal to stable storage
+ */
+enum class FsyncPolicy : uint8_t {
+    None = 0,        // Leave flushing to the OS (survives a process crash only)
+    PerBatch = 1,    // fdatasync on every commit
+    Periodic = 2     // fdatasync on a commit once sync_interval has passed
+};
+
+struct JournalOptions {
+    FsyncPolicy fsync = FsyncPolicy::PerBatch;
+    
+    // Commit automatically once this many commands are buffered. 1 makes
+    // every command durable before the engine acts on it; larger groups
+    // trade that for fewer writes (see flushIdle()).
+    size_t group_size = 1;
+    
+    // Longest time between fdatasyncs under FsyncPolicy::Periodic
+    std::chrono::microseconds sync_interval{1000};
+    
+    // Initial size of the in-memory group buffer
+    size_t buffer_bytes = 64 * 1024;
+};
+
+/**
+ * @brief Append-only binary write-ahead journal of inbound commands
+ *
+ * Commands are appended to an in-memory buffer and written out in groups:
+ * one write(2), and under the fsync policy at most one fdatasync, covers
+ * every command buffered since the last commit. A group is committed when
+ * it reaches group_size commands, when commit() is called, and (through
+ * the engine) before a batch submission is processed. The journal is
+ * written by the engine's thread only.
+ *
+ * Nothing is flushed on a timer. With group_size > 1 the tail of a burst
+ * stays in memory, and under FsyncPolicy::Periodic the last groups
+ * written stay unsynced, until the next commit; whoever drives the engine
+ * calls flushIdle() when its input goes quiet (EngineLoop and
+ * EnginePipeline do).
+ *
+ * Opening an existing journal continues its sequence after the last
+ * complete record; a torn record left by a crash is cut off.
+ *
+ * A write or sync that fails latches failed(). Nothing buffered is
+ * dropped: every later commit() retries what has not been written (and
+ * the sync), and clears failed() once it all succeeds. The engine refuses
+ * new commands while its journal has failed.
+ */
+class OrderJournal {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    
+    // Bytes before the first record: magic, version and record size
+    static constexpr size_t HEADER_BYTES = 16;
+    
+    // Longest symbol name an Instrument record carries, and so the largest
+    // payload a reader accepts before it has checked the checksum
+    static constexpr size_t MAX_SYMBOL_BYTES = 4096;
+    static constexpr size_t MAX_PAYLOAD_BYTES = sizeof(JournalInstrument) + MAX_SYMBOL_BYTES;
+    
+    OrderJournal() = default;
+    ~OrderJournal();
+    
+    // Non-copyable (owns a file descriptor)
+    OrderJournal(const OrderJournal&) = delete;
+    OrderJournal& operator=(const OrderJournal&) = delete;
+    
+    /**
+     * @brief Open (or create) a journal file for appending
+     * @return false if the file cannot be opened or is not a journal
+     */
+    bool open(const std::string& path, const JournalOptions& options = JournalOptions());
+    
+    /**
+     * @brief Commit, sync (unless FsyncPolicy::None) and close
+     */
+    void close();
+    
+    bool isOpen() const { return fd_ >= 0; }
+    
+    /**
+     * @brief Buffer one command, committing if the group is full
+     * @return Sequence number assigned to the command
+     */
+    uint64_t append(JournalRecord record) {
+        record.sequence = ++sequence_;
+        record.payload_size = 0;
+        record.checksum = 0;
+        record.checksum = checksum(&record, sizeof(record), nullptr, 0);
+        buffer(&record, sizeof(record));
+        end_offset_ += sizeof(record);
+        if (++pending_ >= options_.group_size) {
+            commit();
+        }
+        return record.sequence;
+    }
+    
+    /**
+     * @brief Record that a book was created, with the spec to recreate it
+     * @return Sequence number, or 0 if the symbol name is longer than
+     *         MAX_SYMBOL_BYTES; the journal is then failed() for good,
+     *         since replay could not map the symbol
+     */
+    uint64_t appendInstrument(SymbolId symbol, const InstrumentSpec& spec);
+    
+    /**
+     * @brief Write out everything buffered, then sync per the fsync policy
+     * @return false if the write or sync failed (see failed())
+     */
+    bool commit();
+    
+    /**
+     * @brief Commit and force the journal to stable storage now
+     */
+    bool sync();
+    
+    /**
+     * @brief Commit, then sync anything written but not yet synced
+     *        (unless FsyncPolicy::None)
+     * 
+     * For when the command stream goes idle: closes the loss window of a
+     * partial group or a Periodic sync still waiting for its interval.
+     * Costs a comparison when there is nothing to do.
+     */
+    bool flushIdle();
+    
+    /**
+     * @brief Sequence number of the last command appended
+     */
+    uint64_t sequence() const { return sequence_; }
+    
+    /**
+     * @brief Sequence number of the last command written out by commit()
+     */
+    uint64_t committedSequence() const { return committed_sequence_; }
+    
+    /**
+     * @brief File offset just past the last command appended
+     *
+     * With sequence(), where a reader resumes to see only later commands.
+     */
+    uint64_t endOffset() const { return end_offset_; }
+    
+    /**
+     * @brief True from a failed write or sync until a commit() succeeds,
+     *        and for good once an Instrument record could not be written
+     */
+    bool failed() const { return failed_ || unrecorded_; }
+    
+    size_t pendingCommands() const { return pending_; }
+    uint64_t commits() const { return commits_; }
+    uint64_t syncs() const { return syncs_; }
+    uint64_t bytesWritten() const { return bytes_written_; }
+    
+    const JournalOptions& options() const { return options_; }
+    
+    static uint32_t checksum(const void* record, size_t record_size,
+                             const void* payload, size_t payload_size);
+
+private:
+    int fd_ = -1;
+    JournalOptions options_;
+    
+    std::vector<char> buffer_;
+    size_t pending_ = 0;
+    bool failed_ = false;
+    bool unrecorded_ = false;   // A symbol name too long to journal
+    
+    uint64_t sequence_ = 0;
+    uint64_t committed_sequence_ = 0;
+    uint64_t synced_sequence_ = 0;
+    uint64_t end_offset_ = 0;
+    std::chrono::steady_clock::time_point last_sync_;
+    
+    uint64_t commits_ = 0;
+    uint64_t syncs_ = 0;
+    uint64_t bytes_written_ = 0;
+    
+    void buffer(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+    
+    bool syncFile();
+};
+
+/**
+ * @brief Sequential reader over a journal file
+ *
+ * Stops at the end of the file or at the first incomplete or corrupt
+ * record (the torn tail of a crash); truncated() tells the two apart.
+ */
+class JournalReader {
+public:
+    JournalReader() = default;
+    ~JournalReader();
+    
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+    
+    /**
+     * @brief Open a journal for reading
+     * @return false if it cannot be opened or has a bad header
+     */
+    bool open(const std::string& path);
+    
+    /**
+     * @brief Read the next record
+     * @param record Filled with the record
+     * @param spec Filled with the instrument for Instrument records
+     * @return false at the end of the valid journal
+     */
+    bool next(JournalRecord& record, InstrumentSpec& spec);
+    
+    /**
+     * @brief Continue reading at a record boundary
+     * @param offset File offset of the next record (an earlier endOffset())
+     * @param last_sequence Sequence of the record before it
+     * @return false if the reader is not open or the file ends before offset
+     */
+    bool seek(uint64_t offset, uint64_t last_sequence);
+    
+    /**
+     * @brief Byte offset just past the last valid record read
+     */
+    uint64_t validBytes() const { return offset_; }
+    
+    /**
+     * @brief True if reading stopped at a partial or corrupt record
+     */
+    bool truncated() const { return truncated_; }
+
+private:
+    std::FILE* file_ = nullptr;
+    uint64_t offset_ = 0;
+    uint64_t last_sequence_ = 0;
+    bool truncated_ = false;
+    std::vector<char> payload_;
+    
+    bool checksumMatches(const JournalRecord& record, uint32_t stored) const;
+};
+
+} // namespace trading
+
+#endif // TRADING_ORDER_JOURNAL_HPP
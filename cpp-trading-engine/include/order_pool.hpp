@@ -0,0 +1,193 @@
+#ifndef TRADING_ORDER_POOL_HPP
+#define TRADING_ORDER_POOL_HPP
+
+#include "order.hpp"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace trading {
+
+struct PriceLevel;
+
+/**
+ * @brief Resting order with intrusive links for its price level queue
+ */
+struct OrderNode {
+    Order order;
+    PriceLevel* level = nullptr;   // Level the node is queued on
+    OrderNode* prev = nullptr;
+    OrderNode* next = nullptr;
+};
+
+/**
+ * @brief Slab allocator for order nodes with free-list recycling
+ *
+ * Nodes are carved out of fixed-size slabs that are never returned to the
+ * heap while the pool lives, so node addresses are stable and a book that
+ * has reached its working size allocates nothing for new orders.
+ */
+class OrderPool {
+public:
+    static constexpr size_t DEFAULT_SLAB_SIZE = 1024;
+    
+    explicit OrderPool(size_t slab_size = DEFAULT_SLAB_SIZE)
+        : slab_size_(slab_size > 0 ? slab_size : DEFAULT_SLAB_SIZE) {}
+    
+    // Non-copyable (nodes are referenced by address)
+    OrderPool(const OrderPool&) = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
+    
+    // Movable
+    OrderPool(OrderPool&&) = default;
+    OrderPool& operator=(OrderPool&&) = default;
+    
+    /**
+     * @brief Take a node from the free list and copy an order into it
+     * @param order The order to store
+     * @return Unlinked node holding the order
+     */
+    OrderNode* acquire(const Order& order) {
+        if (!free_list_) {
+            grow();
+        }
+        OrderNode* node = free_list_;
+        free_list_ = node->next;
+        node->order = order;
+        node->level = nullptr;
+        node->prev = nullptr;
+        node->next = nullptr;
+        ++in_use_;
+        return node;
+    }
+    
+    /**
+     * @brief Return a node to the free list
+     * @param node Node previously obtained from acquire()
+     */
+    void release(OrderNode* node) {
+        node->next = free_list_;
+        free_list_ = node;
+        --in_use_;
+    }
+    
+    /**
+     * @brief Pre-allocate slabs so that at least n nodes are available
+     */
+    void reserve(size_t nodes);
+    
+    size_t capacity() const { return capacity_; }
+    size_t inUse() const { return in_use_; }
+    size_t slabCount() const { return slabs_.size(); }
+
+private:
+    std::vector<std::unique_ptr<OrderNode[]>> slabs_;
+    OrderNode* free_list_ = nullptr;
+    size_t slab_size_;
+    size_t capacity_ = 0;
+    size_t in_use_ = 0;
+    
+    // Allocate one more slab and thread it onto the free list
+    void grow();
+};
+
+/**
+ * @brief FIFO queue of pooled order nodes (time priority within a level)
+ *
+ * Links live in the nodes themselves, so push, pop and erase of an
+ * arbitrary node are O(1) and never allocate. The queue does not own its
+ * nodes; the book returns them to its OrderPool.
+ */
+class OrderQueue {
+public:
+    OrderQueue() = default;
+    
+    // Non-copyable (would alias the same nodes)
+    OrderQueue(const OrderQueue&) = delete;
+    OrderQueue& operator=(const OrderQueue&) = delete;
+    
+    OrderQueue(OrderQueue&& other) noexcept
+        : head_(other.head_), tail_(other.tail_), size_(other.size_) {
+        other.head_ = other.tail_ = nullptr;
+        other.size_ = 0;
+    }
+    
+    OrderQueue& operator=(OrderQueue&& other) noexcept {
+        head_ = other.head_;
+        tail_ = other.tail_;
+        size_ = other.size_;
+        other.head_ = other.tail_ = nullptr;
+        other.size_ = 0;
+        return *this;
+    }
+    
+    bool empty() const { return head_ == nullptr; }
+    size_t size() const { return size_; }
+    
+    OrderNode* front() const { return head_; }
+    OrderNode* back() const { return tail_; }
+    
+    void push_back(OrderNode* node) {
+        node->prev = tail_;
+        node->next = nullptr;
+        if (tail_) {
+            tail_->next = node;
+        } else {
+            head_ = node;
+        }
+        tail_ = node;
+        ++size_;
+    }
+    
+    void pop_front() { erase(head_); }
+    
+    void erase(OrderNode* node) {
+        if (node->prev) {
+            node->prev->next = node->next;
+        } else {
+            head_ = node->next;
+        }
+        if (node->next) {
+            node->next->prev = node->prev;
+        } else {
+            tail_ = node->prev;
+        }
+        node->prev = node->next = nullptr;
+        --size_;
+    }
+    
+    /**
+     * @brief Forward iterator over the queued orders
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Order;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Order*;
+        using reference = const Order&;
+        
+        explicit const_iterator(const OrderNode* node) : node_(node) {}
+        const Order& operator*() const { return node_->order; }
+        const Order* operator->() const { return &node_->order; }
+        const_iterator& operator++() { node_ = node_->next; return *this; }
+        bool operator==(const const_iterator& other) const { return node_ == other.node_; }
+        bool operator!=(const const_iterator& other) const { return node_ != other.node_; }
+    
+    private:
+        const OrderNode* node_;
+    };
+    
+    const_iterator begin() const { return const_iterator(head_); }
+    const_iterator end() const { return const_iterator(nullptr); }
+
+private:
+    OrderNode* head_ = nullptr;
+    OrderNode* tail_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace trading
+
+#endif // TRADING_ORDER_POOL_HPP
@@ -0,0 +1,138 @@
+#ifndef TRADING_PRICE_BITMAP_HPP
+#define TRADING_PRICE_BITMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace trading {
+
+// Index of the lowest set bit; bits must be non-zero
+inline unsigned countTrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+/**
+ * @brief Three-level occupancy bitmap over price tick slots
+ *
+ * Level 0 holds one bit per slot, level 1 one bit per non-empty level-0
+ * word and level 2 one bit per non-empty level-1 word, so a single level-2
+ * word summarizes 64^3 = 262144 slots. findNext() locates the next occupied
+ * slot with at most one find-first-set per level instead of walking empty
+ * ticks.
+ */
+class PriceBitmap {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    
+    PriceBitmap() : size_(0) {}
+    
+    explicit PriceBitmap(size_t size)
+        : size_(size)
+        , level0_(wordsFor(size), 0)
+        , level1_(wordsFor(level0_.size()), 0)
+        , level2_(wordsFor(level1_.size()), 0)
+    {}
+    
+    size_t size() const { return size_; }
+    
+    bool test(size_t index) const {
+        return (level0_[index >> 6] >> (index & 63)) & 1;
+    }
+    
+    void set(size_t index) {
+        size_t w0 = index >> 6;
+        size_t w1 = w0 >> 6;
+        level0_[w0] |= bit(index);
+        level1_[w1] |= bit(w0);
+        level2_[w1 >> 6] |= bit(w1);
+    }
+    
+    void clear(size_t index) {
+        size_t w0 = index >> 6;
+        level0_[w0] &= ~bit(index);
+        if (level0_[w0] != 0) {
+            return;
+        }
+        size_t w1 = w0 >> 6;
+        level1_[w1] &= ~bit(w0);
+        if (level1_[w1] != 0) {
+            return;
+        }
+        level2_[w1 >> 6] &= ~bit(w1);
+    }
+    
+    /**
+     * @brief Find the first occupied slot at or after an index
+     * @param from Index to start searching from
+     * @return Slot index, or npos if no slot at or after from is set
+     */
+    size_t findNext(size_t from) const {
+        if (from >= size_) {
+            return npos;
+        }
+        
+        // Remainder of the current level-0 word
+        size_t w0 = from >> 6;
+        uint64_t bits = level0_[w0] & (~uint64_t(0) << (from & 63));
+        if (bits) {
+            return (w0 << 6) | countTrailingZeros(bits);
+        }
+        
+        // Next non-empty level-0 word within the current level-1 word
+        size_t next0 = w0 + 1;
+        size_t w1 = next0 >> 6;
+        if (next0 < level0_.size()) {
+            bits = level1_[w1] & (~uint64_t(0) << (next0 & 63));
+            if (bits) {
+                return firstInWord((w1 << 6) | countTrailingZeros(bits));
+            }
+        }
+        
+        // Next non-empty level-1 word, scanning level-2 words linearly
+        size_t next1 = w1 + 1;
+        if (next1 >= level1_.size()) {
+            return npos;
+        }
+        size_t w2 = next1 >> 6;
+        bits = level2_[w2] & (~uint64_t(0) << (next1 & 63));
+        while (!bits) {
+            if (++w2 >= level2_.size()) {
+                return npos;
+            }
+            bits = level2_[w2];
+        }
+        size_t found1 = (w2 << 6) | countTrailingZeros(bits);
+        return firstInWord((found1 << 6) | countTrailingZeros(level1_[found1]));
+    }
+    
+    size_t findFirst() const { return findNext(0); }
+
+private:
+    size_t size_;
+    std::vector<uint64_t> level0_;
+    std::vector<uint64_t> level1_;
+    std::vector<uint64_t> level2_;
+    
+    static uint64_t bit(size_t index) { return uint64_t(1) << (index & 63); }
+    static size_t wordsFor(size_t bits) { return (bits + 63) / 64; }
+    
+    // First set slot of a known non-empty level-0 word
+    size_t firstInWord(size_t w0) const {
+        return (w0 << 6) | countTrailingZeros(level0_[w0]);
+    }
+};
+
+} // namespace trading
+
+#endif // TRADING_PRICE_BITMAP_HPP
@@ -0,0 +1,312 @@
+#ifndef TRADING_PRICE_LADDER_HPP
+#define TRADING_PRICE_LADDER_HPP
+
+#include "order.hpp"
+#include "instrument.hpp"
+#include "order_pool.hpp"
+#include "price_bitmap.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief Represents a price level in the order book
+ * 
+ * Contains all orders at a specific price, maintaining FIFO order
+ * for time priority. Orders are pooled nodes owned by the book.
+ */
+struct PriceLevel {
+    Price price;
+    Quantity total_quantity;
+    OrderQueue orders;  // FIFO queue for time priority
+    
+    PriceLevel(Price p = 0) : price(p), total_quantity(0) {}
+    
+    bool empty() const { return orders.empty(); }
+    size_t order_count() const { return orders.size(); }
+};
+
+/**
+ * @brief Copy of a price level and its orders, detached from the book
+ */
+struct PriceLevelSnapshot {
+    Price price;
+    Quantity total_quantity;
+    std::vector<Order> orders;  // In time priority
+    
+    explicit PriceLevelSnapshot(const PriceLevel& level)
+        : price(level.price)
+        , total_quantity(level.total_quantity)
+        , orders(level.orders.begin(), level.orders.end())
+    {}
+    
+    bool empty() const { return orders.empty(); }
+    size_t order_count() const { return orders.size(); }
+};
+
+/**
+ * @brief Aggregate view of one price level (L2 depth entry)
+ */
+struct DepthLevel {
+    Price price = 0;
+    Quantity quantity = 0;       // Total resting quantity at the price
+    uint32_t order_count = 0;    // Number of resting orders at the price
+};
+
+/**
+ * @brief Fixed-capacity depth ladder held by value (no heap allocation)
+ * @tparam N Maximum number of levels
+ */
+template <size_t N>
+struct DepthLevels {
+    std::array<DepthLevel, N> levels;
+    size_t count = 0;            // Levels actually filled, best first
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const DepthLevel& operator[](size_t index) const { return levels[index]; }
+    const DepthLevel* begin() const { return levels.data(); }
+    const DepthLevel* end() const { return levels.data() + count; }
+};
+
+/**
+ * @brief Free list of recycled tree nodes, shared by the copies of one
+ *        LevelNodeAllocator
+ *
+ * Blocks are taken from the heap only when the list is empty and go back
+ * to it when the node is freed, so a tree that has reached its working
+ * size allocates nothing for new levels.
+ */
+class NodeFreeList {
+public:
+    NodeFreeList() = default;
+    NodeFreeList(const NodeFreeList&) = delete;
+    NodeFreeList& operator=(const NodeFreeList&) = delete;
+    
+    ~NodeFreeList() {
+        while (head_) {
+            Block* next = head_->next;
+            ::operator delete(head_);
+            head_ = next;
+        }
+    }
+    
+    void* take(size_t bytes) {
+        if (head_ && bytes == block_size_) {
+            Block* block = head_;
+            head_ = block->next;
+            return block;
+        }
+        return ::operator new(bytes < sizeof(Block) ? sizeof(Block) : bytes);
+    }
+    
+    void give(void* ptr, size_t bytes) {
+        if (block_size_ == 0) {
+            block_size_ = bytes;
+        }
+        if (bytes != block_size_) {
+            ::operator delete(ptr);
+            return;
+        }
+        Block* block = static_cast<Block*>(ptr);
+        block->next = head_;
+        head_ = block;
+    }
+
+private:
+    struct Block {
+        Block* next;
+    };
+    
+    Block* head_ = nullptr;
+    size_t block_size_ = 0;    // Size of the blocks kept; others are freed
+};
+
+/**
+ * @brief Allocator recycling single nodes through a shared NodeFreeList
+ *
+ * Rebound copies (the tree allocates its node type, not value_type) share
+ * the list, and it lives until the last copy is gone.
+ */
+template <typename T>
+class LevelNodeAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    
+    LevelNodeAllocator() : free_(std::make_shared<NodeFreeList>()) {}
+    
+    // Copies share the list; there is no move, which would empty the source
+    LevelNodeAllocator(const LevelNodeAllocator& other) noexcept : free_(other.free_) {}
+    
+    template <typename U>
+    LevelNodeAllocator(const LevelNodeAllocator<U>& other) noexcept : free_(other.free_) {}
+    
+    T* allocate(size_t n) {
+        if (n == 1) {
+            return static_cast<T*>(free_->take(sizeof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    
+    void deallocate(T* ptr, size_t n) {
+        if (n == 1) {
+            free_->give(ptr, sizeof(T));
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+    
+    template <typename U>
+    bool operator==(const LevelNodeAllocator<U>& other) const { return free_ == other.free_; }
+    template <typename U>
+    bool operator!=(const LevelNodeAllocator<U>& other) const { return free_ != other.free_; }
+
+private:
+    template <typename U>
+    friend class LevelNodeAllocator;
+    
+    std::shared_ptr<NodeFreeList> free_;
+};
+
+/**
+ * @brief One side of an order book: price levels in priority order
+ *
+ * Two backends are available, chosen per instrument by BookLayout:
+ * - Map: an ordered tree keyed by price, accepting any price. Nodes of
+ *   erased levels are recycled for new ones (see LevelNodeAllocator).
+ * - Array: a contiguous vector of levels indexed by tick offset within a
+ *   fixed band, with the best occupied index tracked so best-price access,
+ *   level insert and level erase are O(1). A PriceBitmap over the slots
+ *   finds the next occupied level without walking empty ticks.
+ *
+ * Both backends index levels so that "lower key = better price": asks are
+ * keyed by price, bids by negated price (or the reversed tick offset).
+ * A level exists from insert() until erase(), which the book calls once
+ * the last order at that price has gone.
+ */
+class PriceLadder {
+public:
+    PriceLadder(Side side, const InstrumentSpec& spec);
+    
+    /**
+     * @brief Check whether a price can be stored on this ladder
+     */
+    bool accepts(Price price) const {
+        return layout_ == BookLayout::Map ||
+               (price >= band_low_ && price <= band_high_);
+    }
+    
+    /**
+     * @brief Best (highest bid / lowest ask) level, nullptr if empty
+     */
+    PriceLevel* best() {
+        if (layout_ == BookLayout::Array) {
+            return level_count_ ? &slots_[best_index_] : nullptr;
+        }
+        return map_levels_.empty() ? nullptr : &map_levels_.begin()->second;
+    }
+    
+    const PriceLevel* best() const {
+        return const_cast<PriceLadder*>(this)->best();
+    }
+    
+    /**
+     * @brief Find an existing level by price
+     * @return Pointer to the level, nullptr if there is none at that price
+     */
+    PriceLevel* find(Price price);
+    
+    /**
+     * @brief First occupied level strictly worse than a price
+     * @param price An accepted price (need not be occupied)
+     * @return Pointer to the level, nullptr if there is none
+     */
+    const PriceLevel* nextAfter(Price price) const;
+    
+    /**
+     * @brief Get the level for a price, creating it if needed
+     *
+     * The caller must add an order to the returned level before the next
+     * ladder operation. The price must satisfy accepts().
+     */
+    PriceLevel& insert(Price price);
+    
+    /**
+     * @brief Remove a level once its last order has gone
+     * @param price Price of the (now empty) level
+     */
+    void erase(Price price);
+    
+    /**
+     * @brief Visit occupied levels from best to worst
+     * @param visit Callable taking const PriceLevel&, returning false to stop
+     */
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        if (layout_ == BookLayout::Array) {
+            if (level_count_ == 0) {
+                return;
+            }
+            for (size_t i = best_index_; i != PriceBitmap::npos;
+                 i = occupied_.findNext(i + 1)) {
+                if (!visit(slots_[i])) {
+                    return;
+                }
+            }
+            return;
+        }
+        for (const auto& [key, level] : map_levels_) {
+            if (!visit(level)) {
+                return;
+            }
+        }
+    }
+    
+    bool empty() const { return levelCount() == 0; }
+    
+    size_t levelCount() const {
+        return layout_ == BookLayout::Array ? level_count_ : map_levels_.size();
+    }
+    
+    BookLayout layout() const { return layout_; }
+
+private:
+    Side side_;
+    BookLayout layout_;
+    
+    // Map backend: keyed so that begin() is the best price
+    std::map<Price, PriceLevel, std::less<Price>,
+             LevelNodeAllocator<std::pair<const Price, PriceLevel>>> map_levels_;
+    
+    // Array backend: slot 0 holds the best possible price in the band
+    std::vector<PriceLevel> slots_;
+    PriceBitmap occupied_;
+    Price band_low_;
+    Price band_high_;
+    size_t best_index_;
+    size_t level_count_;
+    
+    Price mapKey(Price price) const {
+        return side_ == Side::Buy ? -price : price;
+    }
+    
+    size_t slotIndex(Price price) const {
+        return static_cast<size_t>(side_ == Side::Buy ? band_high_ - price
+                                                      : price - band_low_);
+    }
+};
+
+} // namespace trading
+
+#endif // TRADING_PRICE_LADDER_HPP
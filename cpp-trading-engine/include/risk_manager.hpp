@@ -2,8 +2,9 @@
 #define TRADING_RISK_MANAGER_HPP
 
 #include "order.hpp"
-#include <unordered_map>
+#include "instrument.hpp"
 #include <string>
+#include <vector>
 #include <mutex>
 
 namespace trading {
@@ -25,7 +26,8 @@ struct RiskCheckResult {
  * @brief Pre-trade risk management
  * 
  * Performs various risk checks before orders are submitted to the
- * matching engine.
+ * matching engine. Per-symbol state is stored densely by SymbolId; the
+ * Symbol overloads are for configuration and reporting.
  */
 class RiskManager {
 public:
@@ -44,21 +46,31 @@ public:
      * @param symbol The symbol
      * @param side The fill side
      * @param quantity The filled quantity
-     * @param price The fill price
+     * @param price The fill price in ticks
      */
+    void updatePosition(SymbolId symbol, Side side,
+                       Quantity quantity, Price price);
     void updatePosition(const Symbol& symbol, Side side, 
                        Quantity quantity, Price price);
     
+    // Instrument scaling (used to convert tick prices to notional)
+    void setTickSize(const Symbol& symbol, double tick_size);
+    double getTickSize(SymbolId symbol) const;
+    double getTickSize(const Symbol& symbol) const;
+    
     // Position Limits
     void setPositionLimit(const Symbol& symbol, Quantity limit);
+    Quantity getPositionLimit(SymbolId symbol) const;
     Quantity getPositionLimit(const Symbol& symbol) const;
     
     // Order Size Limits
     void setOrderSizeLimit(const Symbol& symbol, Quantity limit);
+    Quantity getOrderSizeLimit(SymbolId symbol) const;
     Quantity getOrderSizeLimit(const Symbol& symbol) const;
     
     // Notional Value Limits
     void setNotionalLimit(const Symbol& symbol, double limit);
+    double getNotionalLimit(SymbolId symbol) const;
     double getNotionalLimit(const Symbol& symbol) const;
     
     // Order Rate Limits
@@ -70,23 +82,92 @@ public:
     void setGlobalNotionalLimit(double limit);
     
     // Position Queries
+    Quantity getPosition(SymbolId symbol) const;
     Quantity getPosition(const Symbol& symbol) const;
+    double getNotionalExposure(SymbolId symbol) const;
     double getNotionalExposure(const Symbol& symbol) const;
     double getTotalNotionalExposure() const;
     
+    /**
+     * @brief Add another manager's positions and exposure to this one's
+     * 
+     * Limits and rate state are left alone. Used to merge the per-symbol
+     * state rebuilt by separate journal replay workers.
+     */
+    void addPositions(const RiskManager& other);
+    
     // Reset state
     void reset();
     
+    /**
+     * @brief Guard checks, position updates and position queries with a mutex
+     * 
+     * Off by default. Turn it on when checkOrder() and updatePosition() run
+     * on different threads (see EnginePipeline). Limits and tick sizes are
+     * not guarded: set them before those threads start.
+     */
+    void setLocking(bool enabled) { locking_ = enabled; }
+    bool locking() const { return locking_; }
+    
+    // Default limits
+    static constexpr Quantity DEFAULT_POSITION_LIMIT = 100000;
+    static constexpr Quantity DEFAULT_ORDER_SIZE_LIMIT = 10000;
+    static constexpr double DEFAULT_NOTIONAL_LIMIT = 10000000.0;
+    
+    // Limits, scaling and current exposure for one symbol
+    struct SymbolRisk {
+        double tick_size = DEFAULT_TICK_SIZE;
+        Quantity position_limit = DEFAULT_POSITION_LIMIT;
+        Quantity order_size_limit = DEFAULT_ORDER_SIZE_LIMIT;
+        double notional_limit = DEFAULT_NOTIONAL_LIMIT;
+        Quantity position = 0;
+        double notional_exposure = 0.0;
+    };
+    
+    // Global limits and the order rate counter
+    struct GlobalRisk {
+        Quantity position_limit = 0;
+        double notional_limit = 0.0;
+        size_t order_rate_limit = 0;
+        size_t orders_this_second = 0;
+    };
+    
+    /**
+     * @brief State of one symbol, nullptr if it has never been touched
+     */
+    const SymbolRisk* symbolRisk(SymbolId symbol) const { return find(symbol); }
+    
+    /**
+     * @brief Number of symbol ids with state (some may be untouched defaults)
+     */
+    size_t symbolCount() const { return symbols_.size(); }
+    
+    GlobalRisk globalRisk() const;
+    
+    /**
+     * @brief Overwrite saved state (snapshot restore)
+     * 
+     * A restored rate counter starts a fresh one-second window.
+     */
+    void restoreSymbolRisk(SymbolId symbol, const SymbolRisk& state) {
+        if (SymbolRisk* risk = entry(symbol)) {
+            *risk = state;
+        }
+    }
+    void restoreGlobalRisk(const GlobalRisk& state);
+
 private:
-    // Per-symbol limits
-    std::unordered_map<Symbol, Quantity> position_limits_;
-    std::unordered_map<Symbol, Quantity> order_size_limits_;
-    std::unordered_map<Symbol, double> notional_limits_;
+    // Indexed by SymbolId; grown on first touch of a symbol
+    std::vector<SymbolRisk> symbols_;
+    
+    // Entry for a symbol, created with defaults if needed; nullptr for an
+    // id the symbol registry never issued (it would size symbols_ by it)
+    SymbolRisk* entry(SymbolId symbol);
     
-    // Current positions
-    std::unordered_map<Symbol, Quantity> positions_;
-    std::unordered_map<Symbol, double> average_prices_;
-    std::unordered_map<Symbol, double> notional_exposures_;
+    // Entry for a symbol, nullptr if it has never been touched
+    const SymbolRisk* find(SymbolId symbol) const {
+        return symbol < symbols_.size() ? &symbols_[symbol] : nullptr;
+    }
     
     // Global limits
     Quantity global_position_limit_ = 0;
@@ -97,10 +178,14 @@ private:
     size_t orders_this_second_ = 0;
     std::chrono::steady_clock::time_point rate_window_start_;
     
-    // Default limits
-    static constexpr Quantity DEFAULT_POSITION_LIMIT = 100000;
-    static constexpr Quantity DEFAULT_ORDER_SIZE_LIMIT = 10000;
-    static constexpr double DEFAULT_NOTIONAL_LIMIT = 10000000.0;
+    // Opt-in locking (see setLocking())
+    bool locking_ = false;
+    mutable std::mutex mutex_;
+    
+    // Holds mutex_ when locking is on, nothing otherwise
+    std::unique_lock<std::mutex> guard() const {
+        return locking_ ? std::unique_lock<std::mutex>(mutex_) : std::unique_lock<std::mutex>();
+    }
     
     // Helper functions
     RiskCheckResult checkPositionLimit(const Order& order) const;
@@ -0,0 +1,203 @@
+#ifndef TRADING_SHARDED_ENGINE_HPP
+#define TRADING_SHARDED_ENGINE_HPP
+
+#include "command_queue.hpp"
+#include "engine_event.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief Listener that copies a shard engine's events into its output ring
+ *
+ * Waits while the ring is full, so a slow consumer slows its shard down
+ * rather than losing events. Once the sharded engine is stopping, an
+ * event that finds the ring full is counted as dropped instead.
+ */
+class ShardListener : public NullListener {
+public:
+    ShardListener() = default;
+    ShardListener(SpscRing<EngineEvent>* events, const std::atomic<bool>* stopping,
+                  std::atomic<uint64_t>* dropped)
+        : events_(events), stopping_(stopping), dropped_(dropped) {}
+    
+    void onFill(const Fill& fill) { publish(EngineEvent::fill(fill)); }
+    void onOrder(const Order& order) { publish(EngineEvent::order(order)); }
+
+private:
+    SpscRing<EngineEvent>* events_ = nullptr;
+    const std::atomic<bool>* stopping_ = nullptr;
+    std::atomic<uint64_t>* dropped_ = nullptr;
+    
+    void publish(const EngineEvent& event) {
+        while (!events_->tryPush(event)) {
+            if (stopping_->load(std::memory_order_acquire)) {
+                dropped_->fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+};
+
+/**
+ * @brief Sharded engine tuning
+ */
+struct ShardOptions {
+    size_t shards = 0;                 // Worker threads; 0 = hardware threads
+    size_t queue_capacity = 65536;     // Commands each shard can have queued
+    size_t batch_size = 256;           // Commands a worker applies per pass
+    WaitStrategy wait = WaitStrategy::SpinYield;   // How an idle worker waits
+    size_t event_capacity = 65536;     // Unconsumed events each shard can hold
+    bool pin_threads = true;           // Pin shard i to CPU first_cpu + i (Linux)
+    size_t first_cpu = 0;
+};
+
+/**
+ * @brief Matching engine that partitions symbols across pinned worker threads
+ *
+ * Every symbol belongs to exactly one shard. Each shard is a worker thread
+ * running an EngineLoop over its own engine and the books of its symbols,
+ * fed through a CommandQueue and publishing its fills and order updates
+ * on a single-consumer output ring. Shards share no book
+ * state, so throughput grows with the number of cores as long as the
+ * flow is spread over enough symbols.
+ *
+ * One thread submits commands; since a symbol's commands all go through
+ * one FIFO to one thread, they are applied in submission order, and a
+ * symbol's events come out of its shard's ring in the order a single
+ * engine would have produced them. Events of different shards are not
+ * ordered with respect to each other.
+ *
+ * Symbols are assigned to the shard with the fewest symbols the first
+ * time they are seen; register them up front to spread them (and their
+ * books' storage) before start(). The shard engines have no journal or
+ * risk manager.
+ */
+class ShardedEngine {
+public:
+    explicit ShardedEngine(ShardOptions options = ShardOptions());
+    ~ShardedEngine();    // Stops the workers
+    
+    ShardedEngine(const ShardedEngine&) = delete;
+    ShardedEngine& operator=(const ShardedEngine&) = delete;
+    
+    /**
+     * @brief Assign an instrument to a shard and create its book
+     * @return false once started
+     */
+    bool registerInstrument(const InstrumentSpec& spec, size_t expected_orders = 0);
+    bool registerSymbol(const Symbol& symbol, size_t expected_orders = 0);
+    
+    /**
+     * @brief Start the shard threads
+     * @return false if already started (an engine starts once)
+     */
+    bool start();
+    
+    /**
+     * @brief Apply every queued command, then join the shard threads
+     *
+     * Call it from the submitting thread. Events left unconsumed stay in
+     * the output rings; those that no longer fit are counted as dropped.
+     */
+    void stop();
+    
+    bool running() const { return started_ && !stopping_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @name Submitting thread only
+     * Each call queues one command on the symbol's shard, waiting while
+     * that shard's ring is full; false if the engine is not running or
+     * the symbol id was never issued by the registry.
+     * @{
+     */
+    bool submitOrder(const Order& order) { return submit(EngineCommand::submit(order)); }
+    bool cancelOrder(SymbolId symbol, OrderId order_id) {
+        return submit(EngineCommand::cancel(symbol, order_id));
+    }
+    bool modifyOrder(SymbolId symbol, OrderId order_id, Price new_price, Quantity new_quantity) {
+        return submit(EngineCommand::modify(symbol, order_id, new_price, new_quantity));
+    }
+    bool submit(const EngineCommand& command);
+    
+    /**
+     * @brief Wait until every shard has applied every command queued so far
+     */
+    void waitIdle() const;
+    /** @} */
+    
+    /**
+     * @brief Hand up to max_events of a shard's queued events to fn
+     *        (one consumer thread per shard)
+     * @param fn Called as fn(const EngineEvent&) in the order the shard
+     *        produced them
+     * @return Number of events consumed
+     */
+    template <typename Fn>
+    size_t consumeEvents(size_t shard, Fn&& fn, size_t max_events = static_cast<size_t>(-1)) {
+        return shards_[shard]->events.consume(std::forward<Fn>(fn), max_events);
+    }
+    
+    size_t shardCount() const { return shards_.size(); }
+    
+    /**
+     * @brief Shard a symbol belongs to, or shardCount() if not assigned yet
+     */
+    size_t shardOf(SymbolId symbol) const {
+        return symbol < shard_of_.size() ? shard_of_[symbol] : shards_.size();
+    }
+    
+    /**
+     * @brief A shard's engine; only while stopped or idle (see waitIdle())
+     */
+    const BasicMatchingEngine<ShardListener>& shardEngine(size_t shard) const {
+        return shards_[shard]->engine;
+    }
+    
+    /**
+     * @brief Sum of the shard engines' state hashes; equals the stateHash()
+     *        of a single engine given the same commands (only while stopped
+     *        or idle)
+     */
+    uint64_t stateHash() const;
+    
+    uint64_t commandsProcessed() const;
+    uint64_t eventsDropped() const;
+
+private:
+    struct Shard {
+        Shard(const ShardOptions& options, const std::atomic<bool>* stopping)
+            : commands(options.queue_capacity, options.wait)
+            , events(options.event_capacity)
+            , engine(ShardListener(&events, stopping, &dropped))
+            , loop(engine, commands, options.batch_size) {}
+        
+        CommandQueue commands;
+        SpscRing<EngineEvent> events;
+        std::atomic<uint64_t> dropped{0};       // Events that found the ring full while stopping
+        BasicMatchingEngine<ShardListener> engine;
+        EngineLoop<ShardListener> loop;
+        std::thread thread;
+        size_t symbols = 0;                     // Symbols assigned (routing load)
+        uint64_t enqueued = 0;                  // Submitting thread only
+    };
+    
+    ShardOptions options_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<uint32_t> shard_of_;    // By SymbolId; shardCount() = unassigned
+    bool started_ = false;
+    std::atomic<bool> stopping_{false};
+    
+    // Shard of a symbol, assigning it to the least loaded shard on first
+    // sight; nullptr for an id the registry never issued
+    Shard* route(SymbolId symbol);
+};
+
+} // namespace trading
+
+#endif // TRADING_SHARDED_ENGINE_HPP
@@ -0,0 +1,65 @@
+#ifndef TRADING_SPAN_HPP
+#define TRADING_SPAN_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief Non-owning view of a contiguous array (minimal C++17 std::span)
+ * 
+ * Used by the batch APIs so callers can pass a vector, a C array or a
+ * slice of either without copying.
+ */
+template <typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+    
+    constexpr Span() noexcept = default;
+    constexpr Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+    
+    template <size_t N>
+    constexpr Span(T (&array)[N]) noexcept : data_(array), size_(N) {}
+    
+    // Views over a vector; a const view binds to a const vector
+    template <typename U, typename = std::enable_if_t<
+        std::is_convertible<U (*)[], T (*)[]>::value>>
+    Span(std::vector<U>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+    
+    template <typename U, typename = std::enable_if_t<
+        std::is_convertible<const U (*)[], T (*)[]>::value>>
+    Span(const std::vector<U>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+    
+    // Span<T> converts to Span<const T>
+    template <typename U, typename = std::enable_if_t<
+        std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(const Span<U>& other) noexcept : data_(other.data()), size_(other.size()) {}
+    
+    constexpr T* data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    
+    constexpr T& operator[](size_t index) const { return data_[index]; }
+    constexpr T* begin() const noexcept { return data_; }
+    constexpr T* end() const noexcept { return data_ + size_; }
+    
+    /**
+     * @brief View of count elements starting at offset
+     */
+    constexpr Span subspan(size_t offset, size_t count) const {
+        return Span(data_ + offset, count);
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace trading
+
+#endif // TRADING_SPAN_HPP
@@ -0,0 +1,127 @@
+#ifndef TRADING_SPSC_RING_HPP
+#define TRADING_SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace trading {
+
+// Size used to keep producer and consumer state on separate cache lines
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Bounded single-producer / single-consumer ring buffer
+ *
+ * Storage is allocated once at construction (capacity rounded up to a
+ * power of two), so push and pop never allocate. The producer and consumer
+ * each own one index and keep a cached copy of the other's, touching the
+ * shared index only when the cached one says the ring looks full / empty.
+ * Exactly one thread may push and one (possibly different) thread may pop.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : mask_(roundUp(capacity) - 1)
+        , slots_(new T[mask_ + 1]) {}
+    
+    // Non-copyable, non-movable (the indices are shared between threads)
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    
+    /**
+     * @brief Append one item (producer thread only)
+     * @return false if the ring is full
+     */
+    bool tryPush(const T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Remove one item (consumer thread only)
+     * @return false if the ring is empty
+     */
+    bool tryPop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return false;
+            }
+        }
+        item = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Hand up to max_items queued items to fn in one pass
+     *        (consumer thread only)
+     * @param fn Called as fn(const T&) for each item in FIFO order
+     * @return Number of items consumed
+     */
+    template <typename Fn>
+    size_t consume(Fn&& fn, size_t max_items = static_cast<size_t>(-1)) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        tail_cache_ = tail_.load(std::memory_order_acquire);
+        size_t available = tail_cache_ - head;
+        size_t count = available < max_items ? available : max_items;
+        for (size_t i = 0; i < count; ++i) {
+            fn(static_cast<const T&>(slots_[(head + i) & mask_]));
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+    
+    /**
+     * @brief Copy up to max_items queued items into out (consumer thread only)
+     * @return Number of items copied
+     */
+    size_t drain(T* out, size_t max_items) {
+        return consume([&out](const T& item) { *out++ = item; }, max_items);
+    }
+    
+    /**
+     * @brief Approximate number of queued items (exact when quiescent)
+     */
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        return size;
+    }
+    
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+    
+    // Consumer side: read index and cached copy of the write index
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;
+    
+    // Producer side: write index and cached copy of the read index
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;
+};
+
+} // namespace trading
+
+#endif // TRADING_SPSC_RING_HPP
@@ -0,0 +1,39 @@
+#ifndef TRADING_STATE_HASH_HPP
+#define TRADING_STATE_HASH_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace trading {
+
+/**
+ * @brief 64-bit finalizer (splitmix64): every input bit affects every output bit
+ */
+inline uint64_t hashMix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Fold one value into a running hash (order-sensitive)
+ */
+inline uint64_t hashCombine(uint64_t seed, uint64_t value) {
+    return hashMix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+/**
+ * @brief FNV-1a over a string; symbol names hash the same in every process
+ */
+inline uint64_t hashString(const std::string& text) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace trading
+
+#endif // TRADING_STATE_HASH_HPP
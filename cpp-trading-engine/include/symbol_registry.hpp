@@ -0,0 +1,111 @@
+#ifndef TRADING_SYMBOL_REGISTRY_HPP
+#define TRADING_SYMBOL_REGISTRY_HPP
+
+#include "types.hpp"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace trading {
+
+/**
+ * @brief Process-wide symbol interning table
+ * 
+ * Hands out dense SymbolIds (0, 1, 2, ...) the first time a name is seen.
+ * Orders, fills, books and risk state carry the id; the string is only
+ * needed where symbols enter (gateway, configuration) or leave (reporting,
+ * logging) the engine. Ids are never reused or removed.
+ * 
+ * All methods are thread-safe. Interning takes a lock, so it belongs at
+ * the edges rather than on the matching path.
+ */
+class SymbolRegistry {
+public:
+    /**
+     * @brief The registry shared by the whole process
+     */
+    static SymbolRegistry& instance();
+    
+    /**
+     * @brief Get the id for a name, assigning the next id if it is new
+     * @param name The symbol name
+     * @return Interned symbol id
+     */
+    SymbolId intern(const Symbol& name);
+    
+    /**
+     * @brief Look up a name without interning it
+     * @param name The symbol name
+     * @return Symbol id, or INVALID_SYMBOL_ID if never interned
+     */
+    SymbolId find(const Symbol& name) const;
+    
+    /**
+     * @brief Get the name for an id
+     * @param id An id previously returned by intern()
+     * @return Reference to the name (stable for the registry's lifetime)
+     */
+    const Symbol& name(SymbolId id) const;
+    
+    /**
+     * @brief Number of interned symbols (one past the highest id)
+     */
+    size_t size() const;
+    
+    /**
+     * @brief True if an id has been handed out by intern()
+     * 
+     * Lock-free, so it can guard the places that size storage by SymbolId
+     * against ids that were never issued (INVALID_SYMBOL_ID, garbage).
+     */
+    bool issued(SymbolId id) const { return id < count_.load(std::memory_order_acquire); }
+    
+    /**
+     * @brief Hold the registry lock for the caller's scope
+     * 
+     * Taken around fork() so the child cannot inherit it held by a thread
+     * that does not exist in the child.
+     */
+    std::unique_lock<std::mutex> lock() const {
+        return std::unique_lock<std::mutex>(mutex_);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<Symbol, SymbolId> ids_;
+    std::deque<Symbol> names_;  // deque keeps references stable on growth
+    std::atomic<size_t> count_{0};   // names_.size(), readable without the lock
+};
+
+/**
+ * @brief Intern a symbol name in the process-wide registry
+ */
+inline SymbolId internSymbol(const Symbol& name) {
+    return SymbolRegistry::instance().intern(name);
+}
+
+/**
+ * @brief Look up a symbol in the process-wide registry without interning
+ */
+inline SymbolId findSymbol(const Symbol& name) {
+    return SymbolRegistry::instance().find(name);
+}
+
+/**
+ * @brief True if an id was issued by the process-wide registry
+ */
+inline bool isInternedSymbol(SymbolId id) {
+    return SymbolRegistry::instance().issued(id);
+}
+
+/**
+ * @brief Name of an interned symbol from the process-wide registry
+ */
+inline const Symbol& symbolName(SymbolId id) {
+    return SymbolRegistry::instance().name(id);
+}
+
+} // namespace trading
+
+#endif // TRADING_SYMBOL_REGISTRY_HPP
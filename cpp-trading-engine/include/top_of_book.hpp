@@ -0,0 +1,162 @@
+#ifndef TRADING_TOP_OF_BOOK_HPP
+#define TRADING_TOP_OF_BOOK_HPP
+
+#include "types.hpp"
+#include "spsc_ring.hpp"
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace trading {
+
+/**
+ * @brief Consistent copy of a book's best bid and offer
+ *
+ * An empty side has price and quantity 0. The accessors mirror the
+ * OrderBook queries of the same name.
+ */
+struct Quote {
+    Price bid_price = 0;
+    Quantity bid_quantity = 0;
+    Price ask_price = 0;
+    Quantity ask_quantity = 0;
+    uint64_t sequence = 0;    // Number of top-of-book changes published so far
+    
+    std::optional<std::pair<Price, Quantity>> getBestBid() const {
+        if (bid_quantity == 0) {
+            return std::nullopt;
+        }
+        return std::make_pair(bid_price, bid_quantity);
+    }
+    
+    std::optional<std::pair<Price, Quantity>> getBestAsk() const {
+        if (ask_quantity == 0) {
+            return std::nullopt;
+        }
+        return std::make_pair(ask_price, ask_quantity);
+    }
+    
+    std::optional<Price> getSpread() const {
+        if (bid_quantity == 0 || ask_quantity == 0) {
+            return std::nullopt;
+        }
+        return ask_price - bid_price;
+    }
+    
+    std::optional<double> getMidPrice() const {
+        if (bid_quantity == 0 || ask_quantity == 0) {
+            return std::nullopt;
+        }
+        return static_cast<double>(bid_price + ask_price) / 2.0;
+    }
+};
+
+/**
+ * @brief Seqlock-protected best bid and offer, readable from any thread
+ *
+ * One writer (the thread that owns the book) publishes; any number of
+ * readers copy the quote without locks and without writing to shared
+ * memory, so readers never slow the writer or each other down. The
+ * sequence counter is odd while a publish is in progress; a reader that
+ * sees it odd, or sees it change across the copy, discards the copy.
+ * The whole structure fits in one cache line.
+ */
+class alignas(CACHE_LINE_SIZE) TopOfBook {
+public:
+    TopOfBook() = default;
+    
+    // Copies are not synchronised: only move books before sharing them
+    TopOfBook(const TopOfBook& other) { copyFrom(other); }
+    TopOfBook& operator=(const TopOfBook& other) {
+        copyFrom(other);
+        return *this;
+    }
+    
+    /**
+     * @brief Publish a new best bid and offer (writer thread only)
+     * @return false if nothing changed, in which case nothing is written
+     */
+    bool publish(Price bid_price, Quantity bid_quantity,
+                 Price ask_price, Quantity ask_quantity) {
+        if (bid_price == bid_price_.load(std::memory_order_relaxed) &&
+            bid_quantity == bid_quantity_.load(std::memory_order_relaxed) &&
+            ask_price == ask_price_.load(std::memory_order_relaxed) &&
+            ask_quantity == ask_quantity_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        
+        bid_price_.store(bid_price, std::memory_order_relaxed);
+        bid_quantity_.store(bid_quantity, std::memory_order_relaxed);
+        ask_price_.store(ask_price, std::memory_order_relaxed);
+        ask_quantity_.store(ask_quantity, std::memory_order_relaxed);
+        
+        seq_.store(seq + 2, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Take one consistent copy of the quote, without retrying
+     * @return false if a publish was in progress; quote is then unspecified
+     */
+    bool tryRead(Quote& quote) const {
+        uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        
+        quote.bid_price = bid_price_.load(std::memory_order_relaxed);
+        quote.bid_quantity = bid_quantity_.load(std::memory_order_relaxed);
+        quote.ask_price = ask_price_.load(std::memory_order_relaxed);
+        quote.ask_quantity = ask_quantity_.load(std::memory_order_relaxed);
+        
+        std::atomic_thread_fence(std::memory_order_acquire);
+        quote.sequence = before / 2;
+        return seq_.load(std::memory_order_relaxed) == before;
+    }
+    
+    /**
+     * @brief Consistent copy of the quote, retrying while a publish races
+     *
+     * Publishing is a handful of stores, so a retry is rare and short.
+     */
+    Quote read() const {
+        Quote quote;
+        while (!tryRead(quote)) {
+        }
+        return quote;
+    }
+    
+    /**
+     * @brief Number of changes published so far
+     */
+    uint64_t sequence() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<Price> bid_price_{0};
+    std::atomic<Quantity> bid_quantity_{0};
+    std::atomic<Price> ask_price_{0};
+    std::atomic<Quantity> ask_quantity_{0};
+    
+    void copyFrom(const TopOfBook& other) {
+        seq_.store(other.seq_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        bid_price_.store(other.bid_price_.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+        bid_quantity_.store(other.bid_quantity_.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+        ask_price_.store(other.ask_price_.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+        ask_quantity_.store(other.ask_quantity_.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+    }
+};
+
+static_assert(sizeof(TopOfBook) == CACHE_LINE_SIZE, "TopOfBook should fill one cache line");
+
+} // namespace trading
+
+#endif // TRADING_TOP_OF_BOOK_HPP
@@ -9,9 +9,10 @@ namespace trading {
 
 // Type aliases for clarity and potential future changes
 using OrderId = uint64_t;
-using Price = double;
+using Price = int64_t;       // Integer ticks; see InstrumentSpec for scaling
 using Quantity = int64_t;
 using Symbol = std::string;
+using SymbolId = uint32_t;   // Dense interned symbol index; see SymbolRegistry
 using Timestamp = std::chrono::steady_clock::time_point;
 
 // Order side enumeration
@@ -69,9 +70,12 @@ inline const char* to_string(OrderStatus status) {
     }
 }
 
-// Price constants
-constexpr Price MAX_PRICE = 1e12;
-constexpr Price MIN_PRICE = 0.0;
+// Sentinel for "no such symbol"
+constexpr SymbolId INVALID_SYMBOL_ID = UINT32_MAX;
+
+// Price constants (in ticks)
+constexpr Price MAX_PRICE = 1'000'000'000'000;
+constexpr Price MIN_PRICE = 0;
 
 } // namespace trading
 
@@ -0,0 +1,120 @@
+#include "async_publisher.hpp"
+
+namespace trading {
+
+AsyncPublisher::AsyncPublisher(PublisherOptions options)
+    : options_(options)
+    , ring_(options.capacity)
+    , waiter_(options.wait) {
+    if (options_.batch_size == 0) {
+        options_.batch_size = 1;
+    }
+}
+
+AsyncPublisher::~AsyncPublisher() {
+    stop();
+}
+
+bool AsyncPublisher::start() {
+    if (started_) {
+        return false;
+    }
+    started_ = true;
+    stopping_.store(false, std::memory_order_release);
+    thread_ = std::thread([this]() { run(); });
+    return true;
+}
+
+void AsyncPublisher::stop() {
+    if (!running()) {
+        return;
+    }
+    flush();
+    stopping_.store(true, std::memory_order_seq_cst);
+    waiter_.wake();
+    thread_.join();
+}
+
+void AsyncPublisher::flush() {
+    if (holding_) {
+        pushWaiting(held_);
+        holding_ = false;
+    }
+    if (unreported_drops_ > 0) {
+        pushWaiting(EngineEvent::gap(unreported_drops_));
+        unreported_drops_ = 0;
+    }
+}
+
+PublisherStats AsyncPublisher::stats() const {
+    PublisherStats stats;
+    stats.published = published_.load(std::memory_order_relaxed);
+    stats.delivered = delivered_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.conflated = conflated_.load(std::memory_order_relaxed);
+    stats.full_waits = full_waits_.load(std::memory_order_relaxed);
+    stats.capacity = ring_.capacity();
+    stats.occupancy = ring_.size();
+    stats.peak_occupancy = peak_occupancy_.load(std::memory_order_relaxed);
+    uint64_t passes = passes_.load(std::memory_order_relaxed);
+    if (passes > 0) {
+        stats.mean_occupancy = static_cast<double>(occupancy_sum_.load(std::memory_order_relaxed)) /
+                               static_cast<double>(passes);
+    }
+    return stats;
+}
+
+void AsyncPublisher::waitToPush(const EngineEvent& event) {
+    for (size_t spins = 0; !tryPush(event); ++spins) {
+        if (spins < QueueWaiter::SPIN_LIMIT) {
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void AsyncPublisher::run() {
+    while (waiter_.wait([this]() { return !ring_.empty(); }, stopping_)) {
+        // Occupancy is sampled here, off the matching thread
+        size_t queued = ring_.size();
+        bump(occupancy_sum_, queued);
+        bump(passes_);
+        if (queued > peak_occupancy_.load(std::memory_order_relaxed)) {
+            peak_occupancy_.store(queued, std::memory_order_relaxed);
+        }
+        
+        size_t count = ring_.consume([this](const EngineEvent& event) { deliver(event); },
+                                     options_.batch_size);
+        bump(delivered_, count);
+    }
+}
+
+void AsyncPublisher::deliver(const EngineEvent& event) {
+    switch (event.type) {
+        case EngineEventType::Fill:
+            if (fill_callback_) {
+                fill_callback_(event.toFill());
+            }
+            break;
+        case EngineEventType::Order:
+            if (order_callback_) {
+                order_callback_(event.toOrder());
+            }
+            break;
+        case EngineEventType::ConflatedFill:
+            if (conflated_fill_callback_) {
+                conflated_fill_callback_(event.toFill(), static_cast<uint64_t>(event.filled_qty));
+            } else if (fill_callback_) {
+                fill_callback_(event.toFill());
+            }
+            break;
+        case EngineEventType::Gap:
+            if (gap_callback_) {
+                gap_callback_(static_cast<uint64_t>(event.quantity));
+            }
+            break;
+    }
+}
+
+} // namespace trading
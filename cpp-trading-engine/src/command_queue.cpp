@@ -0,0 +1,42 @@
+#include "command_queue.hpp"
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace trading {
+
+void QueueWaiter::sleep() {
+    sleeps_.fetch_add(1, std::memory_order_relaxed);
+#if defined(__linux__)
+    // Returns at once if the flag was already cleared; spurious wake-ups are fine
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sleeping_), FUTEX_WAIT_PRIVATE,
+              1, nullptr, nullptr, 0);
+#else
+    std::this_thread::yield();
+#endif
+    sleeping_.store(0, std::memory_order_relaxed);
+}
+
+void QueueWaiter::wake() {
+    sleeping_.store(0, std::memory_order_seq_cst);
+    wakeups_.fetch_add(1, std::memory_order_relaxed);
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sleeping_), FUTEX_WAKE_PRIVATE,
+              1, nullptr, nullptr, 0);
+#endif
+}
+
+void CommandQueue::push(const EngineCommand& command) {
+    for (size_t spins = 0; !tryPush(command); ++spins) {
+        if (spins < QueueWaiter::SPIN_LIMIT) {
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace trading
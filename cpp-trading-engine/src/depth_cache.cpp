@@ -0,0 +1,70 @@
+#include "depth_cache.hpp"
+
+namespace trading {
+
+void DepthCache::update(const PriceLadder& ladder, Price price, const PriceLevel* level) {
+    auto& slots = depth_.levels;
+    size_t& count = depth_.count;
+    
+    // Most changes in a deep book are below the cached range
+    if (count == LEVELS && better(slots[LEVELS - 1].price, price)) {
+        return;
+    }
+    
+    // Position of the price among the cached levels (best first)
+    size_t pos = 0;
+    while (pos < count && better(slots[pos].price, price)) {
+        ++pos;
+    }
+    bool cached = pos < count && slots[pos].price == price;
+    
+    if (level && !level->empty()) {
+        if (cached) {
+            slots[pos] = entry(*level);
+            return;
+        }
+        if (pos >= LEVELS) {
+            return;  // Worse than everything in a full cache
+        }
+        
+        // New level inside the top N: shift worse levels down, dropping
+        // the last one if the cache is full
+        size_t last = (count < LEVELS) ? count : LEVELS - 1;
+        for (size_t i = last; i > pos; --i) {
+            slots[i] = slots[i - 1];
+        }
+        slots[pos] = entry(*level);
+        if (count < LEVELS) {
+            ++count;
+        }
+        return;
+    }
+    
+    if (!cached) {
+        return;
+    }
+    
+    // Level removed: close the gap, then refill the tail from the ladder
+    bool was_full = full();
+    for (size_t i = pos; i + 1 < count; ++i) {
+        slots[i] = slots[i + 1];
+    }
+    --count;
+    if (was_full) {
+        const PriceLevel* next = count ? ladder.nextAfter(slots[count - 1].price)
+                                       : ladder.best();
+        if (next) {
+            slots[count++] = entry(*next);
+        }
+    }
+}
+
+void DepthCache::rebuild(const PriceLadder& ladder) {
+    depth_.count = 0;
+    ladder.forEach([this](const PriceLevel& level) {
+        depth_.levels[depth_.count++] = entry(level);
+        return depth_.count < LEVELS;
+    });
+}
+
+} // namespace trading
@@ -0,0 +1,386 @@
+#include "engine_snapshot.hpp"
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+namespace trading {
+
+namespace {
+
+// File header: identifies the format and locates the body
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t journal_sequence;
+    uint64_t journal_offset;
+    uint64_t state_hash;
+    uint64_t body_bytes;
+    uint32_t book_count;
+    uint32_t risk_symbols;
+    uint32_t flags;
+    uint32_t checksum;   // Over the body
+};
+
+constexpr char SNAPSHOT_MAGIC[4] = {'T', 'R', 'S', 'N'};
+constexpr uint32_t FLAG_RISK = 1;
+
+// One book, followed by its name (padded to 8 bytes), then bid_levels bid
+// levels and ask_levels ask levels, best first
+struct SnapshotBook {
+    double tick_size;
+    int32_t price_decimals;
+    BookLayout layout;
+    uint8_t reserved[3];
+    Price band_low;
+    Price band_ticks;
+    uint64_t orders;
+    uint32_t bid_levels;
+    uint32_t ask_levels;
+    uint32_t name_size;
+    uint32_t reserved2;
+};
+
+// One price level, followed by its orders in time priority
+struct SnapshotLevel {
+    Price price;
+    uint64_t order_count;
+};
+
+struct SnapshotOrder {
+    OrderId id;
+    Quantity quantity;
+    Quantity filled;
+};
+
+// Global limits and rate counter (present with FLAG_RISK)
+struct SnapshotGlobalRisk {
+    Quantity position_limit;
+    double notional_limit;
+    uint64_t order_rate_limit;
+    uint64_t orders_this_second;
+};
+
+// One symbol's risk state, followed by its name (padded to 8 bytes)
+struct SnapshotSymbolRisk {
+    double tick_size;
+    Quantity position_limit;
+    Quantity order_size_limit;
+    double notional_limit;
+    Quantity position;
+    double notional_exposure;
+    uint32_t name_size;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SnapshotHeader) == 56, "snapshot header size");
+static_assert(sizeof(SnapshotBook) == 56, "snapshot book size");
+static_assert(sizeof(SnapshotLevel) == 16, "snapshot level size");
+static_assert(sizeof(SnapshotOrder) == 24, "snapshot order size");
+static_assert(sizeof(SnapshotGlobalRisk) == 32, "snapshot global risk size");
+static_assert(sizeof(SnapshotSymbolRisk) == 56, "snapshot symbol risk size");
+
+size_t padded(size_t size) {
+    return (size + 7) & ~static_cast<size_t>(7);
+}
+
+// Body being written, kept 8-byte aligned record by record
+class BodyWriter {
+public:
+    template <typename T>
+    void put(const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        body_.insert(body_.end(), bytes, bytes + sizeof(T));
+    }
+    
+    void putName(const std::string& name) {
+        body_.insert(body_.end(), name.begin(), name.end());
+        body_.resize(padded(body_.size()), '\0');
+    }
+    
+    void reserve(size_t bytes) { body_.reserve(bytes); }
+    const std::vector<char>& body() const { return body_; }
+
+private:
+    std::vector<char> body_;
+};
+
+// Bounds-checked reads from the mapped body
+class BodyReader {
+public:
+    BodyReader(const char* begin, const char* end) : cursor_(begin), end_(end) {}
+    
+    template <typename T>
+    bool get(T& value) {
+        if (static_cast<size_t>(end_ - cursor_) < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, cursor_, sizeof(T));
+        cursor_ += sizeof(T);
+        return true;
+    }
+    
+    bool getName(uint32_t size, std::string& name) {
+        if (static_cast<size_t>(end_ - cursor_) < padded(size)) {
+            return false;
+        }
+        name.assign(cursor_, size);
+        cursor_ += padded(size);
+        return true;
+    }
+    
+    const char* position() const { return cursor_; }
+
+private:
+    const char* cursor_;
+    const char* end_;
+};
+
+void writeBook(BodyWriter& out, const OrderBook& book) {
+    const InstrumentSpec& spec = book.instrument();
+    SnapshotBook record{};
+    record.tick_size = spec.tick_size;
+    record.price_decimals = spec.price_decimals;
+    record.layout = spec.layout;
+    record.band_low = spec.band_low;
+    record.band_ticks = spec.band_ticks;
+    record.orders = book.totalOrderCount();
+    record.bid_levels = static_cast<uint32_t>(book.levelCount(Side::Buy));
+    record.ask_levels = static_cast<uint32_t>(book.levelCount(Side::Sell));
+    record.name_size = static_cast<uint32_t>(spec.symbol.size());
+    out.put(record);
+    out.putName(spec.symbol);
+    
+    for (Side side : {Side::Buy, Side::Sell}) {
+        book.visitLevels(side, [&out](const PriceLevel& level) {
+            out.put(SnapshotLevel{level.price, static_cast<uint64_t>(level.order_count())});
+            for (const Order& order : level.orders) {
+                out.put(SnapshotOrder{order.id, order.quantity, order.filled_qty});
+            }
+        });
+    }
+}
+
+// Rebuild one book's levels from the body
+bool readSide(BodyReader& in, OrderBook& book, Side side, uint32_t levels,
+              std::vector<Order>& scratch, Timestamp now) {
+    for (uint32_t l = 0; l < levels; ++l) {
+        SnapshotLevel level;
+        if (!in.get(level)) {
+            return false;
+        }
+        scratch.clear();
+        for (uint64_t i = 0; i < level.order_count; ++i) {
+            SnapshotOrder stored;
+            if (!in.get(stored)) {
+                return false;
+            }
+            scratch.emplace_back(stored.id, book.symbolId(), side, OrderType::Limit,
+                                 level.price, stored.quantity, now);
+            scratch.back().filled_qty = stored.filled;
+            scratch.back().status = stored.filled > 0 ? OrderStatus::PartiallyFilled
+                                                      : OrderStatus::New;
+        }
+        if (!book.restoreLevel(side, level.price, scratch)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool EngineSnapshot::write(const std::string& path, const std::vector<const OrderBook*>& books,
+                           const RiskManager* risk, SnapshotInfo& info) {
+    BodyWriter out;
+    uint64_t orders = 0;
+    for (const OrderBook* book : books) {
+        orders += book->totalOrderCount();
+    }
+    out.reserve(books.size() * (sizeof(SnapshotBook) + 32) + orders * sizeof(SnapshotOrder));
+    
+    for (const OrderBook* book : books) {
+        writeBook(out, *book);
+    }
+    
+    size_t risk_symbols = 0;
+    if (risk) {
+        RiskManager::GlobalRisk global = risk->globalRisk();
+        out.put(SnapshotGlobalRisk{global.position_limit, global.notional_limit,
+                                   global.order_rate_limit, global.orders_this_second});
+        for (SymbolId symbol = 0; symbol < risk->symbolCount(); ++symbol) {
+            const RiskManager::SymbolRisk* state = risk->symbolRisk(symbol);
+            const Symbol& name = symbolName(symbol);
+            if (!state || name.empty()) {
+                continue;
+            }
+            SnapshotSymbolRisk record{};
+            record.tick_size = state->tick_size;
+            record.position_limit = state->position_limit;
+            record.order_size_limit = state->order_size_limit;
+            record.notional_limit = state->notional_limit;
+            record.position = state->position;
+            record.notional_exposure = state->notional_exposure;
+            record.name_size = static_cast<uint32_t>(name.size());
+            out.put(record);
+            out.putName(name);
+            ++risk_symbols;
+        }
+    }
+    
+    const std::vector<char>& body = out.body();
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.journal_sequence = info.journal_sequence;
+    header.journal_offset = info.journal_offset;
+    header.state_hash = info.state_hash;
+    header.body_bytes = body.size();
+    header.book_count = static_cast<uint32_t>(books.size());
+    header.risk_symbols = static_cast<uint32_t>(risk_symbols);
+    header.flags = risk ? FLAG_RISK : 0;
+    header.checksum = OrderJournal::checksum(body.data(), body.size(), nullptr, 0);
+    
+    // Write beside the old snapshot and rename over it once durable
+    std::string temp_path = path + ".tmp";
+    std::FILE* file = std::fopen(temp_path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (body.empty() || std::fwrite(body.data(), body.size(), 1, file) == 1) &&
+              std::fflush(file) == 0 && ::fsync(::fileno(file)) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    
+    info.has_risk = risk != nullptr;
+    info.books = books.size();
+    info.orders = orders;
+    info.risk_symbols = risk_symbols;
+    return true;
+}
+
+bool EngineSnapshot::open(const std::string& path) {
+    info_ = SnapshotInfo();
+    if (!file_.map(path) || file_.size() < sizeof(SnapshotHeader)) {
+        file_.unmap();
+        return false;
+    }
+    
+    SnapshotHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    const char* body = file_.data() + sizeof(header);
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header.version != FORMAT_VERSION ||
+        header.body_bytes != file_.size() - sizeof(header) ||
+        header.checksum != OrderJournal::checksum(body, header.body_bytes, nullptr, 0)) {
+        file_.unmap();
+        return false;
+    }
+    
+    // Walk the book records once to find where the risk state starts
+    BodyReader in(body, body + header.body_bytes);
+    uint64_t orders = 0;
+    for (uint32_t b = 0; b < header.book_count; ++b) {
+        SnapshotBook book;
+        std::string name;
+        if (!in.get(book) || !in.getName(book.name_size, name)) {
+            file_.unmap();
+            return false;
+        }
+        uint64_t levels = static_cast<uint64_t>(book.bid_levels) + book.ask_levels;
+        uint64_t bytes = levels * sizeof(SnapshotLevel) + book.orders * sizeof(SnapshotOrder);
+        if (bytes > static_cast<uint64_t>(body + header.body_bytes - in.position())) {
+            file_.unmap();
+            return false;
+        }
+        in = BodyReader(in.position() + bytes, body + header.body_bytes);
+        orders += book.orders;
+    }
+    
+    books_begin_ = body;
+    risk_begin_ = in.position();
+    body_end_ = body + header.body_bytes;
+    
+    info_.ok = true;
+    info_.journal_sequence = header.journal_sequence;
+    info_.journal_offset = header.journal_offset;
+    info_.state_hash = header.state_hash;
+    info_.has_risk = (header.flags & FLAG_RISK) != 0;
+    info_.books = header.book_count;
+    info_.orders = orders;
+    info_.risk_symbols = header.risk_symbols;
+    return true;
+}
+
+bool EngineSnapshot::restoreBooks(std::vector<std::unique_ptr<OrderBook>>& books) const {
+    books.clear();
+    if (!info_.ok) {
+        return false;
+    }
+    
+    BodyReader in(books_begin_, risk_begin_);
+    std::vector<Order> scratch;
+    Timestamp now = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < info_.books; ++b) {
+        SnapshotBook record;
+        std::string name;
+        in.get(record);
+        in.getName(record.name_size, name);
+        
+        InstrumentSpec spec(name, record.tick_size, record.price_decimals);
+        if (record.layout == BookLayout::Array) {
+            spec.withArrayLadder(record.band_low, record.band_ticks);
+        }
+        auto book = std::make_unique<OrderBook>(spec);
+        book->reserveOrders(record.orders);
+        if (!readSide(in, *book, Side::Buy, record.bid_levels, scratch, now) ||
+            !readSide(in, *book, Side::Sell, record.ask_levels, scratch, now) ||
+            book->totalOrderCount() != record.orders) {
+            books.clear();
+            return false;
+        }
+        book->finishRestore();
+        books.push_back(std::move(book));
+    }
+    return true;
+}
+
+bool EngineSnapshot::restoreRisk(RiskManager& risk) const {
+    if (!info_.ok || !info_.has_risk) {
+        return false;
+    }
+    
+    BodyReader in(risk_begin_, body_end_);
+    SnapshotGlobalRisk global;
+    if (!in.get(global)) {
+        return false;
+    }
+    RiskManager::GlobalRisk global_state;
+    global_state.position_limit = global.position_limit;
+    global_state.notional_limit = global.notional_limit;
+    global_state.order_rate_limit = static_cast<size_t>(global.order_rate_limit);
+    global_state.orders_this_second = static_cast<size_t>(global.orders_this_second);
+    risk.restoreGlobalRisk(global_state);
+    
+    for (size_t s = 0; s < info_.risk_symbols; ++s) {
+        SnapshotSymbolRisk record;
+        std::string name;
+        if (!in.get(record) || !in.getName(record.name_size, name)) {
+            return false;
+        }
+        RiskManager::SymbolRisk state;
+        state.tick_size = record.tick_size;
+        state.position_limit = record.position_limit;
+        state.order_size_limit = record.order_size_limit;
+        state.notional_limit = record.notional_limit;
+        state.position = record.position;
+        state.notional_exposure = record.notional_exposure;
+        risk.restoreSymbolRisk(internSymbol(name), state);
+    }
+    return true;
+}
+
+} // namespace trading
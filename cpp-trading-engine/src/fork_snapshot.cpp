@@ -0,0 +1,135 @@
+#include "fork_snapshot.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace trading {
+
+namespace {
+
+// What the child sends back through the pipe
+struct ChildReport {
+    SnapshotInfo info;
+    uint64_t write_ns;
+    uint64_t cow_bytes;
+};
+
+// Bytes of this process's memory currently shared with another process
+uint64_t sharedBytes() {
+    std::FILE* file = std::fopen("/proc/self/smaps_rollup", "r");
+    if (!file) {
+        return 0;
+    }
+    uint64_t shared_kb = 0;
+    char line[256];
+    while (std::fgets(line, sizeof(line), file)) {
+        unsigned long long kb = 0;
+        if (std::sscanf(line, "Shared_Clean: %llu kB", &kb) == 1 ||
+            std::sscanf(line, "Shared_Dirty: %llu kB", &kb) == 1) {
+            shared_kb += kb;
+        }
+    }
+    std::fclose(file);
+    return shared_kb * 1024;
+}
+
+uint64_t nanosSince(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace
+
+ForkSnapshot::~ForkSnapshot() {
+    wait();
+}
+
+bool ForkSnapshot::launch(const std::function<SnapshotInfo()>& write) {
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        return false;
+    }
+    
+    pid_t pid;
+    {
+        auto registry_lock = SymbolRegistry::instance().lock();
+        auto fork_start = std::chrono::steady_clock::now();
+        pid = ::fork();
+        if (pid == 0) {
+            // Child: the registry lock was taken by this thread's parent copy
+            registry_lock.unlock();
+            ::close(fds[0]);
+            uint64_t shared_at_fork = sharedBytes();
+            auto write_start = std::chrono::steady_clock::now();
+            
+            ChildReport report{};
+            report.info = write();
+            report.write_ns = nanosSince(write_start);
+            uint64_t shared_now = sharedBytes();
+            report.cow_bytes = shared_at_fork > shared_now ? shared_at_fork - shared_now : 0;
+            
+            bool sent = ::write(fds[1], &report, sizeof(report)) ==
+                        static_cast<ssize_t>(sizeof(report));
+            // No destructors or atexit handlers: they belong to the parent
+            ::_exit(sent && report.info.ok ? 0 : 1);
+        }
+        metrics_.fork_ns = nanosSince(fork_start);
+        forked_at_ = fork_start;
+    }
+    
+    ::close(fds[1]);
+    if (pid < 0) {
+        ::close(fds[0]);
+        return false;
+    }
+    child_ = pid;
+    result_fd_ = fds[0];
+    return true;
+}
+
+bool ForkSnapshot::poll() {
+    if (!running()) {
+        return true;
+    }
+    int status = 0;
+    pid_t done = ::waitpid(child_, &status, WNOHANG);
+    if (done == 0 || (done < 0 && errno == EINTR)) {
+        return false;
+    }
+    finish(done == child_ ? status : -1);
+    return true;
+}
+
+bool ForkSnapshot::wait() {
+    if (running()) {
+        int status = 0;
+        pid_t done;
+        do {
+            done = ::waitpid(child_, &status, 0);
+        } while (done < 0 && errno == EINTR);
+        finish(done == child_ ? status : -1);
+    }
+    return info_.ok;
+}
+
+void ForkSnapshot::finish(int status) {
+    metrics_.duration_ns = nanosSince(forked_at_);
+    
+    ChildReport report{};
+    bool received = ::read(result_fd_, &report, sizeof(report)) ==
+                    static_cast<ssize_t>(sizeof(report));
+    ::close(result_fd_);
+    result_fd_ = -1;
+    child_ = -1;
+    
+    if (received && status != -1 && WIFEXITED(status)) {
+        info_ = report.info;
+        metrics_.write_ns = report.write_ns;
+        metrics_.cow_bytes = report.cow_bytes;
+    }
+    info_.ok = info_.ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+} // namespace trading
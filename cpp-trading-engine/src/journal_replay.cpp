@@ -0,0 +1,410 @@
+#include "journal_replay.hpp"
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace trading {
+
+namespace {
+
+// Applies fills to the worker's positions; nothing else is reported
+struct ReplayListener : NullListener {
+    RiskManager* positions = nullptr;
+    
+    void onFill(const Fill& fill) {
+        if (positions) {
+            positions->updatePosition(fill.symbol, fill.side, fill.quantity, fill.price);
+        }
+    }
+};
+
+// Instrument record, decoded once and shared with every worker
+struct InstrumentDef {
+    SymbolId writer_id;   // Symbol id in the journaling process
+    SymbolId local_id;    // Symbol id in this process
+    InstrumentSpec spec;
+};
+
+// Everything the first, sequential pass learns about the journal
+struct JournalIndex {
+    uint64_t start_bytes = OrderJournal::HEADER_BYTES;
+    uint64_t valid_bytes = 0;
+    std::vector<InstrumentDef> instruments;       // In journal order
+    std::vector<uint64_t> rejected;               // Command sequences, ascending
+    std::vector<uint64_t> unmapped_submits;       // Submit sequences with no book
+    std::vector<uint64_t> checkpoint_hashes;      // In journal order
+    std::vector<uint64_t> checkpoint_sequences;
+    std::vector<uint64_t> commands;               // Per local symbol id
+    std::vector<size_t> owner;                    // Partition per local symbol id
+};
+
+// Symbol id mapping of the journaling process as of the current record;
+// a journal reopened by a later process may reuse ids for other names
+class SymbolMap {
+public:
+    void set(SymbolId writer_id, SymbolId local_id) {
+        if (writer_id >= local_.size()) {
+            local_.resize(static_cast<size_t>(writer_id) + 1, INVALID_SYMBOL_ID);
+        }
+        local_[writer_id] = local_id;
+    }
+    
+    SymbolId local(SymbolId writer_id) const {
+        return writer_id < local_.size() ? local_[writer_id] : INVALID_SYMBOL_ID;
+    }
+
+private:
+    std::vector<SymbolId> local_;
+};
+
+bool isCommand(CommandType type) {
+    return type == CommandType::Submit || type == CommandType::Cancel ||
+           type == CommandType::Modify;
+}
+
+// Validate the journal and index it: instruments, rejections, checkpoints
+// and the number of commands per symbol
+bool indexJournal(const std::string& path, const ReplayOptions& options,
+                  JournalIndex& index, ReplayResult& result) {
+    JournalReader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+    if (options.start_offset != 0) {
+        if (!reader.seek(options.start_offset, options.start_sequence)) {
+            return false;   // The journal ends before the start position
+        }
+        index.start_bytes = options.start_offset;
+        result.last_sequence = options.start_sequence;
+    }
+    
+    SymbolMap symbols;
+    JournalRecord record;
+    InstrumentSpec spec;
+    while (reader.next(record, spec)) {
+        result.last_sequence = record.sequence;
+        switch (record.type) {
+            case CommandType::Instrument: {
+                SymbolId local_id = internSymbol(spec.symbol);
+                symbols.set(record.symbol, local_id);
+                index.instruments.push_back(InstrumentDef{record.symbol, local_id, spec});
+                if (local_id >= index.commands.size()) {
+                    index.commands.resize(static_cast<size_t>(local_id) + 1, 0);
+                }
+                break;
+            }
+            case CommandType::Reject:
+                index.rejected.push_back(record.rejectedSequence());
+                break;
+            case CommandType::Checkpoint:
+                index.checkpoint_hashes.push_back(record.stateHash());
+                index.checkpoint_sequences.push_back(record.sequence);
+                break;
+            default: {
+                if (!isCommand(record.type)) {
+                    break;
+                }
+                SymbolId local_id = symbols.local(record.symbol);
+                if (local_id == INVALID_SYMBOL_ID && record.type == CommandType::Submit) {
+                    index.unmapped_submits.push_back(record.sequence);
+                } else if (local_id == INVALID_SYMBOL_ID) {
+                    ++result.unknown_symbol;
+                } else {
+                    ++index.commands[local_id];
+                }
+                break;
+            }
+        }
+    }
+    
+    index.valid_bytes = reader.validBytes();
+    result.truncated = reader.truncated();
+    std::sort(index.rejected.begin(), index.rejected.end());
+    
+    // A submit risk rejected before its symbol had a book is recorded
+    // without an Instrument record; anything else is an unknown symbol
+    for (uint64_t sequence : index.unmapped_submits) {
+        if (std::binary_search(index.rejected.begin(), index.rejected.end(), sequence)) {
+            ++result.rejected;
+        } else {
+            ++result.unknown_symbol;
+        }
+    }
+    return true;
+}
+
+// Longest-first onto the least loaded partition: close to balanced work.
+// Seeded books are placed too, even if the tail never touches them.
+size_t assignPartitions(JournalIndex& index, std::vector<SymbolId> symbols, size_t threads) {
+    for (const InstrumentDef& def : index.instruments) {
+        symbols.push_back(def.local_id);
+    }
+    SymbolId last = symbols.empty() ? 0 : *std::max_element(symbols.begin(), symbols.end());
+    if (last >= index.commands.size()) {
+        index.commands.resize(static_cast<size_t>(last) + 1, 0);
+    }
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+    std::stable_sort(symbols.begin(), symbols.end(), [&index](SymbolId a, SymbolId b) {
+        return index.commands[a] > index.commands[b];
+    });
+    
+    size_t partitions = std::max<size_t>(1, std::min(threads, symbols.size()));
+    std::vector<uint64_t> load(partitions, 0);
+    index.owner.assign(index.commands.size(), 0);
+    for (SymbolId symbol : symbols) {
+        size_t lightest = static_cast<size_t>(
+            std::min_element(load.begin(), load.end()) - load.begin());
+        index.owner[symbol] = lightest;
+        load[lightest] += index.commands[symbol];
+    }
+    return partitions;
+}
+
+// One partition: its symbols' books, positions and share of every hash
+class ReplayWorker {
+public:
+    ReplayWorker(size_t partition, const JournalIndex& index, bool positions,
+                 const RiskManager* base)
+        : partition_(partition), index_(index), base_(base) {
+        if (positions) {
+            engine_.listener().positions = &positions_;
+        }
+        checkpoint_hashes_.reserve(index.checkpoint_hashes.size());
+    }
+    
+    // Start from a seeded book, as it was at the start position
+    void adoptBook(std::unique_ptr<OrderBook> book) {
+        SymbolId symbol = book->symbolId();
+        double tick_size = book->instrument().tick_size;
+        book->reserveOrders(index_.commands[symbol] / 2);
+        if (symbol >= books_.size()) {
+            books_.resize(static_cast<size_t>(symbol) + 1);
+        }
+        books_[symbol] = engine_.adoptBook(std::move(book));
+        engine_.getOrCreateOrderBook(symbol)->setTimestamping(false);
+        positions_.setTickSize(symbolName(symbol), tick_size);
+        owned_.push_back(symbol);
+    }
+    
+    void run(const char* data) {
+        const char* cursor = data + index_.start_bytes;
+        const char* end = data + index_.valid_bytes;
+        std::vector<Fill> fills;
+        SymbolMap symbols;
+        size_t next_instrument = 0;
+        size_t next_reject = 0;
+        
+        while (cursor < end) {
+            JournalRecord record;
+            std::memcpy(&record, cursor, sizeof(record));
+            cursor += sizeof(record) + record.payload_size;
+            
+            if (record.type == CommandType::Instrument) {
+                const InstrumentDef& def = index_.instruments[next_instrument++];
+                symbols.set(def.writer_id, def.local_id);
+                if (owns(def.local_id)) {
+                    addBook(def);
+                }
+                continue;
+            }
+            if (record.type == CommandType::Checkpoint) {
+                checkpoint_hashes_.push_back(stateHash());
+                continue;
+            }
+            if (!isCommand(record.type)) {
+                continue;
+            }
+            
+            SymbolId local_id = symbols.local(record.symbol);
+            if (local_id == INVALID_SYMBOL_ID || !owns(local_id)) {
+                continue;
+            }
+            BookHandle book = books_[local_id];
+            
+            // Skip commands the live engine did not apply: submits risk
+            // rejected, and commands whose journal write failed
+            const std::vector<uint64_t>& rejected = index_.rejected;
+            while (next_reject < rejected.size() && rejected[next_reject] < record.sequence) {
+                ++next_reject;
+            }
+            if (next_reject < rejected.size() && rejected[next_reject] == record.sequence) {
+                ++rejected_;
+                continue;
+            }
+            
+            switch (record.type) {
+                case CommandType::Submit:
+                    engine_.submitOrder(book, record.toOrder(Timestamp()), fills);
+                    fills.clear();
+                    break;
+                case CommandType::Cancel:
+                    engine_.cancelOrder(book, record.order_id);
+                    break;
+                case CommandType::Modify:
+                    engine_.modifyOrder(book, record.order_id, record.price, record.quantity);
+                    break;
+                default:
+                    break;
+            }
+            ++commands_;
+        }
+        final_hash_ = stateHash();
+    }
+    
+    // Hand the books over with their clocks back on
+    void releaseBooks(std::vector<std::unique_ptr<OrderBook>>& books) {
+        for (auto& book : engine_.releaseBooks()) {
+            book->setTimestamping(true);
+            books.push_back(std::move(book));
+        }
+    }
+    
+    const RiskManager& positions() const { return positions_; }
+    const std::vector<uint64_t>& checkpointHashes() const { return checkpoint_hashes_; }
+    uint64_t finalHash() const { return final_hash_; }
+    uint64_t commands() const { return commands_; }
+    uint64_t rejected() const { return rejected_; }
+    uint64_t fills() const { return engine_.totalFillsGenerated(); }
+
+private:
+    size_t partition_;
+    const JournalIndex& index_;
+    BasicMatchingEngine<ReplayListener> engine_;
+    RiskManager positions_;   // Change since the start position
+    const RiskManager* base_;  // Positions at the start position, or nullptr
+    
+    // Indexed by local symbol id; valid for this partition's symbols
+    std::vector<BookHandle> books_;
+    std::vector<SymbolId> owned_;
+    
+    std::vector<uint64_t> checkpoint_hashes_;
+    uint64_t final_hash_ = 0;
+    uint64_t commands_ = 0;
+    uint64_t rejected_ = 0;
+    
+    bool owns(SymbolId local_id) const { return index_.owner[local_id] == partition_; }
+    
+    void addBook(const InstrumentDef& def) {
+        if (def.local_id >= books_.size()) {
+            books_.resize(static_cast<size_t>(def.local_id) + 1);
+        }
+        if (books_[def.local_id]) {
+            return;   // Recorded again by a later process
+        }
+        // Size the book for its share of the journal up front
+        books_[def.local_id] = engine_.registerInstrument(def.spec,
+                                                          index_.commands[def.local_id] / 2);
+        engine_.getOrCreateOrderBook(def.local_id)->setTimestamping(false);
+        positions_.setTickSize(def.spec.symbol, def.spec.tick_size);
+        owned_.push_back(def.local_id);
+    }
+    
+    // This partition's share of the engine state hash
+    uint64_t stateHash() const {
+        const RiskManager* positions = engine_.listener().positions;
+        uint64_t hash = 0;
+        for (SymbolId symbol : owned_) {
+            const OrderBook& book = *engine_.getOrderBook(books_[symbol]);
+            if (!positions) {
+                hash += symbolStateHash(book, nullptr);
+                continue;
+            }
+            Quantity position = positions->getPosition(symbol);
+            if (base_) {
+                position += base_->getPosition(symbol);
+            }
+            hash += symbolStateHash(book, position);
+        }
+        return hash;
+    }
+};
+
+} // namespace
+
+JournalReplay::JournalReplay(ReplayOptions options) : options_(options) {}
+
+void JournalReplay::seed(std::vector<std::unique_ptr<OrderBook>> books,
+                         const RiskManager* base) {
+    seed_books_ = std::move(books);
+    base_ = base;
+}
+
+ReplayResult JournalReplay::run(const std::string& path) {
+    ReplayResult result;
+    books_.clear();
+    positions_.reset();
+    
+    // Seeded books come back through books() whatever happens
+    std::vector<std::unique_ptr<OrderBook>> seeded = std::move(seed_books_);
+    const RiskManager* base = base_;
+    seed_books_.clear();
+    base_ = nullptr;
+    
+    JournalIndex index;
+    MappedFile file;
+    if (!indexJournal(path, options_, index, result) ||
+        (index.valid_bytes > index.start_bytes &&
+         !file.map(path, static_cast<size_t>(index.valid_bytes)))) {
+        books_ = std::move(seeded);
+        return result;
+    }
+    
+    size_t threads = options_.threads;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<SymbolId> seeded_symbols;
+    for (const auto& book : seeded) {
+        seeded_symbols.push_back(book->symbolId());
+    }
+    result.partitions = assignPartitions(index, std::move(seeded_symbols), threads);
+    
+    // Parallel phase: partition 0 runs on the calling thread
+    std::vector<std::unique_ptr<ReplayWorker>> workers;
+    for (size_t p = 0; p < result.partitions; ++p) {
+        workers.push_back(std::make_unique<ReplayWorker>(p, index, options_.positions, base));
+    }
+    for (auto& book : seeded) {
+        workers[index.owner[book->symbolId()]]->adoptBook(std::move(book));
+    }
+    if (file.data()) {
+        std::vector<std::thread> threads_running;
+        for (size_t p = 1; p < workers.size(); ++p) {
+            threads_running.emplace_back([&workers, &file, p] { workers[p]->run(file.data()); });
+        }
+        workers[0]->run(file.data());
+        for (std::thread& thread : threads_running) {
+            thread.join();
+        }
+    }
+    
+    // Merge: books and positions, then the hash shares
+    for (const auto& worker : workers) {
+        worker->releaseBooks(books_);
+        positions_.addPositions(worker->positions());
+        result.commands += worker->commands();
+        result.rejected += worker->rejected();
+        result.fills += worker->fills();
+        result.state_hash += worker->finalHash();
+    }
+    result.books = books_.size();
+    
+    result.ok = true;
+    for (size_t c = 0; c < index.checkpoint_hashes.size(); ++c) {
+        uint64_t hash = 0;
+        for (const auto& worker : workers) {
+            hash += worker->checkpointHashes()[c];
+        }
+        if (hash != index.checkpoint_hashes[c]) {
+            result.mismatch_sequence = index.checkpoint_sequences[c];
+            result.ok = false;
+            break;
+        }
+        ++result.checkpoints;
+    }
+    return result;
+}
+
+} // namespace trading
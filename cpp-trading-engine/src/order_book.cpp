@@ -1,9 +1,16 @@
 #include "order_book.hpp"
+#include "state_hash.hpp"
 #include <algorithm>
 
 namespace trading {
 
-OrderBook::OrderBook(const Symbol& symbol) : symbol_(symbol) {}
+OrderBook::OrderBook(const Symbol& symbol) : OrderBook(InstrumentSpec(symbol)) {}
+
+OrderBook::OrderBook(const InstrumentSpec& spec)
+    : spec_(spec)
+    , symbol_id_(internSymbol(spec.symbol))
+    , bid_levels_(Side::Buy, spec)
+    , ask_levels_(Side::Sell, spec) {}
 
 /**
  * @brief Validate order parameters
@@ -11,7 +18,9 @@ OrderBook::OrderBook(const Symbol& symbol) : symbol_(symbol) {}
  * @return true if order is valid
  */
 bool OrderBook::isValidOrder(const Order& order) const {
-    return order.remaining_qty() > 0 && order.price >= 0;
+    const auto& ladder = (order.side == Side::Buy) ? bid_levels_ : ask_levels_;
+    return order.remaining_qty() > 0 && order.price >= 0 &&
+           ladder.accepts(order.price);
 }
 
 bool OrderBook::addOrder(Order order) {
@@ -20,123 +29,150 @@ bool OrderBook::addOrder(Order order) {
     }
     
     // Check for duplicate order ID
-    if (order_lookup_.find(order.id) != order_lookup_.end()) {
+    if (order_lookup_.contains(order.id)) {
         return false;
     }
     
     // Get the appropriate side
-    if (order.side == Side::Buy) {
-        auto& level = bid_levels_[order.price];
-        if (level.orders.empty()) {
-            level.price = order.price;
-        }
-        level.orders.push_back(order);
-        level.total_quantity += order.remaining_qty();
-        
-        auto iter = std::prev(level.orders.end());
-        order_lookup_[order.id] = {Side::Buy, order.price, iter};
-        bid_orders_[order.id] = &(*iter);
-    } else {
-        auto& level = ask_levels_[order.price];
-        if (level.orders.empty()) {
-            level.price = order.price;
-        }
-        level.orders.push_back(order);
-        level.total_quantity += order.remaining_qty();
-        
-        auto iter = std::prev(level.orders.end());
-        order_lookup_[order.id] = {Side::Sell, order.price, iter};
-        ask_orders_[order.id] = &(*iter);
-    }
+    auto& ladder = levels(order.side);
+    auto& level = ladder.insert(order.price);
+    OrderNode* node = order_pool_.acquire(order);
+    node->level = &level;
+    level.orders.push_back(node);
+    level.total_quantity += order.remaining_qty();
     
+    order_lookup_.insert(order.id, node);
+    ++sideCount(order.side);
+    
+    levelChanged(order.side, level.price, &level);
+    ++version_;
+    publish(MboEventType::Add, order.id, order.side, order.price, order.remaining_qty());
+    publishTop();
     return true;
 }
 
 bool OrderBook::cancelOrder(OrderId order_id) {
-    auto it = order_lookup_.find(order_id);
-    if (it == order_lookup_.end()) {
+    OrderNode* node = order_lookup_.find(order_id);
+    if (!node) {
         return false;
     }
     
-    const auto& loc = it->second;
+    Side side = node->order.side;
+    auto& level = *node->level;
     
-    if (loc.side == Side::Buy) {
-        auto level_it = bid_levels_.find(loc.price);
-        if (level_it != bid_levels_.end()) {
-            level_it->second.total_quantity -= loc.iter->remaining_qty();
-            level_it->second.orders.erase(loc.iter);
-            
-            if (level_it->second.orders.empty()) {
-                bid_levels_.erase(level_it);
-            }
-        }
-        bid_orders_.erase(order_id);
-    } else {
-        auto level_it = ask_levels_.find(loc.price);
-        if (level_it != ask_levels_.end()) {
-            level_it->second.total_quantity -= loc.iter->remaining_qty();
-            level_it->second.orders.erase(loc.iter);
-            
-            if (level_it->second.orders.empty()) {
-                ask_levels_.erase(level_it);
-            }
-        }
-        ask_orders_.erase(order_id);
+    Price price = level.price;
+    Quantity removed = node->order.remaining_qty();
+    
+    level.total_quantity -= removed;
+    level.orders.erase(node);
+    order_pool_.release(node);
+    bool emptied = level.orders.empty();
+    if (emptied) {
+        levels(side).erase(price);
     }
     
-    order_lookup_.erase(it);
+    --sideCount(side);
+    order_lookup_.erase(order_id);
+    
+    levelChanged(side, price, emptied ? nullptr : &level);
+    ++version_;
+    publish(MboEventType::Delete, order_id, side, price, removed);
+    publishTop();
     return true;
 }
 
 bool OrderBook::modifyOrder(OrderId order_id, Price new_price, Quantity new_quantity) {
-    auto it = order_lookup_.find(order_id);
-    if (it == order_lookup_.end()) {
+    OrderNode* node = order_lookup_.find(order_id);
+    if (!node) {
         return false;
     }
     
-    const auto& loc = it->second;
-    Order old_order = *loc.iter;
+    Order old_order = node->order;
     
     // If price changes, need to remove and re-add
-    if (new_price > 0 && new_price != loc.price) {
+    if (new_price > 0 && new_price != old_order.price) {
+        if (!levels(old_order.side).accepts(new_price)) {
+            return false;
+        }
         cancelOrder(order_id);
         old_order.price = new_price;
         if (new_quantity > 0) {
             old_order.quantity = new_quantity;
         }
-        old_order.timestamp = std::chrono::steady_clock::now();
+        old_order.timestamp = timestamping_ ? std::chrono::steady_clock::now() : Timestamp();
         return addOrder(old_order);
     }
     
     // Price unchanged, just modify quantity
-    if (new_quantity > 0 && new_quantity != loc.iter->quantity) {
-        Quantity diff = new_quantity - loc.iter->quantity;
-        loc.iter->quantity = new_quantity;
+    if (new_quantity > 0 && new_quantity != node->order.quantity) {
+        Quantity diff = new_quantity - node->order.quantity;
+        node->order.quantity = new_quantity;
+        node->level->total_quantity += diff;
         
-        if (loc.side == Side::Buy) {
-            bid_levels_[loc.price].total_quantity += diff;
-        } else {
-            ask_levels_[loc.price].total_quantity += diff;
-        }
+        levelChanged(old_order.side, old_order.price, node->level);
+        ++version_;
+        publish(MboEventType::Modify, order_id, old_order.side, old_order.price,
+                node->order.remaining_qty());
+        publishTop();
+    }
+    
+    return true;
+}
+
+bool OrderBook::restoreLevel(Side side, Price price, Span<const Order> orders) {
+    auto& ladder = levels(side);
+    if (orders.empty() || price < 0 || !ladder.accepts(price)) {
+        return false;
     }
     
+    auto& level = ladder.insert(price);
+    for (const Order& order : orders) {
+        OrderNode* node = nullptr;
+        if (order.remaining_qty() > 0) {
+            node = order_pool_.acquire(order);
+            if (!order_lookup_.insert(order.id, node)) {
+                order_pool_.release(node);
+                node = nullptr;
+            }
+        }
+        if (!node) {
+            if (level.orders.empty()) {
+                ladder.erase(price);
+            }
+            return false;
+        }
+        node->order.symbol = symbol_id_;
+        node->order.side = side;
+        node->order.price = price;
+        node->level = &level;
+        level.orders.push_back(node);
+        level.total_quantity += order.remaining_qty();
+        ++sideCount(side);
+    }
     return true;
 }
 
+void OrderBook::finishRestore() {
+    bid_depth_.rebuild(bid_levels_);
+    ask_depth_.rebuild(ask_levels_);
+    ++version_;
+    publishTop();
+}
+
 std::optional<std::pair<Price, Quantity>> OrderBook::getBestBid() const {
-    if (bid_levels_.empty()) {
+    const PriceLevel* best = bid_levels_.best();
+    if (!best) {
         return std::nullopt;
     }
-    const auto& best = bid_levels_.begin()->second;
-    return std::make_pair(best.price, best.total_quantity);
+    return std::make_pair(best->price, best->total_quantity);
 }
 
 std::optional<std::pair<Price, Quantity>> OrderBook::getBestAsk() const {
-    if (ask_levels_.empty()) {
+    const PriceLevel* best = ask_levels_.best();
+    if (!best) {
         return std::nullopt;
     }
-    const auto& best = ask_levels_.begin()->second;
-    return std::make_pair(best.price, best.total_quantity);
+    return std::make_pair(best->price, best->total_quantity);
 }
 
 std::optional<Price> OrderBook::getSpread() const {
@@ -150,7 +186,7 @@ std::optional<Price> OrderBook::getSpread() const {
     return ask->first - bid->first;
 }
 
-std::optional<Price> OrderBook::getMidPrice() const {
+std::optional<double> OrderBook::getMidPrice() const {
     auto bid = getBestBid();
     auto ask = getBestAsk();
     
@@ -158,160 +194,80 @@ std::optional<Price> OrderBook::getMidPrice() const {
         return std::nullopt;
     }
     
-    return (bid->first + ask->first) / 2.0;
+    return static_cast<double>(bid->first + ask->first) / 2.0;
 }
 
 const Order* OrderBook::getOrder(OrderId order_id) const {
-    auto it = order_lookup_.find(order_id);
-    if (it == order_lookup_.end()) {
-        return nullptr;
-    }
-    return &(*it->second.iter);
+    const OrderNode* node = order_lookup_.find(order_id);
+    return node ? &node->order : nullptr;
 }
 
-std::vector<PriceLevel> OrderBook::getBidLevels(size_t levels) const {
-    std::vector<PriceLevel> result;
+std::vector<PriceLevelSnapshot> OrderBook::getBidLevels(size_t levels) const {
+    std::vector<PriceLevelSnapshot> result;
     result.reserve(levels);
     
-    size_t count = 0;
-    for (const auto& [price, level] : bid_levels_) {
-        if (count >= levels) break;
-        result.push_back(level);
-        ++count;
+    if (levels == 0) {
+        return result;
     }
+    bid_levels_.forEach([&](const PriceLevel& level) {
+        result.emplace_back(level);
+        return result.size() < levels;
+    });
     
     return result;
 }
 
-std::vector<PriceLevel> OrderBook::getAskLevels(size_t levels) const {
-    std::vector<PriceLevel> result;
+std::vector<PriceLevelSnapshot> OrderBook::getAskLevels(size_t levels) const {
+    std::vector<PriceLevelSnapshot> result;
     result.reserve(levels);
     
-    size_t count = 0;
-    for (const auto& [price, level] : ask_levels_) {
-        if (count >= levels) break;
-        result.push_back(level);
-        ++count;
+    if (levels == 0) {
+        return result;
     }
+    ask_levels_.forEach([&](const PriceLevel& level) {
+        result.emplace_back(level);
+        return result.size() < levels;
+    });
     
     return result;
 }
 
-std::vector<Fill> OrderBook::executeFill(Side aggressor_side, Quantity quantity,
-                                          Price limit_price, OrderId aggressor_id) {
-    std::vector<Fill> fills;
-    Quantity remaining = quantity;
-    
-    // Match against ask side for buy orders
-    if (aggressor_side == Side::Buy) {
-        while (remaining > 0 && !ask_levels_.empty()) {
-            auto level_it = ask_levels_.begin();
-            auto& level = level_it->second;
-            
-            // Check price limit
-            if (limit_price > 0 && level.price > limit_price) {
-                break;
-            }
-            
-            // Match against orders at this price level
-            while (remaining > 0 && !level.orders.empty()) {
-                auto& passive_order = level.orders.front();
-                
-                Quantity fill_qty = std::min(remaining, passive_order.remaining_qty());
-                
-                // Create fill
-                fills.emplace_back(
-                    aggressor_id,
-                    passive_order.id,
-                    symbol_,
-                    aggressor_side,
-                    level.price,
-                    fill_qty
-                );
-                
-                // Update passive order
-                passive_order.apply_fill(fill_qty);
-                level.total_quantity -= fill_qty;
-                remaining -= fill_qty;
-                
-                // Remove filled order
-                if (passive_order.is_filled()) {
-                    OrderId filled_id = passive_order.id;
-                    level.orders.pop_front();
-                    order_lookup_.erase(filled_id);
-                    ask_orders_.erase(filled_id);
-                }
-            }
-            
-            // Remove empty price level
-            if (level.orders.empty()) {
-                ask_levels_.erase(level_it);
-            }
-        }
-    }
-    // Match against bid side for sell orders
-    else {
-        while (remaining > 0 && !bid_levels_.empty()) {
-            auto level_it = bid_levels_.begin();
-            auto& level = level_it->second;
-            
-            // Check price limit
-            if (limit_price > 0 && level.price < limit_price) {
-                break;
-            }
-            
-            // Match against orders at this price level
-            while (remaining > 0 && !level.orders.empty()) {
-                auto& passive_order = level.orders.front();
-                
-                Quantity fill_qty = std::min(remaining, passive_order.remaining_qty());
-                
-                // Create fill
-                fills.emplace_back(
-                    aggressor_id,
-                    passive_order.id,
-                    symbol_,
-                    aggressor_side,
-                    level.price,
-                    fill_qty
-                );
-                
-                // Update passive order
-                passive_order.apply_fill(fill_qty);
-                level.total_quantity -= fill_qty;
-                remaining -= fill_qty;
-                
-                // Remove filled order
-                if (passive_order.is_filled()) {
-                    OrderId filled_id = passive_order.id;
-                    level.orders.pop_front();
-                    order_lookup_.erase(filled_id);
-                    bid_orders_.erase(filled_id);
-                }
-            }
-            
-            // Remove empty price level
-            if (level.orders.empty()) {
-                bid_levels_.erase(level_it);
+size_t OrderBook::getDepth(Side side, DepthLevel* out, size_t max_levels) const {
+    return visitDepth(side, max_levels, [&out](const DepthLevel& level) {
+        *out++ = level;
+        return true;
+    });
+}
+
+uint64_t OrderBook::stateHash() const {
+    uint64_t hash = 0;
+    for (Side side : {Side::Buy, Side::Sell}) {
+        hash = hashCombine(hash, static_cast<uint64_t>(side));
+        levels(side).forEach([&hash](const PriceLevel& level) {
+            hash = hashCombine(hash, static_cast<uint64_t>(level.price));
+            for (const Order& order : level.orders) {
+                hash = hashCombine(hash, order.id);
+                hash = hashCombine(hash, static_cast<uint64_t>(order.quantity));
+                hash = hashCombine(hash, static_cast<uint64_t>(order.filled_qty));
             }
-        }
+            return true;
+        });
     }
-    
-    return fills;
+    return hash;
 }
 
-void OrderBook::cleanupLevel(Side side, Price price) {
-    if (side == Side::Buy) {
-        auto it = bid_levels_.find(price);
-        if (it != bid_levels_.end() && it->second.orders.empty()) {
-            bid_levels_.erase(it);
-        }
-    } else {
-        auto it = ask_levels_.find(price);
-        if (it != ask_levels_.end() && it->second.orders.empty()) {
-            ask_levels_.erase(it);
-        }
-    }
+Quantity OrderBook::executeFill(Side aggressor_side, Quantity quantity,
+                                Price limit_price, OrderId aggressor_id,
+                                std::vector<Fill>& fills) {
+    return executeFill(aggressor_side, quantity, limit_price, aggressor_id,
+                       [&fills](const Fill& fill) { fills.push_back(fill); });
+}
+
+std::vector<Fill> OrderBook::executeFill(Side aggressor_side, Quantity quantity,
+                                          Price limit_price, OrderId aggressor_id) {
+    std::vector<Fill> fills;
+    executeFill(aggressor_side, quantity, limit_price, aggressor_id, fills);
+    return fills;
 }
 
 } // namespace trading
@@ -0,0 +1,38 @@
+#include "order_index.hpp"
+
+namespace trading {
+
+void OrderIndex::reserve(size_t entries) {
+    size_t needed = slots_.size();
+    while (entries * MAX_LOAD_DEN > needed * MAX_LOAD_NUM) {
+        needed *= 2;
+    }
+    if (needed != slots_.size()) {
+        rehash(needed);
+    }
+}
+
+void OrderIndex::rehash(size_t capacity) {
+    // Round up to a power of two (at least 16 slots)
+    size_t slots = 16;
+    while (slots < capacity) {
+        slots *= 2;
+    }
+    
+    std::vector<Slot> old = std::move(slots_);
+    slots_.assign(slots, Slot{});
+    mask_ = slots - 1;
+    shift_ = 64;
+    for (size_t n = slots; n > 1; n >>= 1) {
+        --shift_;
+    }
+    size_ = 0;
+    
+    for (const Slot& slot : old) {
+        if (slot.node) {
+            insert(slot.id, slot.node);
+        }
+    }
+}
+
+} // namespace trading
@@ -0,0 +1,422 @@
+#include "order_journal.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace trading {
+
+namespace {
+
+// File header: identifies the format before the first record
+struct JournalHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(JournalHeader) == OrderJournal::HEADER_BYTES, "journal header size");
+
+constexpr char JOURNAL_MAGIC[4] = {'T', 'R', 'J', 'L'};
+
+bool validHeader(const JournalHeader& header) {
+    return std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) == 0 &&
+           header.version == OrderJournal::FORMAT_VERSION &&
+           header.record_size == sizeof(JournalRecord);
+}
+
+// write(2) the whole range, retrying short writes and interrupts; written
+// says how much made it out, also on failure
+bool writeAll(int fd, const char* data, size_t size, size_t& written) {
+    written = 0;
+    while (written < size) {
+        ssize_t result = ::write(fd, data + written, size - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+    size_t written = 0;
+    return writeAll(fd, data, size, written);
+}
+
+} // namespace
+
+JournalRecord JournalRecord::submit(const Order& order) {
+    JournalRecord record;
+    record.type = CommandType::Submit;
+    record.order_id = order.id;
+    record.symbol = order.symbol;
+    record.side = order.side;
+    record.order_type = order.type;
+    record.price = order.price;
+    record.quantity = order.quantity;
+    return record;
+}
+
+JournalRecord JournalRecord::cancel(SymbolId symbol, OrderId order_id) {
+    JournalRecord record;
+    record.type = CommandType::Cancel;
+    record.symbol = symbol;
+    record.order_id = order_id;
+    return record;
+}
+
+JournalRecord JournalRecord::modify(SymbolId symbol, OrderId order_id,
+                                    Price new_price, Quantity new_quantity) {
+    JournalRecord record;
+    record.type = CommandType::Modify;
+    record.symbol = symbol;
+    record.order_id = order_id;
+    record.price = new_price;
+    record.quantity = new_quantity;
+    return record;
+}
+
+JournalRecord JournalRecord::reject(SymbolId symbol, OrderId order_id,
+                                    uint64_t submit_sequence) {
+    JournalRecord record;
+    record.type = CommandType::Reject;
+    record.symbol = symbol;
+    record.order_id = order_id;
+    record.quantity = static_cast<Quantity>(submit_sequence);
+    return record;
+}
+
+JournalRecord JournalRecord::checkpoint(uint64_t state_hash) {
+    JournalRecord record;
+    record.type = CommandType::Checkpoint;
+    record.order_id = state_hash;
+    return record;
+}
+
+uint32_t OrderJournal::checksum(const void* record, size_t record_size,
+                                const void* payload, size_t payload_size) {
+    // FNV-1a over 32-bit words: cheap, and enough to reject a torn or
+    // garbled tail
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        size_t i = 0;
+        for (; i + sizeof(uint32_t) <= size; i += sizeof(uint32_t)) {
+            uint32_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            hash = (hash ^ word) * 16777619u;
+        }
+        for (; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+    };
+    mix(record, record_size);
+    if (payload_size > 0) {
+        mix(payload, payload_size);
+    }
+    return hash;
+}
+
+OrderJournal::~OrderJournal() {
+    close();
+}
+
+bool OrderJournal::open(const std::string& path, const JournalOptions& options) {
+    close();
+    
+    // Find where the valid part of an existing journal ends
+    uint64_t valid_bytes = 0;
+    uint64_t last_sequence = 0;
+    struct stat info;
+    if (::stat(path.c_str(), &info) == 0 && info.st_size > 0) {
+        JournalReader reader;
+        if (!reader.open(path)) {
+            return false;   // Something else lives here; leave it alone
+        }
+        JournalRecord record;
+        InstrumentSpec spec;
+        while (reader.next(record, spec)) {
+            last_sequence = record.sequence;
+        }
+        valid_bytes = reader.validBytes();
+    }
+    
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    
+    if (valid_bytes == 0) {
+        // New file: start it with a header
+        JournalHeader header{};
+        std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        header.version = FORMAT_VERSION;
+        header.record_size = sizeof(JournalRecord);
+        if (::ftruncate(fd, 0) != 0 ||
+            !writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header))) {
+            ::close(fd);
+            return false;
+        }
+        valid_bytes = sizeof(header);
+    } else if (::ftruncate(fd, static_cast<off_t>(valid_bytes)) != 0) {
+        // Cut off a torn tail so new records follow the last valid one
+        ::close(fd);
+        return false;
+    }
+    
+    if (::lseek(fd, static_cast<off_t>(valid_bytes), SEEK_SET) < 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    fd_ = fd;
+    options_ = options;
+    if (options_.group_size == 0) {
+        options_.group_size = 1;
+    }
+    buffer_.clear();
+    buffer_.reserve(options_.buffer_bytes);
+    pending_ = 0;
+    failed_ = false;
+    unrecorded_ = false;
+    sequence_ = last_sequence;
+    committed_sequence_ = last_sequence;
+    synced_sequence_ = last_sequence;
+    end_offset_ = valid_bytes;
+    last_sync_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+void OrderJournal::close() {
+    if (fd_ < 0) {
+        return;
+    }
+    
+    commit();
+    if (options_.fsync != FsyncPolicy::None) {
+        syncFile();
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+uint64_t OrderJournal::appendInstrument(SymbolId symbol, const InstrumentSpec& spec) {
+    if (spec.symbol.size() > MAX_SYMBOL_BYTES) {
+        unrecorded_ = true;
+        return 0;
+    }
+    
+    JournalInstrument instrument{};
+    instrument.tick_size = spec.tick_size;
+    instrument.price_decimals = spec.price_decimals;
+    instrument.layout = spec.layout;
+    instrument.band_low = spec.band_low;
+    instrument.band_ticks = spec.band_ticks;
+    
+    std::vector<char> payload(sizeof(instrument) + spec.symbol.size());
+    std::memcpy(payload.data(), &instrument, sizeof(instrument));
+    std::memcpy(payload.data() + sizeof(instrument), spec.symbol.data(), spec.symbol.size());
+    
+    JournalRecord record;
+    record.type = CommandType::Instrument;
+    record.symbol = symbol;
+    record.sequence = ++sequence_;
+    record.payload_size = static_cast<uint32_t>(payload.size());
+    record.checksum = checksum(&record, sizeof(record), payload.data(), payload.size());
+    buffer(&record, sizeof(record));
+    buffer(payload.data(), payload.size());
+    end_offset_ += sizeof(record) + payload.size();
+    
+    // Book creation is rare; make it visible with the commands that follow
+    ++pending_;
+    return record.sequence;
+}
+
+bool OrderJournal::commit() {
+    if (fd_ < 0) {
+        return false;
+    }
+    if (buffer_.empty() && !failed_) {
+        return true;
+    }
+    
+    // Whatever did not make it out stays buffered for the next commit
+    size_t written = 0;
+    bool ok = writeAll(fd_, buffer_.data(), buffer_.size(), written);
+    bytes_written_ += written;
+    buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(written));
+    ++commits_;
+    if (!ok) {
+        failed_ = true;
+        return false;
+    }
+    pending_ = 0;
+    committed_sequence_ = sequence_;
+    
+    // A failed sync is retried by the next commit, due or not
+    bool synced = true;
+    switch (options_.fsync) {
+        case FsyncPolicy::None:
+            break;
+        case FsyncPolicy::PerBatch:
+            synced = syncFile();
+            break;
+        case FsyncPolicy::Periodic:
+            if (failed_ ||
+                std::chrono::steady_clock::now() - last_sync_ >= options_.sync_interval) {
+                synced = syncFile();
+            }
+            break;
+    }
+    failed_ = !synced;
+    return synced;
+}
+
+bool OrderJournal::sync() {
+    if (!commit() || !syncFile()) {
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool OrderJournal::flushIdle() {
+    if (buffer_.empty() && !failed_ &&
+        (options_.fsync == FsyncPolicy::None || synced_sequence_ == committed_sequence_)) {
+        return true;
+    }
+    if (!commit()) {
+        return false;
+    }
+    if (options_.fsync != FsyncPolicy::None && synced_sequence_ != committed_sequence_ &&
+        !syncFile()) {
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool OrderJournal::syncFile() {
+    if (fd_ < 0) {
+        return false;
+    }
+    
+    ++syncs_;
+    last_sync_ = std::chrono::steady_clock::now();
+    if (::fdatasync(fd_) != 0) {
+        return false;
+    }
+    synced_sequence_ = committed_sequence_;
+    return true;
+}
+
+JournalReader::~JournalReader() {
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+bool JournalReader::open(const std::string& path) {
+    if (file_) {
+        std::fclose(file_);
+    }
+    file_ = std::fopen(path.c_str(), "rb");
+    offset_ = 0;
+    last_sequence_ = 0;
+    truncated_ = false;
+    if (!file_) {
+        return false;
+    }
+    
+    JournalHeader header;
+    if (std::fread(&header, sizeof(header), 1, file_) != 1 || !validHeader(header)) {
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    offset_ = sizeof(header);
+    return true;
+}
+
+bool JournalReader::seek(uint64_t offset, uint64_t last_sequence) {
+    if (!file_ || offset < sizeof(JournalHeader) || std::fseek(file_, 0, SEEK_END) != 0 ||
+        std::ftell(file_) < static_cast<long>(offset) ||
+        std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0) {
+        return false;
+    }
+    offset_ = offset;
+    last_sequence_ = last_sequence;
+    truncated_ = false;
+    return true;
+}
+
+bool JournalReader::next(JournalRecord& record, InstrumentSpec& spec) {
+    if (!file_ || truncated_) {
+        return false;
+    }
+    
+    size_t got = std::fread(&record, 1, sizeof(record), file_);
+    if (got != sizeof(record)) {
+        truncated_ = got != 0;
+        return false;
+    }
+    
+    // Only Instrument records have a payload, and a bounded one; a bigger
+    // size is a torn or garbage header, read before the checksum can be
+    // checked, and must not turn into a huge allocation
+    size_t payload_limit =
+        record.type == CommandType::Instrument ? OrderJournal::MAX_PAYLOAD_BYTES : 0;
+    if (record.payload_size > payload_limit) {
+        truncated_ = true;
+        return false;
+    }
+    
+    payload_.resize(record.payload_size);
+    if (record.payload_size > 0 &&
+        std::fread(payload_.data(), 1, payload_.size(), file_) != payload_.size()) {
+        truncated_ = true;
+        return false;
+    }
+    
+    uint32_t stored = record.checksum;
+    record.checksum = 0;
+    bool valid = checksumMatches(record, stored) &&
+                 record.sequence == last_sequence_ + 1;
+    record.checksum = stored;
+    if (!valid) {
+        truncated_ = true;
+        return false;
+    }
+    
+    if (record.type == CommandType::Instrument) {
+        JournalInstrument instrument;
+        if (payload_.size() < sizeof(instrument)) {
+            truncated_ = true;
+            return false;
+        }
+        std::memcpy(&instrument, payload_.data(), sizeof(instrument));
+        spec = InstrumentSpec(Symbol(payload_.data() + sizeof(instrument),
+                                     payload_.size() - sizeof(instrument)),
+                              instrument.tick_size, instrument.price_decimals);
+        if (instrument.layout == BookLayout::Array) {
+            spec.withArrayLadder(instrument.band_low, instrument.band_ticks);
+        }
+    }
+    
+    last_sequence_ = record.sequence;
+    offset_ += sizeof(record) + record.payload_size;
+    return true;
+}
+
+bool JournalReader::checksumMatches(const JournalRecord& record, uint32_t stored) const {
+    return OrderJournal::checksum(&record, sizeof(record),
+                                  payload_.data(), payload_.size()) == stored;
+}
+
+} // namespace trading
@@ -0,0 +1,25 @@
+#include "order_pool.hpp"
+
+namespace trading {
+
+void OrderPool::reserve(size_t nodes) {
+    while (capacity_ - in_use_ < nodes) {
+        grow();
+    }
+}
+
+void OrderPool::grow() {
+    std::unique_ptr<OrderNode[]> slab(new OrderNode[slab_size_]);
+    
+    // Thread the new nodes onto the free list so they are handed out in
+    // address order
+    for (size_t i = slab_size_; i-- > 0;) {
+        slab[i].next = free_list_;
+        free_list_ = &slab[i];
+    }
+    
+    slabs_.push_back(std::move(slab));
+    capacity_ += slab_size_;
+}
+
+} // namespace trading
@@ -0,0 +1,84 @@
+#include "price_ladder.hpp"
+
+namespace trading {
+
+PriceLadder::PriceLadder(Side side, const InstrumentSpec& spec)
+    : side_(side)
+    , layout_(spec.layout)
+    , band_low_(spec.band_low)
+    , band_high_(spec.band_low + spec.band_ticks - 1)
+    , best_index_(0)
+    , level_count_(0) {
+    if (layout_ == BookLayout::Array && spec.band_ticks > 0) {
+        slots_.reserve(static_cast<size_t>(spec.band_ticks));
+        for (Price i = 0; i < spec.band_ticks; ++i) {
+            slots_.emplace_back(side_ == Side::Buy ? band_high_ - i : band_low_ + i);
+        }
+        occupied_ = PriceBitmap(slots_.size());
+    } else if (layout_ == BookLayout::Array) {
+        // An empty band accepts nothing
+        band_high_ = band_low_ - 1;
+    }
+}
+
+PriceLevel* PriceLadder::find(Price price) {
+    if (layout_ == BookLayout::Array) {
+        if (!accepts(price)) {
+            return nullptr;
+        }
+        size_t index = slotIndex(price);
+        return occupied_.test(index) ? &slots_[index] : nullptr;
+    }
+    
+    auto it = map_levels_.find(mapKey(price));
+    return it != map_levels_.end() ? &it->second : nullptr;
+}
+
+const PriceLevel* PriceLadder::nextAfter(Price price) const {
+    if (layout_ == BookLayout::Array) {
+        size_t next = occupied_.findNext(slotIndex(price) + 1);
+        return next != PriceBitmap::npos ? &slots_[next] : nullptr;
+    }
+    
+    auto it = map_levels_.upper_bound(mapKey(price));
+    return it != map_levels_.end() ? &it->second : nullptr;
+}
+
+PriceLevel& PriceLadder::insert(Price price) {
+    if (layout_ == BookLayout::Array) {
+        size_t index = slotIndex(price);
+        if (!occupied_.test(index)) {
+            occupied_.set(index);
+            if (level_count_ == 0 || index < best_index_) {
+                best_index_ = index;
+            }
+            ++level_count_;
+        }
+        return slots_[index];
+    }
+    
+    auto [it, inserted] = map_levels_.try_emplace(mapKey(price), price);
+    return it->second;
+}
+
+void PriceLadder::erase(Price price) {
+    if (layout_ == BookLayout::Array) {
+        size_t index = slotIndex(price);
+        if (!occupied_.test(index)) {
+            return;
+        }
+        occupied_.clear(index);
+        slots_[index].total_quantity = 0;
+        --level_count_;
+        
+        // Jump straight to the next occupied slot when the touch empties
+        if (index == best_index_ && level_count_ > 0) {
+            best_index_ = occupied_.findNext(index + 1);
+        }
+        return;
+    }
+    
+    map_levels_.erase(mapKey(price));
+}
+
+} // namespace trading
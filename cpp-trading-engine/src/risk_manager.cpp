@@ -7,6 +7,8 @@ RiskManager::RiskManager()
     : rate_window_start_(std::chrono::steady_clock::now()) {}
 
 RiskCheckResult RiskManager::checkOrder(const Order& order) {
+    auto lock = guard();
+    
     // Check order rate limit
     auto rate_check = checkOrderRate();
     if (!rate_check) {
@@ -34,47 +36,91 @@ RiskCheckResult RiskManager::checkOrder(const Order& order) {
     return RiskCheckResult(true);
 }
 
-void RiskManager::updatePosition(const Symbol& symbol, Side side,
+RiskManager::SymbolRisk* RiskManager::entry(SymbolId symbol) {
+    if (symbol >= symbols_.size()) {
+        if (!isInternedSymbol(symbol)) {
+            return nullptr;
+        }
+        symbols_.resize(static_cast<size_t>(symbol) + 1);
+    }
+    return &symbols_[symbol];
+}
+
+void RiskManager::updatePosition(SymbolId symbol, Side side,
                                   Quantity quantity, Price price) {
+    auto lock = guard();
     Quantity direction = (side == Side::Buy) ? 1 : -1;
-    Quantity position_change = direction * quantity;
+    SymbolRisk* risk = entry(symbol);
+    if (!risk) {
+        return;
+    }
     
-    positions_[symbol] += position_change;
+    risk->position += direction * quantity;
     
-    // Update average price and notional exposure
-    double notional = price * quantity;
+    // Update notional exposure
+    double notional = fromTicks(price, risk->tick_size) * quantity;
     if (direction > 0) {
-        notional_exposures_[symbol] += notional;
+        risk->notional_exposure += notional;
     } else {
-        notional_exposures_[symbol] -= notional;
+        risk->notional_exposure -= notional;
     }
 }
 
+void RiskManager::updatePosition(const Symbol& symbol, Side side,
+                                  Quantity quantity, Price price) {
+    updatePosition(internSymbol(symbol), side, quantity, price);
+}
+
+void RiskManager::setTickSize(const Symbol& symbol, double tick_size) {
+    entry(internSymbol(symbol))->tick_size = tick_size;
+}
+
+double RiskManager::getTickSize(SymbolId symbol) const {
+    const SymbolRisk* risk = find(symbol);
+    return risk ? risk->tick_size : DEFAULT_TICK_SIZE;
+}
+
+double RiskManager::getTickSize(const Symbol& symbol) const {
+    return getTickSize(findSymbol(symbol));
+}
+
 void RiskManager::setPositionLimit(const Symbol& symbol, Quantity limit) {
-    position_limits_[symbol] = limit;
+    entry(internSymbol(symbol))->position_limit = limit;
+}
+
+Quantity RiskManager::getPositionLimit(SymbolId symbol) const {
+    const SymbolRisk* risk = find(symbol);
+    return risk ? risk->position_limit : DEFAULT_POSITION_LIMIT;
 }
 
 Quantity RiskManager::getPositionLimit(const Symbol& symbol) const {
-    auto it = position_limits_.find(symbol);
-    return (it != position_limits_.end()) ? it->second : DEFAULT_POSITION_LIMIT;
+    return getPositionLimit(findSymbol(symbol));
 }
 
 void RiskManager::setOrderSizeLimit(const Symbol& symbol, Quantity limit) {
-    order_size_limits_[symbol] = limit;
+    entry(internSymbol(symbol))->order_size_limit = limit;
+}
+
+Quantity RiskManager::getOrderSizeLimit(SymbolId symbol) const {
+    const SymbolRisk* risk = find(symbol);
+    return risk ? risk->order_size_limit : DEFAULT_ORDER_SIZE_LIMIT;
 }
 
 Quantity RiskManager::getOrderSizeLimit(const Symbol& symbol) const {
-    auto it = order_size_limits_.find(symbol);
-    return (it != order_size_limits_.end()) ? it->second : DEFAULT_ORDER_SIZE_LIMIT;
+    return getOrderSizeLimit(findSymbol(symbol));
 }
 
 void RiskManager::setNotionalLimit(const Symbol& symbol, double limit) {
-    notional_limits_[symbol] = limit;
+    entry(internSymbol(symbol))->notional_limit = limit;
+}
+
+double RiskManager::getNotionalLimit(SymbolId symbol) const {
+    const SymbolRisk* risk = find(symbol);
+    return risk ? risk->notional_limit : DEFAULT_NOTIONAL_LIMIT;
 }
 
 double RiskManager::getNotionalLimit(const Symbol& symbol) const {
-    auto it = notional_limits_.find(symbol);
-    return (it != notional_limits_.end()) ? it->second : DEFAULT_NOTIONAL_LIMIT;
+    return getNotionalLimit(findSymbol(symbol));
 }
 
 void RiskManager::setOrderRateLimit(size_t orders_per_second) {
@@ -93,34 +139,77 @@ void RiskManager::setGlobalNotionalLimit(double limit) {
     global_notional_limit_ = limit;
 }
 
+Quantity RiskManager::getPosition(SymbolId symbol) const {
+    auto lock = guard();
+    const SymbolRisk* risk = find(symbol);
+    return risk ? risk->position : 0;
+}
+
 Quantity RiskManager::getPosition(const Symbol& symbol) const {
-    auto it = positions_.find(symbol);
-    return (it != positions_.end()) ? it->second : 0;
+    return getPosition(findSymbol(symbol));
+}
+
+double RiskManager::getNotionalExposure(SymbolId symbol) const {
+    auto lock = guard();
+    const SymbolRisk* risk = find(symbol);
+    return risk ? risk->notional_exposure : 0.0;
 }
 
 double RiskManager::getNotionalExposure(const Symbol& symbol) const {
-    auto it = notional_exposures_.find(symbol);
-    return (it != notional_exposures_.end()) ? it->second : 0.0;
+    return getNotionalExposure(findSymbol(symbol));
 }
 
 double RiskManager::getTotalNotionalExposure() const {
+    auto lock = guard();
     double total = 0.0;
-    for (const auto& [symbol, exposure] : notional_exposures_) {
-        total += std::abs(exposure);
+    for (const SymbolRisk& risk : symbols_) {
+        total += std::abs(risk.notional_exposure);
     }
     return total;
 }
 
+void RiskManager::addPositions(const RiskManager& other) {
+    auto lock = guard();
+    for (SymbolId symbol = 0; symbol < other.symbols_.size(); ++symbol) {
+        const SymbolRisk& from = other.symbols_[symbol];
+        if (from.position != 0 || from.notional_exposure != 0.0) {
+            SymbolRisk* risk = entry(symbol);
+            risk->position += from.position;
+            risk->notional_exposure += from.notional_exposure;
+        }
+    }
+}
+
+RiskManager::GlobalRisk RiskManager::globalRisk() const {
+    GlobalRisk state;
+    state.position_limit = global_position_limit_;
+    state.notional_limit = global_notional_limit_;
+    state.order_rate_limit = order_rate_limit_;
+    state.orders_this_second = orders_this_second_;
+    return state;
+}
+
+void RiskManager::restoreGlobalRisk(const GlobalRisk& state) {
+    global_position_limit_ = state.position_limit;
+    global_notional_limit_ = state.notional_limit;
+    order_rate_limit_ = state.order_rate_limit;
+    orders_this_second_ = state.orders_this_second;
+    rate_window_start_ = std::chrono::steady_clock::now();
+}
+
 void RiskManager::reset() {
-    positions_.clear();
-    average_prices_.clear();
-    notional_exposures_.clear();
+    auto lock = guard();
+    for (SymbolRisk& risk : symbols_) {
+        risk.position = 0;
+        risk.notional_exposure = 0.0;
+    }
     orders_this_second_ = 0;
     rate_window_start_ = std::chrono::steady_clock::now();
 }
 
 RiskCheckResult RiskManager::checkPositionLimit(const Order& order) const {
-    Quantity current_pos = getPosition(order.symbol);
+    const SymbolRisk* risk = find(order.symbol);
+    Quantity current_pos = risk ? risk->position : 0;
     Quantity limit = getPositionLimit(order.symbol);
     
     Quantity direction = (order.side == Side::Buy) ? 1 : -1;
@@ -135,13 +224,12 @@ RiskCheckResult RiskManager::checkPositionLimit(const Order& order) const {
     // Check global position limit
     if (global_position_limit_ > 0) {
         Quantity total_pos = 0;
-        for (const auto& [sym, pos] : positions_) {
-            if (sym == order.symbol) {
-                total_pos += std::abs(new_pos);
-            } else {
-                total_pos += std::abs(pos);
+        for (SymbolId sym = 0; sym < symbols_.size(); ++sym) {
+            if (sym != order.symbol) {
+                total_pos += std::abs(symbols_[sym].position);
             }
         }
+        total_pos += std::abs(new_pos);
         if (total_pos > global_position_limit_) {
             return RiskCheckResult(false, "Global position limit exceeded");
         }
@@ -163,9 +251,10 @@ RiskCheckResult RiskManager::checkOrderSizeLimit(const Order& order) const {
 }
 
 RiskCheckResult RiskManager::checkNotionalLimit(const Order& order) const {
+    const SymbolRisk* risk = find(order.symbol);
     double limit = getNotionalLimit(order.symbol);
-    double current = getNotionalExposure(order.symbol);
-    double order_notional = order.price * order.quantity;
+    double current = risk ? risk->notional_exposure : 0.0;
+    double order_notional = fromTicks(order.price, getTickSize(order.symbol)) * order.quantity;
     
     Quantity direction = (order.side == Side::Buy) ? 1 : -1;
     double new_exposure = current + direction * order_notional;
@@ -179,13 +268,12 @@ RiskCheckResult RiskManager::checkNotionalLimit(const Order& order) const {
     // Check global notional limit
     if (global_notional_limit_ > 0) {
         double total_exposure = 0.0;
-        for (const auto& [sym, exp] : notional_exposures_) {
-            if (sym == order.symbol) {
-                total_exposure += std::abs(new_exposure);
-            } else {
-                total_exposure += std::abs(exp);
+        for (SymbolId sym = 0; sym < symbols_.size(); ++sym) {
+            if (sym != order.symbol) {
+                total_exposure += std::abs(symbols_[sym].notional_exposure);
             }
         }
+        total_exposure += std::abs(new_exposure);
         if (total_exposure > global_notional_limit_) {
             return RiskCheckResult(false, "Global notional limit exceeded");
         }
@@ -0,0 +1,134 @@
+#include "sharded_engine.hpp"
+#include "cpu_affinity.hpp"
+#include <algorithm>
+
+namespace trading {
+
+ShardedEngine::ShardedEngine(ShardOptions options) : options_(options) {
+    if (options_.shards == 0) {
+        options_.shards = std::max(1u, std::thread::hardware_concurrency());
+    }
+    shards_.reserve(options_.shards);
+    for (size_t i = 0; i < options_.shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>(options_, &stopping_));
+    }
+}
+
+ShardedEngine::~ShardedEngine() {
+    stop();
+}
+
+bool ShardedEngine::registerInstrument(const InstrumentSpec& spec, size_t expected_orders) {
+    if (started_) {
+        return false;
+    }
+    Shard* shard = route(internSymbol(spec.symbol));
+    return shard && shard->engine.registerInstrument(spec, expected_orders).valid();
+}
+
+bool ShardedEngine::registerSymbol(const Symbol& symbol, size_t expected_orders) {
+    InstrumentSpec spec;
+    spec.symbol = symbol;
+    return registerInstrument(spec, expected_orders);
+}
+
+bool ShardedEngine::start() {
+    if (started_) {
+        return false;
+    }
+    started_ = true;
+    stopping_.store(false, std::memory_order_release);
+    
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        Shard& shard = *shards_[i];
+        shard.thread = std::thread([&shard]() { shard.loop.run(); });
+        if (options_.pin_threads) {
+            // Best effort: the shard still runs, unpinned, if the CPU is unavailable
+            pinThread(shard.thread, options_.first_cpu + i);
+        }
+    }
+    return true;
+}
+
+void ShardedEngine::stop() {
+    if (!started_ || stopping_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    stopping_.store(true, std::memory_order_release);
+    for (auto& shard : shards_) {
+        shard->loop.stop();
+    }
+    for (auto& shard : shards_) {
+        shard->thread.join();
+    }
+}
+
+bool ShardedEngine::submit(const EngineCommand& command) {
+    if (!running()) {
+        return false;
+    }
+    
+    Shard* shard = route(command.symbol);
+    if (!shard) {
+        return false;
+    }
+    shard->commands.push(command);
+    ++shard->enqueued;
+    return true;
+}
+
+void ShardedEngine::waitIdle() const {
+    for (const auto& shard : shards_) {
+        while (shard->loop.processed() < shard->enqueued) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+uint64_t ShardedEngine::stateHash() const {
+    uint64_t hash = 0;
+    for (const auto& shard : shards_) {
+        hash += shard->engine.stateHash();
+    }
+    return hash;
+}
+
+uint64_t ShardedEngine::commandsProcessed() const {
+    uint64_t processed = 0;
+    for (const auto& shard : shards_) {
+        processed += shard->loop.processed();
+    }
+    return processed;
+}
+
+uint64_t ShardedEngine::eventsDropped() const {
+    uint64_t dropped = 0;
+    for (const auto& shard : shards_) {
+        dropped += shard->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+ShardedEngine::Shard* ShardedEngine::route(SymbolId symbol) {
+    // Sizing shard_of_ by an unchecked id would let one bad command
+    // (INVALID_SYMBOL_ID, say) allocate gigabytes
+    if (!isInternedSymbol(symbol)) {
+        return nullptr;
+    }
+    
+    uint32_t unassigned = static_cast<uint32_t>(shards_.size());
+    if (symbol >= shard_of_.size()) {
+        shard_of_.resize(static_cast<size_t>(symbol) + 1, unassigned);
+    }
+    if (shard_of_[symbol] == unassigned) {
+        auto least = std::min_element(shards_.begin(), shards_.end(),
+            [](const std::unique_ptr<Shard>& a, const std::unique_ptr<Shard>& b) {
+                return a->symbols < b->symbols;
+            });
+        ++(*least)->symbols;
+        shard_of_[symbol] = static_cast<uint32_t>(least - shards_.begin());
+    }
+    return shards_[shard_of_[symbol]].get();
+}
+
+} // namespace trading
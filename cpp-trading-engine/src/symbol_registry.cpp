@@ -0,0 +1,44 @@
+#include "symbol_registry.hpp"
+
+namespace trading {
+
+namespace {
+const Symbol UNKNOWN_SYMBOL = "";
+}
+
+SymbolRegistry& SymbolRegistry::instance() {
+    static SymbolRegistry registry;
+    return registry;
+}
+
+SymbolId SymbolRegistry::intern(const Symbol& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    
+    SymbolId id = static_cast<SymbolId>(names_.size());
+    names_.push_back(name);
+    ids_.emplace(name, id);
+    count_.store(names_.size(), std::memory_order_release);
+    return id;
+}
+
+SymbolId SymbolRegistry::find(const Symbol& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    return (it != ids_.end()) ? it->second : INVALID_SYMBOL_ID;
+}
+
+const Symbol& SymbolRegistry::name(SymbolId id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (id < names_.size()) ? names_[id] : UNKNOWN_SYMBOL;
+}
+
+size_t SymbolRegistry::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_.size();
+}
+
+} // namespace trading
@@ -0,0 +1,213 @@
+#include "../include/order_book.hpp"
+#include "../include/matching_engine.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+using namespace trading;
+
+// Global allocation counter fed by the replacement operator new below
+static size_t g_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+// Count heap allocations made while running fn
+template <typename Fn>
+static size_t allocationsDuring(Fn&& fn) {
+    size_t before = g_allocations;
+    fn();
+    return g_allocations - before;
+}
+
+// Resting orders per cycle; larger than one pool slab
+constexpr size_t kOrders = 3000;
+
+static OrderBook makeBook() {
+    InstrumentSpec spec("AAPL");
+    spec.withArrayLadder(10000, 1000);
+    return OrderBook(spec);
+}
+
+static void addOrders(OrderBook& book, OrderId first_id, Side side) {
+    for (size_t i = 0; i < kOrders; ++i) {
+        Price price = (side == Side::Buy) ? 10400 - static_cast<Price>(i % 50)
+                                          : 10500 + static_cast<Price>(i % 50);
+        book.addOrder(Order(first_id + i, "AAPL", side, OrderType::Limit, price, 10));
+    }
+}
+
+void test_add_cancel_steady_state() {
+    std::cout << "Testing add/cancel allocations..." << std::endl;
+    
+    OrderBook book = makeBook();
+    
+    // Warm up: grow the pool and index to the working size
+    addOrders(book, 1, Side::Buy);
+    for (size_t i = 0; i < kOrders; ++i) {
+        book.cancelOrder(1 + i);
+    }
+    
+    size_t allocs = allocationsDuring([&] {
+        addOrders(book, 100000, Side::Buy);
+        for (size_t i = 0; i < kOrders; ++i) {
+            book.cancelOrder(100000 + i);
+        }
+    });
+    
+    // Order storage and the OrderId index are both recycled in place
+    assert(allocs == 0);
+    assert(book.totalOrderCount() == 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_fill_steady_state() {
+    std::cout << "Testing executeFill allocations..." << std::endl;
+    
+    OrderBook book = makeBook();
+    std::vector<Fill> fills;
+    fills.reserve(16);
+    
+    addOrders(book, 1, Side::Sell);
+    for (size_t i = 0; i < kOrders; ++i) {
+        book.executeFill(Side::Buy, 10, 0, 50000 + i, fills);
+        fills.clear();
+    }
+    
+    size_t buffer_allocs = allocationsDuring([&] {
+        addOrders(book, 100000, Side::Sell);
+        for (size_t i = 0; i < kOrders; ++i) {
+            book.executeFill(Side::Buy, 10, 0, 200000 + i, fills);
+            fills.clear();
+        }
+    });
+    
+    // Fills land in the reused buffer; nothing is allocated per order
+    assert(buffer_allocs == 0);
+    assert(book.totalOrderCount() == 0);
+    
+    Quantity filled = 0;
+    size_t sink_allocs = allocationsDuring([&] {
+        addOrders(book, 300000, Side::Sell);
+        for (size_t i = 0; i < kOrders; ++i) {
+            filled += book.executeFill(Side::Buy, 10, 0, 400000 + i,
+                                       [](const Fill&) {});
+        }
+    });
+    
+    assert(sink_allocs == 0);
+    assert(filled == static_cast<Quantity>(kOrders) * 10);
+    assert(book.totalOrderCount() == 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_map_layout_steady_state() {
+    std::cout << "Testing Map layout level allocations..." << std::endl;
+    
+    // Default layout: levels are tree nodes created and erased as orders
+    // come and go
+    OrderBook book{InstrumentSpec("AAPL")};
+    assert(book.instrument().layout == BookLayout::Map);
+    std::vector<Fill> fills;
+    fills.reserve(16);
+    
+    auto cycle = [&](OrderId first_id) {
+        addOrders(book, first_id, Side::Buy);
+        for (size_t i = 0; i < kOrders; ++i) {
+            book.cancelOrder(first_id + i);
+        }
+        addOrders(book, first_id + kOrders, Side::Sell);
+        for (size_t i = 0; i < kOrders; ++i) {
+            book.executeFill(Side::Buy, 10, 0, first_id + 2 * kOrders + i, fills);
+            fills.clear();
+        }
+    };
+    
+    cycle(1);
+    size_t allocs = allocationsDuring([&] { cycle(100000); });
+    
+    // Erased levels' nodes are reused for the next ones
+    assert(allocs == 0);
+    assert(book.totalOrderCount() == 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_engine_steady_state() {
+    std::cout << "Testing submitOrder allocations..." << std::endl;
+    
+    MatchingEngine engine;
+    InstrumentSpec spec("AAPL");
+    engine.addInstrument(spec.withArrayLadder(10000, 1000));
+    std::vector<Fill> fills;
+    fills.reserve(16);
+    
+    auto cycle = [&](OrderId first_id) {
+        for (size_t i = 0; i < kOrders; ++i) {
+            engine.submitOrder(Order(first_id + i, "AAPL", Side::Sell,
+                                     OrderType::Limit, 10500, 10), fills);
+        }
+        for (size_t i = 0; i < kOrders; ++i) {
+            engine.submitOrder(Order(first_id + kOrders + i, "AAPL", Side::Buy,
+                                     OrderType::Limit, 10500, 10), fills);
+            fills.clear();
+        }
+    };
+    
+    cycle(1);
+    size_t allocs = allocationsDuring([&] { cycle(100000); });
+    
+    assert(allocs == 0);
+    assert(engine.getOrderBook("AAPL")->totalOrderCount() == 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_depth_view() {
+    std::cout << "Testing depth view allocations..." << std::endl;
+    
+    OrderBook book = makeBook();
+    addOrders(book, 1, Side::Buy);
+    
+    Quantity total = 0;
+    size_t allocs = allocationsDuring([&] {
+        auto depth = book.getDepth<10>(Side::Buy);
+        for (const DepthLevel& level : depth) {
+            total += level.quantity;
+        }
+        book.visitDepth(Side::Buy, 50, [&total](const DepthLevel& level) {
+            total += level.quantity;
+            return true;
+        });
+    });
+    
+    // Aggregates only: no vectors and no copies of the order queues
+    assert(allocs == 0);
+    assert(total > 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Allocation Tests ===" << std::endl;
+    
+    test_add_cancel_steady_state();
+    test_fill_steady_state();
+    test_map_layout_steady_state();
+    test_engine_steady_state();
+    test_depth_view();
+    
+    std::cout << "\n=== All Allocation Tests Passed! ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,298 @@
+#include "../include/async_publisher.hpp"
+#include "test_util.hpp"
+#include <chrono>
+#include <iostream>
+#include <cassert>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace trading;
+
+// Crossing flow on two books: limits, IOCs, cancels and modifies
+static std::vector<EngineCommand> makeFlow(int count) {
+    testutil::FlowSpec spec;
+    spec.symbols = {"APA", "APB"};
+    spec.base_price = 700;
+    spec.levels = 10;
+    spec.max_quantity = 40;
+    return testutil::makeFlow(spec, 5, count);
+}
+
+static bool sameEvent(const EngineEvent& a, const EngineEvent& b) {
+    return a.type == b.type && a.order_id == b.order_id &&
+           a.counter_order_id == b.counter_order_id && a.price == b.price &&
+           a.quantity == b.quantity && a.filled_qty == b.filled_qty && a.side == b.side &&
+           a.status == b.status && a.timestamp_ns == b.timestamp_ns;
+}
+
+// Events of a synchronous engine running the flow
+static std::vector<EngineEvent> runSync(const std::vector<EngineCommand>& commands) {
+    std::vector<EngineEvent> events;
+    MatchingEngine engine;
+    engine.setFillCallback([&events](const Fill& fill) {
+        events.push_back(EngineEvent::fill(fill));
+    });
+    engine.setOrderCallback([&events](const Order& order) {
+        events.push_back(EngineEvent::order(order));
+    });
+    std::vector<Fill> fills;
+    for (const EngineCommand& command : commands) {
+        applyCommand(engine, command, fills);
+    }
+    return events;
+}
+
+void test_event_records() {
+    std::cout << "Testing engine event records..." << std::endl;
+    
+    static_assert(sizeof(EngineEvent) == 56, "compact, fixed-size ring records");
+    Fill fill(3, 9, internSymbol("APA"), Side::Sell, 705, 12);
+    Fill rebuilt = EngineEvent::fill(fill).toFill();
+    assert(rebuilt.order_id == 3 && rebuilt.counter_order_id == 9 && rebuilt.symbol == fill.symbol);
+    assert(rebuilt.side == Side::Sell && rebuilt.price == 705 && rebuilt.quantity == 12);
+    assert(rebuilt.timestamp == fill.timestamp);
+    
+    Order order(4, "APA", Side::Buy, OrderType::IOC, 706, 30);
+    order.apply_fill(10);
+    order.cancel();
+    Order copy = EngineEvent::order(order).toOrder();
+    assert(copy.id == 4 && copy.type == OrderType::IOC && copy.quantity == 30);
+    assert(copy.filled_qty == 10 && copy.status == order.status);
+    assert(copy.timestamp == order.timestamp);
+    
+    EngineEvent gap = EngineEvent::gap(17);
+    assert(gap.type == EngineEventType::Gap && gap.quantity == 17);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_block_keeps_every_event() {
+    std::cout << "Testing the blocking policy against a slow consumer..." << std::endl;
+    
+    std::vector<EngineCommand> commands = makeFlow(5000);
+    std::vector<EngineEvent> expected = runSync(commands);
+    
+    PublisherOptions options;
+    options.capacity = 64;
+    options.batch_size = 16;
+    AsyncPublisher publisher(options);
+    std::vector<EngineEvent> events;
+    std::thread::id engine_thread = std::this_thread::get_id();
+    bool off_engine_thread = true;
+    auto check_thread = [&]() {
+        off_engine_thread = off_engine_thread && std::this_thread::get_id() != engine_thread;
+    };
+    publisher.setFillCallback([&](const Fill& fill) {
+        check_thread();
+        events.push_back(EngineEvent::fill(fill));
+        if (events.size() % 500 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    publisher.setOrderCallback([&](const Order& order) {
+        check_thread();
+        events.push_back(EngineEvent::order(order));
+    });
+    assert(publisher.start());
+    assert(!publisher.start());
+    
+    BasicMatchingEngine<AsyncListener> engine{AsyncListener(&publisher)};
+    std::vector<Fill> fills;
+    for (const EngineCommand& command : commands) {
+        applyCommand(engine, command, fills);
+    }
+    publisher.stop();
+    
+    assert(off_engine_thread);
+    assert(events.size() == expected.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        EngineEvent want = expected[i];
+        want.timestamp_ns = events[i].timestamp_ns;    // Different runs, different clocks
+        assert(sameEvent(events[i], want));
+    }
+    
+    PublisherStats stats = publisher.stats();
+    assert(stats.published == expected.size() && stats.delivered == expected.size());
+    assert(stats.dropped == 0 && stats.conflated == 0 && !publisher.overflowed());
+    assert(stats.full_waits > 0);
+    assert(stats.peak_occupancy > 0 && stats.peak_occupancy <= stats.capacity);
+    assert(stats.mean_occupancy > 0.0 && stats.occupancy == 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+static void waitDelivered(const AsyncPublisher& publisher, uint64_t count) {
+    while (publisher.stats().delivered < count) {
+        std::this_thread::yield();
+    }
+}
+
+static Fill makeFill(OrderId order_id, OrderId resting, Price price, Quantity quantity) {
+    return Fill(order_id, resting, internSymbol("APA"), Side::Buy, price, quantity);
+}
+
+void test_drop_and_flag() {
+    std::cout << "Testing drop-and-flag reports the gap..." << std::endl;
+    
+    PublisherOptions options;
+    options.capacity = 8;
+    options.policy = SlowConsumerPolicy::DropAndFlag;
+    AsyncPublisher publisher(options);
+    std::vector<OrderId> delivered;
+    std::vector<std::pair<size_t, uint64_t>> gaps;    // (events before, dropped)
+    publisher.setFillCallback([&](const Fill& fill) { delivered.push_back(fill.order_id); });
+    publisher.setGapCallback([&](uint64_t dropped) { gaps.emplace_back(delivered.size(), dropped); });
+    
+    // Not started yet: the ring fills and the rest is dropped
+    for (OrderId id = 1; id <= 12; ++id) {
+        publisher.publishFill(makeFill(id, 100, 700, 1));
+    }
+    assert(publisher.overflowed() && publisher.stats().dropped == 4);
+    
+    assert(publisher.start());
+    waitDelivered(publisher, 8);
+    publisher.publishFill(makeFill(13, 100, 700, 1));
+    publisher.stop();
+    
+    assert(delivered.size() == 9 && delivered[7] == 8 && delivered[8] == 13);
+    assert(gaps.size() == 1 && gaps[0].first == 8 && gaps[0].second == 4);
+    PublisherStats stats = publisher.stats();
+    assert(stats.published == 10 && stats.delivered == 10 && stats.full_waits == 0);
+    assert(stats.peak_occupancy == 8);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_conflate() {
+    std::cout << "Testing conflation merges fills while the ring is full..." << std::endl;
+    
+    PublisherOptions options;
+    options.capacity = 4;
+    options.policy = SlowConsumerPolicy::Conflate;
+    AsyncPublisher publisher(options);
+    std::vector<Fill> fills;
+    std::vector<Order> orders;
+    std::vector<std::pair<Fill, uint64_t>> merged;
+    publisher.setFillCallback([&](const Fill& fill) { fills.push_back(fill); });
+    publisher.setOrderCallback([&](const Order& order) { orders.push_back(order); });
+    publisher.setConflatedFillCallback([&](const Fill& fill, uint64_t count) {
+        assert(fills.size() == 4);
+        merged.emplace_back(fill, count);
+    });
+    
+    // Ring full: order 5 sweeps four resting orders at 700, then one at 701
+    for (OrderId id = 1; id <= 4; ++id) {
+        publisher.publishFill(makeFill(id, 100, 700, 1));
+    }
+    publisher.publishFill(makeFill(5, 101, 700, 3));
+    publisher.publishFill(makeFill(5, 102, 700, 4));
+    publisher.publishFill(makeFill(5, 103, 700, 5));
+    assert(publisher.stats().conflated == 2);
+    
+    // A different price has to wait for the held fill to get in
+    assert(publisher.start());
+    publisher.publishFill(makeFill(5, 104, 701, 6));
+    Order order(5, "APA", Side::Buy, OrderType::IOC, 701, 20);
+    order.apply_fill(18);
+    order.cancel();
+    publisher.publishOrder(order);
+    publisher.stop();
+    
+    // The three fills at 700 came from three resting orders, so the merged
+    // fill names none of them
+    assert(fills.size() == 5 && orders.size() == 1 && merged.size() == 1);
+    const Fill& fill = merged[0].first;
+    assert(fill.order_id == 5 && fill.price == 700 && fill.quantity == 12);
+    assert(fill.counter_order_id == 0 && merged[0].second == 3);
+    assert(fills[4].price == 701 && fills[4].quantity == 6 && fills[4].counter_order_id == 104);
+    assert(orders[0].filled_qty == 18);
+    PublisherStats stats = publisher.stats();
+    assert(stats.dropped == 0 && stats.conflated == 2 && stats.published == 7);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_conflate_keeps_quantities() {
+    std::cout << "Testing conflation keeps every order's filled quantity..." << std::endl;
+    
+    std::vector<EngineCommand> commands = makeFlow(5000);
+    std::vector<EngineEvent> expected = runSync(commands);
+    
+    PublisherOptions options;
+    options.capacity = 16;
+    options.policy = SlowConsumerPolicy::Conflate;
+    AsyncPublisher publisher(options);
+    std::map<OrderId, Quantity> filled;
+    std::map<OrderId, Quantity> resting_filled;
+    Quantity conflated_quantity = 0;
+    std::vector<OrderId> order_updates;
+    size_t fill_count = 0;
+    publisher.setFillCallback([&](const Fill& fill) {
+        filled[fill.order_id] += fill.quantity;
+        resting_filled[fill.counter_order_id] += fill.quantity;
+        if (++fill_count % 200 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    publisher.setConflatedFillCallback([&](const Fill& fill, uint64_t count) {
+        assert(fill.counter_order_id == 0 && count >= 2);
+        filled[fill.order_id] += fill.quantity;
+        conflated_quantity += fill.quantity;
+    });
+    publisher.setOrderCallback([&](const Order& order) {
+        // Every fill of an order arrives before its update
+        auto it = filled.find(order.id);
+        assert((it == filled.end() ? 0 : it->second) == order.filled_qty);
+        order_updates.push_back(order.id);
+    });
+    publisher.start();
+    
+    BasicMatchingEngine<AsyncListener> engine{AsyncListener(&publisher)};
+    std::vector<Fill> fills;
+    for (const EngineCommand& command : commands) {
+        applyCommand(engine, command, fills);
+    }
+    publisher.stop();
+    
+    std::map<OrderId, Quantity> expected_filled;
+    std::map<OrderId, Quantity> expected_resting;
+    std::vector<OrderId> expected_updates;
+    for (const EngineEvent& event : expected) {
+        if (event.type == EngineEventType::Fill) {
+            expected_filled[event.order_id] += event.quantity;
+            expected_resting[event.counter_order_id] += event.quantity;
+        } else {
+            expected_updates.push_back(event.order_id);
+        }
+    }
+    assert(filled == expected_filled);
+    assert(order_updates == expected_updates);
+    
+    // No resting order is credited with quantity it did not trade; what
+    // the plain fills leave out is exactly the conflated quantity
+    assert(conflated_quantity > 0 && publisher.stats().conflated > 0);
+    Quantity unattributed = 0;
+    for (const auto& [order_id, quantity] : expected_resting) {
+        Quantity delivered = resting_filled.count(order_id) ? resting_filled[order_id] : 0;
+        assert(delivered <= quantity);
+        unattributed += quantity - delivered;
+    }
+    assert(resting_filled.size() <= expected_resting.size());
+    assert(unattributed == conflated_quantity);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Async Publisher Tests ===" << std::endl;
+    
+    test_event_records();
+    test_block_keeps_every_event();
+    test_drop_and_flag();
+    test_conflate();
+    test_conflate_keeps_quantities();
+    
+    std::cout << "\n=== All Async Publisher Tests Passed! ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include "../include/command_queue.hpp"
+#include "test_util.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace trading;
+
+// Crossing flow on two books: limits, IOCs, cancels and modifies
+static std::vector<EngineCommand> makeFlow(int count) {
+    testutil::FlowSpec spec;
+    spec.symbols = {"CQA", "CQB"};
+    return testutil::makeFlow(spec, 3, count);
+}
+
+void test_command_records() {
+    std::cout << "Testing command records..." << std::endl;
+    
+    static_assert(sizeof(EngineCommand) == 32, "one record per half cache line");
+    Order order(7, "CQA", Side::Sell, OrderType::FOK, 505, 40);
+    EngineCommand submit = EngineCommand::submit(order);
+    assert(submit.type == CommandType::Submit);
+    Order rebuilt = submit.toOrder();
+    assert(rebuilt.id == 7 && rebuilt.symbol == order.symbol && rebuilt.side == Side::Sell);
+    assert(rebuilt.type == OrderType::FOK && rebuilt.price == 505 && rebuilt.quantity == 40);
+    
+    EngineCommand modify = EngineCommand::modify(order.symbol, 7, 0, 25);
+    assert(modify.type == CommandType::Modify && modify.price == 0 && modify.quantity == 25);
+    
+    // Cancel / modify report whether the order was found
+    BasicMatchingEngine<NullListener> engine;
+    std::vector<Fill> fills;
+    submit.order_type = OrderType::Limit;
+    assert(applyCommand(engine, submit, fills));
+    assert(applyCommand(engine, modify, fills));
+    assert(engine.getOrderBook(order.symbol)->getOrder(7)->quantity == 25);
+    assert(applyCommand(engine, EngineCommand::cancel(order.symbol, 7), fills));
+    assert(!applyCommand(engine, EngineCommand::cancel(order.symbol, 7), fills));
+    
+    CommandQueue queue(3);
+    assert(queue.capacity() == 4);
+    for (OrderId id = 1; id <= 4; ++id) {
+        assert(queue.tryPush(EngineCommand::cancel(order.symbol, id)));
+    }
+    assert(!queue.tryPush(EngineCommand::cancel(order.symbol, 5)));
+    OrderId expected = 1;
+    assert(queue.consume([&expected](const EngineCommand& command) {
+        assert(command.order_id == expected++);
+    }) == 4);
+    assert(queue.empty());
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_loop_per_wait_strategy() {
+    std::cout << "Testing the engine loop with each wait strategy..." << std::endl;
+    
+    std::vector<EngineCommand> commands = makeFlow(20000);
+    BasicMatchingEngine<NullListener> reference;
+    std::vector<Fill> fills;
+    for (const EngineCommand& command : commands) {
+        applyCommand(reference, command, fills);
+    }
+    
+    for (WaitStrategy wait : {WaitStrategy::BusySpin, WaitStrategy::SpinYield,
+                              WaitStrategy::Block}) {
+        BasicMatchingEngine<NullListener> engine;
+        CommandQueue queue(256, wait);
+        EngineLoop<NullListener> loop(engine, queue, 32);
+        std::thread engine_thread([&loop]() { loop.run(); });
+        
+        // Bursts separated by pauses long enough for a blocking loop to sleep
+        for (size_t i = 0; i < commands.size(); ++i) {
+            queue.push(commands[i]);
+            if (i % 5000 == 4999) {
+                while (loop.processed() < i + 1) {
+                    std::this_thread::yield();
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+        loop.stop();
+        engine_thread.join();
+        
+        assert(loop.processed() == commands.size());
+        assert(loop.batches() >= commands.size() / 32);
+        assert(engine.stateHash() == reference.stateHash());
+        if (wait == WaitStrategy::Block) {
+            assert(queue.sleeps() > 0);
+            assert(queue.wakeups() > 0);
+        } else {
+            assert(queue.sleeps() == 0);
+        }
+    }
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_stop_wakes_blocked_loop() {
+    std::cout << "Testing stop wakes a sleeping loop and drains the queue..." << std::endl;
+    
+    BasicMatchingEngine<NullListener> engine;
+    CommandQueue queue(64, WaitStrategy::Block);
+    EngineLoop<NullListener> loop(engine, queue);
+    
+    // Stop requested before the loop starts: queued commands still run
+    queue.push(EngineCommand::submit(Order(1, "CQA", Side::Buy, OrderType::Limit, 500, 10)));
+    loop.stop();
+    loop.run();
+    assert(loop.processed() == 1);
+    assert(engine.getOrderBook("CQA")->getOrder(1) != nullptr);
+    
+    // An idle loop asleep on the futex returns once stopped
+    BasicMatchingEngine<NullListener> idle_engine;
+    CommandQueue idle_queue(64, WaitStrategy::Block);
+    EngineLoop<NullListener> idle_loop(idle_engine, idle_queue);
+    std::thread engine_thread([&idle_loop]() { idle_loop.run(); });
+    while (idle_queue.sleeps() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    idle_loop.stop();
+    engine_thread.join();
+    assert(idle_loop.processed() == 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_loop_flushes_journal_when_idle() {
+    std::cout << "Testing the loop flushes a partial journal group when idle..." << std::endl;
+    
+    std::string path = "test_command_queue_" + std::to_string(::getpid()) + ".bin";
+    std::remove(path.c_str());
+    JournalOptions options;
+    options.fsync = FsyncPolicy::Periodic;
+    options.group_size = 64;
+    options.sync_interval = std::chrono::seconds(60);
+    auto journal = std::make_shared<OrderJournal>();
+    assert(journal->open(path, options));
+    
+    BasicMatchingEngine<NullListener> engine;
+    engine.setJournal(journal);
+    CommandQueue queue(64, WaitStrategy::Block);
+    EngineLoop<NullListener> loop(engine, queue);
+    std::thread engine_thread([&loop]() { loop.run(); });
+    for (OrderId id = 1; id <= 5; ++id) {
+        queue.push(EngineCommand::submit(Order(id, "CQA", Side::Buy, OrderType::Limit, 500, 10)));
+    }
+    
+    // Asleep means drained and flushed: written and synced well inside
+    // both the group and the interval
+    while (queue.sleeps() == 0 || loop.processed() < 5) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    assert(journal->pendingCommands() == 0);
+    assert(journal->committedSequence() == journal->sequence());
+    assert(journal->syncs() >= 1);
+    
+    loop.stop();
+    engine_thread.join();
+    journal->close();
+    std::remove(path.c_str());
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Command Queue Tests ===" << std::endl;
+    
+    test_command_records();
+    test_loop_per_wait_strategy();
+    test_stop_wakes_blocked_loop();
+    test_loop_flushes_journal_when_idle();
+    
+    std::cout << "\n=== All Command Queue Tests Passed! ===" << std::endl;
+    return 0;
+}
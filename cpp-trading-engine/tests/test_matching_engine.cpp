@@ -1,23 +1,29 @@
 #include "../include/matching_engine.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <map>
+#include <utility>
 #include <vector>
 
 using namespace trading;
 
+// Test prices are written in dollars and converted to cent ticks
+static Price px(double price) { return toTicks(price); }
+
 void test_submit_limit_order() {
     std::cout << "Testing submitOrder (limit)..." << std::endl;
     
     MatchingEngine engine;
     
     // Submit sell order - should rest in book
-    Order sell(1, "AAPL", Side::Sell, OrderType::Limit, 150.0, 100);
+    Order sell(1, "AAPL", Side::Sell, OrderType::Limit, px(150.0), 100);
     auto fills = engine.submitOrder(sell);
     
     assert(fills.empty());  // No match
     
     // Submit buy order below ask - should rest in book
-    Order buy(2, "AAPL", Side::Buy, OrderType::Limit, 149.0, 50);
+    Order buy(2, "AAPL", Side::Buy, OrderType::Limit, px(149.0), 50);
     fills = engine.submitOrder(buy);
     
     assert(fills.empty());  // No match
@@ -37,23 +43,23 @@ void test_limit_order_match() {
     MatchingEngine engine;
     
     // Setup resting orders
-    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, 150.0, 100));
-    engine.submitOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, 151.0, 200));
+    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.0), 100));
+    engine.submitOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, px(151.0), 200));
     
     // Submit crossing buy order
-    Order buy(3, "AAPL", Side::Buy, OrderType::Limit, 150.5, 150);
+    Order buy(3, "AAPL", Side::Buy, OrderType::Limit, px(150.5), 150);
     auto fills = engine.submitOrder(buy);
     
     // Should match against sell at 150.0
     assert(fills.size() == 1);
-    assert(fills[0].price == 150.0);
+    assert(fills[0].price == px(150.0));
     assert(fills[0].quantity == 100);
     
     // Remaining 50 shares should rest in book at 150.5
     const OrderBook* book = engine.getOrderBook("AAPL");
     auto best_bid = book->getBestBid();
     assert(best_bid.has_value());
-    assert(best_bid->first == 150.5);
+    assert(best_bid->first == px(150.5));
     assert(best_bid->second == 50);
     
     std::cout << "  PASSED" << std::endl;
@@ -65,8 +71,8 @@ void test_market_order() {
     MatchingEngine engine;
     
     // Setup resting orders
-    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, 150.0, 100));
-    engine.submitOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, 151.0, 200));
+    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.0), 100));
+    engine.submitOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, px(151.0), 200));
     
     // Submit market buy
     Order market_buy(3, "AAPL", Side::Buy, OrderType::Market, 0, 250);
@@ -74,16 +80,16 @@ void test_market_order() {
     
     // Should match all available liquidity
     assert(fills.size() == 2);
-    assert(fills[0].price == 150.0);
+    assert(fills[0].price == px(150.0));
     assert(fills[0].quantity == 100);
-    assert(fills[1].price == 151.0);
+    assert(fills[1].price == px(151.0));
     assert(fills[1].quantity == 150);
     
     // Order book should have remaining sell at 151.0
     const OrderBook* book = engine.getOrderBook("AAPL");
     auto best_ask = book->getBestAsk();
     assert(best_ask.has_value());
-    assert(best_ask->first == 151.0);
+    assert(best_ask->first == px(151.0));
     assert(best_ask->second == 50);
     
     std::cout << "  PASSED" << std::endl;
@@ -95,10 +101,10 @@ void test_ioc_order() {
     MatchingEngine engine;
     
     // Setup resting order
-    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, 150.0, 50));
+    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.0), 50));
     
     // Submit IOC buy for more than available
-    Order ioc(2, "AAPL", Side::Buy, OrderType::IOC, 150.0, 100);
+    Order ioc(2, "AAPL", Side::Buy, OrderType::IOC, px(150.0), 100);
     auto fills = engine.submitOrder(ioc);
     
     // Should fill 50 and cancel remaining
@@ -112,13 +118,49 @@ void test_ioc_order() {
     std::cout << "  PASSED" << std::endl;
 }
 
+void test_fok_order() {
+    std::cout << "Testing FOK order..." << std::endl;
+    
+    MatchingEngine engine;
+    std::vector<Fill> fills;
+    
+    // 30 resting across three levels
+    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.0), 10), fills);
+    engine.submitOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, px(150.01), 10), fills);
+    engine.submitOrder(Order(3, "AAPL", Side::Sell, OrderType::Limit, px(150.02), 10), fills);
+    const OrderBook* book = engine.getOrderBook("AAPL");
+    uint64_t version = book->version();
+    uint64_t hash = book->stateHash();
+    
+    // More than the book holds within the limit: killed, book untouched
+    Order too_big(4, "AAPL", Side::Buy, OrderType::FOK, px(150.01), 25);
+    assert(engine.submitOrder(too_big, fills) == OrderStatus::Cancelled);
+    assert(fills.empty());
+    assert(book->version() == version && book->stateHash() == hash);
+    assert(book->getOrder(1)->remaining_qty() == 10);
+    
+    // Exactly what is there within the limit: filled in full across levels
+    Order fits(5, "AAPL", Side::Buy, OrderType::FOK, px(150.01), 20);
+    assert(engine.submitOrder(fits, fills) == OrderStatus::Filled);
+    assert(fills.size() == 2 && fills[0].quantity + fills[1].quantity == 20);
+    assert(book->askOrderCount() == 1 && book->bidOrderCount() == 0);
+    
+    // A FOK never rests
+    fills.clear();
+    Order sell(6, "AAPL", Side::Sell, OrderType::FOK, px(149.0), 5);
+    assert(engine.submitOrder(sell, fills) == OrderStatus::Cancelled);
+    assert(fills.empty() && book->bidOrderCount() == 0 && book->askOrderCount() == 1);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
 void test_cancel_order() {
     std::cout << "Testing cancelOrder..." << std::endl;
     
     MatchingEngine engine;
     
     // Submit order
-    engine.submitOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, 150.0, 100));
+    engine.submitOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100));
     
     // Cancel it
     assert(engine.cancelOrder("AAPL", 1));
@@ -139,9 +181,9 @@ void test_multiple_symbols() {
     MatchingEngine engine;
     
     // Submit orders for different symbols
-    engine.submitOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, 150.0, 100));
-    engine.submitOrder(Order(2, "GOOGL", Side::Sell, OrderType::Limit, 2800.0, 50));
-    engine.submitOrder(Order(3, "MSFT", Side::Buy, OrderType::Limit, 300.0, 75));
+    engine.submitOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100));
+    engine.submitOrder(Order(2, "GOOGL", Side::Sell, OrderType::Limit, px(2800.0), 50));
+    engine.submitOrder(Order(3, "MSFT", Side::Buy, OrderType::Limit, px(300.0), 75));
     
     // Verify separate order books
     assert(engine.getOrderBook("AAPL") != nullptr);
@@ -172,8 +214,8 @@ void test_callbacks() {
     });
     
     // Submit and match orders
-    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, 150.0, 100));
-    engine.submitOrder(Order(2, "AAPL", Side::Buy, OrderType::Limit, 150.0, 100));
+    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.0), 100));
+    engine.submitOrder(Order(2, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100));
     
     assert(received_fills.size() == 1);
     assert(received_orders.size() == 2);
@@ -182,6 +224,78 @@ void test_callbacks() {
     std::cout << "  PASSED" << std::endl;
 }
 
+void test_callback_reentry() {
+    std::cout << "Testing callbacks that read and cancel from a fill..." << std::endl;
+    
+    MatchingEngine engine;
+    auto risk = std::make_shared<RiskManager>();
+    engine.setRiskManager(risk);
+    BookHandle book = engine.registerSymbol("REENTRY");
+    const OrderBook* view = engine.getOrderBook(book);
+    std::vector<Fill> fills;
+    engine.submitOrder(book, Order(1, "REENTRY", Side::Sell, OrderType::Limit, 100, 5), fills);
+    engine.submitOrder(book, Order(2, "REENTRY", Side::Sell, OrderType::Limit, 100, 10), fills);
+    engine.submitOrder(book, Order(3, "REENTRY", Side::Sell, OrderType::Limit, 101, 10), fills);
+    
+    // Each fill sees the finished sweep, then cancels what is left of the
+    // resting order; cancelling order 2 erases the level it rested on
+    std::vector<bool> cancelled;
+    engine.setFillCallback([&](const Fill& fill) {
+        auto best = view->getBestAsk();
+        assert(best && best->first == 100 && best->second == 3);
+        const DepthLevel& top = view->cachedDepth(Side::Sell)[0];
+        assert(top.price == best->first && top.quantity == best->second);
+        assert(risk->getPosition(book.symbolId()) < 12);
+        cancelled.push_back(engine.cancelOrder(book, fill.counter_order_id));
+    });
+    
+    fills.clear();
+    engine.submitOrder(book, Order(4, "REENTRY", Side::Buy, OrderType::IOC, 101, 12), fills);
+    assert(fills.size() == 2 && fills[0].counter_order_id == 1 && fills[1].counter_order_id == 2);
+    assert(cancelled.size() == 2 && !cancelled[0] && cancelled[1]);
+    assert(view->getBestAsk()->first == 101 && view->askOrderCount() == 1);
+    assert(risk->getPosition(book.symbolId()) == 12);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_callback_submit() {
+    std::cout << "Testing a fill callback that submits a crossing order..." << std::endl;
+    
+    // The buy's remainder rests before any listener runs, so the sell
+    // submitted from its fill matches it instead of crossing the book
+    MatchingEngine engine;
+    BookHandle book = engine.registerSymbol("REENTRY2");
+    const OrderBook* view = engine.getOrderBook(book);
+    engine.submitOrder(book, Order(1, "REENTRY2", Side::Sell, OrderType::Limit, 100, 10));
+    bool submitted = false;
+    engine.setFillCallback([&](const Fill& fill) {
+        if (submitted || fill.order_id != 2) {
+            return;
+        }
+        submitted = true;
+        assert(view->getBestBid()->first == 100 && view->getBestBid()->second == 10);
+        auto inner = engine.submitOrder(book, Order(3, "REENTRY2", Side::Sell,
+                                                    OrderType::Limit, 100, 5));
+        assert(inner.size() == 1 && inner[0].counter_order_id == 2);
+    });
+    std::vector<Fill> fills;
+    assert(engine.submitOrder(book, Order(2, "REENTRY2", Side::Buy, OrderType::Limit, 100, 20),
+                              fills) == OrderStatus::PartiallyFilled);
+    assert(submitted && fills.size() == 1);
+    assert(!view->getBestAsk() && view->getBestBid()->second == 5);
+    
+    // Same state as the two submits one after the other
+    MatchingEngine serial;
+    BookHandle serial_book = serial.registerSymbol("REENTRY2");
+    serial.submitOrder(serial_book, Order(1, "REENTRY2", Side::Sell, OrderType::Limit, 100, 10));
+    serial.submitOrder(serial_book, Order(2, "REENTRY2", Side::Buy, OrderType::Limit, 100, 20));
+    serial.submitOrder(serial_book, Order(3, "REENTRY2", Side::Sell, OrderType::Limit, 100, 5));
+    assert(serial.stateHash() == engine.stateHash());
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
 void test_with_risk_manager() {
     std::cout << "Testing with risk manager..." << std::endl;
     
@@ -192,17 +306,27 @@ void test_with_risk_manager() {
     engine.setRiskManager(risk_mgr);
     
     // Submit order within limit
-    Order small(1, "AAPL", Side::Buy, OrderType::Limit, 150.0, 50);
+    Order small(1, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 50);
     auto fills = engine.submitOrder(small);
     assert(engine.getOrderBook("AAPL")->bidOrderCount() == 1);
     
     // Submit order exceeding limit - should be rejected
-    Order large(2, "AAPL", Side::Buy, OrderType::Limit, 150.0, 200);
+    Order large(2, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 200);
     fills = engine.submitOrder(large);
     
     // Order should be rejected, not added to book
     assert(engine.getOrderBook("AAPL")->bidOrderCount() == 1);
     
+    // A rejected order for a symbol without a book does not create one
+    risk_mgr->setOrderSizeLimit("RISKNEW", 100);
+    Order unbooked(3, "RISKNEW", Side::Buy, OrderType::Limit, px(10.0), 200);
+    std::vector<Fill> out;
+    assert(engine.submitOrder(unbooked, out) == OrderStatus::Rejected);
+    assert(engine.getOrderBook("RISKNEW") == nullptr);
+    assert(engine.submitOrder(Order(4, "RISKNEW", Side::Buy, OrderType::Limit, px(10.0), 50),
+                              out) == OrderStatus::New);
+    assert(engine.getOrderBook("RISKNEW")->bidOrderCount() == 1);
+    
     std::cout << "  PASSED" << std::endl;
 }
 
@@ -211,9 +335,9 @@ void test_statistics() {
     
     MatchingEngine engine;
     
-    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, 150.0, 100));
-    engine.submitOrder(Order(2, "AAPL", Side::Buy, OrderType::Limit, 150.0, 100));
-    engine.submitOrder(Order(3, "AAPL", Side::Buy, OrderType::Limit, 149.0, 50));
+    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.0), 100));
+    engine.submitOrder(Order(2, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100));
+    engine.submitOrder(Order(3, "AAPL", Side::Buy, OrderType::Limit, px(149.0), 50));
     
     assert(engine.totalOrdersProcessed() == 3);
     assert(engine.totalFillsGenerated() == 1);
@@ -221,6 +345,477 @@ void test_statistics() {
     std::cout << "  PASSED" << std::endl;
 }
 
+void test_instrument_ticks() {
+    std::cout << "Testing instrument tick scaling..." << std::endl;
+    
+    // Decimal prices that differ in floating point map to the same tick
+    assert(toTicks(0.1 + 0.2) == toTicks(0.3));
+    
+    MatchingEngine engine;
+    auto risk_mgr = std::make_shared<RiskManager>();
+    engine.setRiskManager(risk_mgr);
+    
+    // Futures-style instrument quoted in quarter points
+    assert(engine.addInstrument(InstrumentSpec("ES", 0.25)));
+    assert(!engine.addInstrument(InstrumentSpec("ES", 0.25)));
+    assert(risk_mgr->getTickSize("ES") == 0.25);
+    
+    const OrderBook* book = engine.getOrderBook("ES");
+    assert(book != nullptr);
+    Price price = book->instrument().toTicks(4500.25);
+    assert(price == 18001);
+    
+    engine.submitOrder(Order(1, "ES", Side::Sell, OrderType::Limit, price, 2));
+    engine.submitOrder(Order(2, "ES", Side::Buy, OrderType::Limit, price, 2));
+    
+    // Notional exposure is reported in currency units, not ticks
+    assert(risk_mgr->getPosition("ES") == 2);
+    assert(risk_mgr->getNotionalExposure("ES") == 9000.5);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_symbol_ids() {
+    std::cout << "Testing symbol interning..." << std::endl;
+    
+    SymbolId msft = internSymbol("MSFT");
+    assert(internSymbol("MSFT") == msft);
+    assert(findSymbol("MSFT") == msft);
+    assert(symbolName(msft) == "MSFT");
+    assert(findSymbol("NOT_A_SYMBOL") == INVALID_SYMBOL_ID);
+    
+    MatchingEngine engine;
+    engine.submitOrder(Order(1, msft, Side::Buy, OrderType::Limit, px(300.00), 5));
+    
+    // Id and name lookups reach the same book; fills carry the id
+    const OrderBook* book = engine.getOrderBook(msft);
+    assert(book != nullptr);
+    assert(book == engine.getOrderBook("MSFT"));
+    assert(book->symbolId() == msft);
+    assert(engine.getOrderBook("NOT_A_SYMBOL") == nullptr);
+    
+    auto fills = engine.submitOrder(Order(2, "MSFT", Side::Sell, OrderType::Limit, px(300.00), 5));
+    assert(fills.size() == 1);
+    assert(fills[0].symbol == msft);
+    
+    assert(!engine.cancelOrder(msft, 1));
+    assert(!engine.cancelOrder("NOT_A_SYMBOL", 1));
+    
+    // Ids the registry never issued are rejected, not used to size storage
+    auto risk = std::make_shared<RiskManager>();
+    engine.setRiskManager(risk);
+    OrderStatus reported = OrderStatus::New;
+    engine.setOrderCallback([&reported](const Order& order) { reported = order.status; });
+    Order unset;
+    unset.id = 3;
+    unset.price = 100;
+    unset.quantity = 10;
+    assert(unset.symbol == INVALID_SYMBOL_ID);
+    std::vector<Fill> out;
+    assert(engine.submitOrder(unset, out) == OrderStatus::Rejected);
+    assert(reported == OrderStatus::Rejected && out.empty());
+    SymbolId unissued = static_cast<SymbolId>(SymbolRegistry::instance().size() + 1000);
+    assert(!isInternedSymbol(unissued) && !isInternedSymbol(INVALID_SYMBOL_ID));
+    assert(engine.submitOrder(Order(4, unissued, Side::Buy, OrderType::Limit, 100, 10),
+                              out) == OrderStatus::Rejected);
+    std::vector<Order> burst = {unset, Order(5, msft, Side::Buy, OrderType::Limit, 100, 10)};
+    assert(engine.submitOrders(Span<Order>(burst), out) == 0);
+    assert(burst[0].status == OrderStatus::Rejected && burst[1].status == OrderStatus::New);
+    assert(engine.getOrCreateOrderBook(INVALID_SYMBOL_ID) == nullptr);
+    assert(engine.getOrderBook(INVALID_SYMBOL_ID) == nullptr);
+    assert(!engine.cancelOrder(INVALID_SYMBOL_ID, 3));
+    risk->updatePosition(INVALID_SYMBOL_ID, Side::Buy, 10, 100);
+    assert(risk->getPosition(INVALID_SYMBOL_ID) == 0);
+    assert(risk->symbolCount() <= SymbolRegistry::instance().size());
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_book_handles() {
+    std::cout << "Testing book handles..." << std::endl;
+    
+    MatchingEngine engine;
+    BookHandle aapl = engine.registerSymbol("AAPL", 100);
+    assert(aapl.valid());
+    assert(aapl.symbolId() == findSymbol("AAPL"));
+    assert(engine.registerSymbol("AAPL") == aapl);
+    assert(engine.getBookHandle("AAPL") == aapl);
+    assert(!engine.getBookHandle("NOT_A_SYMBOL"));
+    
+    const OrderBook* book = engine.getOrderBook(aapl);
+    assert(book == engine.getOrderBook("AAPL"));
+    
+    // The handle decides the book; the order's symbol follows it
+    engine.submitOrder(aapl, Order(1, "IGNORED", Side::Sell, OrderType::Limit, px(150.00), 100));
+    assert(book->askOrderCount() == 1);
+    assert(book->getOrder(1)->symbol == aapl.symbolId());
+    
+    assert(engine.modifyOrder(aapl, 1, px(150.01), 80));
+    assert(book->getBestAsk()->first == px(150.01));
+    
+    auto fills = engine.submitOrder(aapl, Order(2, "AAPL", Side::Buy, OrderType::Limit, px(150.01), 30));
+    assert(fills.size() == 1);
+    assert(fills[0].symbol == aapl.symbolId());
+    
+    assert(engine.cancelOrder(aapl, 1));
+    assert(!engine.cancelOrder(aapl, 1));
+    assert(book->totalOrderCount() == 0);
+    
+    // Invalid handles are rejected rather than dereferenced
+    std::vector<Fill> out;
+    assert(engine.submitOrder(BookHandle(), Order(3, "AAPL", Side::Buy, OrderType::Limit,
+                                                  px(150.00), 10), out) == OrderStatus::Rejected);
+    assert(!engine.cancelOrder(BookHandle(), 3));
+    assert(out.empty());
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+static bool sameFill(const Fill& a, const Fill& b) {
+    return a.order_id == b.order_id && a.counter_order_id == b.counter_order_id &&
+           a.symbol == b.symbol && a.side == b.side &&
+           a.price == b.price && a.quantity == b.quantity;
+}
+
+// Burst of mixed orders over two symbols, most of them crossing
+static std::vector<Order> makeBurst() {
+    std::vector<Order> orders;
+    const OrderType types[] = {OrderType::Limit, OrderType::Limit, OrderType::IOC, OrderType::Market};
+    uint64_t seed = 12345;
+    for (OrderId id = 1; id <= 400; ++id) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t r = seed >> 33;
+        Symbol symbol = (r % 5 == 0) ? "MSFT" : "AAPL";
+        Side side = (r & 2) ? Side::Buy : Side::Sell;
+        OrderType type = types[(r >> 2) % 4];
+        Price price = 15000 + static_cast<Price>((r >> 4) % 11) - 5;
+        Quantity qty = 1 + static_cast<Quantity>((r >> 8) % 40);
+        orders.emplace_back(id, symbol, side, type, type == OrderType::Market ? 0 : price, qty);
+    }
+    return orders;
+}
+
+void test_batch_submission() {
+    std::cout << "Testing batch submission..." << std::endl;
+    
+    std::vector<Order> burst = makeBurst();
+    
+    // Reference: one call per order, recording the callback sequence
+    MatchingEngine sequential;
+    std::vector<OrderId> seq_events;
+    sequential.setFillCallback([&](const Fill& f) { seq_events.push_back(f.counter_order_id); });
+    sequential.setOrderCallback([&](const Order& o) { seq_events.push_back(1000000 + o.id); });
+    std::vector<Fill> seq_fills;
+    std::vector<OrderStatus> seq_status;
+    for (const Order& order : burst) {
+        seq_status.push_back(sequential.submitOrder(order, seq_fills));
+    }
+    assert(!seq_fills.empty());
+    
+    // Batches of uneven size; no batch callback, so events are replayed
+    MatchingEngine batched;
+    std::vector<OrderId> batch_events;
+    batched.setFillCallback([&](const Fill& f) { batch_events.push_back(f.counter_order_id); });
+    batched.setOrderCallback([&](const Order& o) { batch_events.push_back(1000000 + o.id); });
+    std::vector<Order> orders = burst;
+    std::vector<Fill> batch_fills;
+    size_t batch_calls = 0;
+    for (size_t start = 0; start < orders.size(); start += 37) {
+        size_t count = std::min<size_t>(37, orders.size() - start);
+        batched.submitOrders(Span<Order>(orders).subspan(start, count), batch_fills);
+    }
+    
+    assert(batch_fills.size() == seq_fills.size());
+    for (size_t i = 0; i < seq_fills.size(); ++i) {
+        assert(sameFill(batch_fills[i], seq_fills[i]));
+    }
+    for (size_t i = 0; i < orders.size(); ++i) {
+        assert(orders[i].status == seq_status[i]);
+    }
+    assert(batch_events == seq_events);
+    assert(batched.totalOrdersProcessed() == sequential.totalOrdersProcessed());
+    assert(batched.totalFillsGenerated() == sequential.totalFillsGenerated());
+    for (const char* symbol : {"AAPL", "MSFT"}) {
+        const OrderBook* a = sequential.getOrderBook(symbol);
+        const OrderBook* b = batched.getOrderBook(symbol);
+        assert(a->totalOrderCount() == b->totalOrderCount());
+        assert(a->getBestBid() == b->getBestBid());
+        assert(a->getBestAsk() == b->getBestAsk());
+    }
+    
+    // A repeated id (a resubmission) keeps each order's own fills: the
+    // first order 7 rests, the second sweeps order 8
+    std::vector<Order> repeated = {
+        Order(8, "DUPID", Side::Sell, OrderType::Limit, 100, 5),
+        Order(7, "DUPID", Side::Buy, OrderType::Limit, 90, 5),
+        Order(7, "DUPID", Side::Buy, OrderType::IOC, 100, 5)};
+    std::vector<Fill> repeated_fills;
+    seq_events.clear();
+    for (const Order& order : repeated) {
+        sequential.submitOrder(order, repeated_fills);
+    }
+    batch_events.clear();
+    batched.submitOrders(Span<Order>(repeated), repeated_fills);
+    assert(seq_events.size() == 4 && seq_events[2] == 8);
+    assert(batch_events == seq_events);
+    
+    // A batch callback replaces the per-event calls with one call per batch
+    MatchingEngine hooked;
+    size_t hooked_orders = 0;
+    size_t hooked_fills = 0;
+    hooked.setFillCallback([](const Fill&) { assert(false); });
+    hooked.setBatchCallback([&](Span<const Order> o, Span<const Fill> f) {
+        ++batch_calls;
+        hooked_orders += o.size();
+        hooked_fills += f.size();
+    });
+    orders = burst;
+    std::vector<Fill> hooked_buffer;
+    hooked.submitOrders(orders, hooked_buffer);
+    assert(batch_calls == 1);
+    assert(hooked_orders == burst.size());
+    assert(hooked_fills == seq_fills.size());
+    
+    // Batch cancel / modify through a handle
+    BookHandle aapl = batched.getBookHandle("AAPL");
+    const OrderBook* book = batched.getOrderBook(aapl);
+    std::vector<OrderId> resting;
+    for (const Order& order : orders) {
+        if (order.symbol == aapl.symbolId() && book->getOrder(order.id)) {
+            resting.push_back(order.id);
+        }
+    }
+    assert(!resting.empty());
+    std::vector<OrderModify> modifies;
+    for (OrderId id : resting) {
+        modifies.push_back({id, 0, 1});
+    }
+    modifies.push_back({999999, 0, 1});
+    assert(batched.modifyOrders(aapl, modifies) == resting.size());
+    assert(batched.cancelOrders(aapl, resting) == resting.size());
+    assert(batched.cancelOrders(aapl, resting) == 0);
+    assert(book->totalOrderCount() == 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+// Compile-time listener: records fills, counts order updates
+struct RecordingListener : NullListener {
+    std::vector<Fill> fills;
+    size_t order_updates = 0;
+    
+    void onFill(const Fill& fill) { fills.push_back(fill); }
+    void onOrder(const Order&) { ++order_updates; }
+};
+
+// Compile-time listener that calls back into its engine from a fill
+struct CancellingListener : NullListener {
+    BasicMatchingEngine<CancellingListener>* engine = nullptr;
+    std::vector<bool> cancelled;
+    
+    void onFill(const Fill& fill) {
+        cancelled.push_back(engine->cancelOrder(fill.symbol, fill.counter_order_id));
+    }
+};
+
+// Compile-time listener that answers the first fill of order 12 with a
+// crossing sell
+struct QuotingListener : NullListener {
+    BasicMatchingEngine<QuotingListener>* engine = nullptr;
+    std::vector<Fill> quote_fills;
+    
+    void onFill(const Fill& fill) {
+        if (fill.order_id == 12 && quote_fills.empty()) {
+            engine->submitOrder(Order(13, fill.symbol, Side::Sell, OrderType::Limit,
+                                      fill.price, 5), quote_fills);
+        }
+    }
+};
+
+void test_static_listener() {
+    std::cout << "Testing compile-time listener..." << std::endl;
+    
+    BasicMatchingEngine<RecordingListener> engine;
+    engine.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.00), 30));
+    engine.submitOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, px(150.01), 30));
+    auto fills = engine.submitOrder(Order(3, "AAPL", Side::Buy, OrderType::Limit, px(150.01), 50));
+    
+    const RecordingListener& listener = engine.listener();
+    assert(listener.order_updates == 3);
+    assert(listener.fills.size() == 2);
+    assert(listener.fills[0].counter_order_id == 1);
+    assert(listener.fills[1].counter_order_id == 2);
+    assert(listener.fills[1].quantity == 20);
+    assert(fills.size() == listener.fills.size());
+    
+    // Listeners that ignore everything still drive the book
+    BasicMatchingEngine<NullListener> quiet;
+    quiet.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.00), 10));
+    assert(quiet.submitOrder(Order(2, "AAPL", Side::Buy, OrderType::Market, 0, 10)).size() == 1);
+    assert(quiet.totalFillsGenerated() == 1);
+    
+    // Listeners run once the sweep is done, so they may re-enter the engine
+    BasicMatchingEngine<CancellingListener> reentrant;
+    reentrant.listener().engine = &reentrant;
+    reentrant.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.00), 10));
+    reentrant.submitOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, px(150.00), 30));
+    reentrant.submitOrder(Order(3, "AAPL", Side::Buy, OrderType::IOC, px(150.00), 20));
+    const std::vector<bool>& cancelled = reentrant.listener().cancelled;
+    assert(cancelled.size() == 2 && !cancelled[0] && cancelled[1]);
+    assert(reentrant.getOrderBook("AAPL")->totalOrderCount() == 0);
+    
+    // A nested submit sees the outer order's remainder resting, so it
+    // matches it rather than crossing the book
+    BasicMatchingEngine<QuotingListener> quoting;
+    quoting.listener().engine = &quoting;
+    quoting.submitOrder(Order(11, "AAPL", Side::Sell, OrderType::Limit, px(150.00), 10));
+    quoting.submitOrder(Order(12, "AAPL", Side::Buy, OrderType::Limit, px(150.00), 20));
+    const std::vector<Fill>& quote_fills = quoting.listener().quote_fills;
+    assert(quote_fills.size() == 1 && quote_fills[0].counter_order_id == 12);
+    const OrderBook* quoted = quoting.getOrderBook("AAPL");
+    assert(!quoted->getBestAsk() && quoted->getBestBid()->second == 5);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+struct LevelListener : NullListener {
+    std::vector<LevelUpdate> updates;
+    
+    void onLevelUpdate(const LevelUpdate& update) { updates.push_back(update); }
+};
+
+void test_level_updates() {
+    std::cout << "Testing market-by-price level updates..." << std::endl;
+    
+    BasicMatchingEngine<LevelListener> engine;
+    BookHandle book = engine.registerSymbol("AAPL");
+    std::vector<LevelUpdate>& updates = engine.listener().updates;
+    std::vector<Fill> fills;
+    
+    // 40 resting asks on 3 levels: one update per add
+    Price asks[3] = {px(150.00), px(150.01), px(150.02)};
+    for (OrderId id = 1; id <= 40; ++id) {
+        engine.submitOrder(book, Order(id, "AAPL", Side::Sell, OrderType::Limit,
+                                       asks[id % 3], 10), fills);
+    }
+    assert(updates.size() == 40);
+    assert(updates.back().quantity == 140 && updates.back().order_count == 14);
+    
+    // A sweep through all 40 orders reports each level once, not per fill
+    updates.clear();
+    engine.submitOrder(book, Order(100, "AAPL", Side::Buy, OrderType::Limit,
+                                   px(150.02), 395), fills);
+    assert(fills.size() == 40);
+    assert(updates.size() == 3);
+    for (size_t i = 0; i < 3; ++i) {
+        assert(updates[i].symbol == book.symbolId());
+        assert(updates[i].side == Side::Sell);
+        assert(updates[i].price == asks[i]);
+    }
+    assert(updates[0].quantity == 0 && updates[1].quantity == 0);
+    assert(updates[2].quantity == 5 && updates[2].order_count == 1);
+    
+    // Trading a level away and resting on the same price: one update each side
+    updates.clear();
+    engine.submitOrder(book, Order(101, "AAPL", Side::Buy, OrderType::Limit,
+                                   px(150.02), 25), fills);
+    assert(updates.size() == 2);
+    assert(updates[0].side == Side::Sell && updates[0].quantity == 0);
+    assert(updates[1].side == Side::Buy && updates[1].price == px(150.02));
+    assert(updates[1].quantity == 20 && updates[1].order_count == 1);
+    
+    // Cancel and price modify report the levels they touch
+    updates.clear();
+    assert(engine.modifyOrder(book, 101, px(149.99), 0));
+    assert(updates.size() == 2);
+    assert(updates[0].price == px(150.02) && updates[0].quantity == 0);
+    assert(updates[1].price == px(149.99) && updates[1].quantity == 20);
+    
+    updates.clear();
+    assert(!engine.cancelOrder(book, 999));
+    assert(updates.empty());
+    assert(engine.cancelOrder("AAPL", 101));
+    assert(updates.size() == 1 && updates[0].quantity == 0);
+    
+    // A batch adding and removing orders on one level nets to one update
+    updates.clear();
+    std::vector<Order> burst;
+    burst.emplace_back(200, "AAPL", Side::Sell, OrderType::Limit, px(151.00), 10);
+    burst.emplace_back(201, "AAPL", Side::Sell, OrderType::Limit, px(151.00), 10);
+    burst.emplace_back(202, "AAPL", Side::Buy, OrderType::IOC, px(151.00), 15);
+    engine.submitOrders(book, burst, fills);
+    assert(updates.size() == 1);
+    assert(updates[0].quantity == 5 && updates[0].order_count == 1);
+    assert(engine.getOrderBook(book)->pendingLevelUpdates() == 0);
+    
+    // Listeners without the hook leave tracking off
+    BasicMatchingEngine<NullListener> quiet;
+    quiet.submitOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.00), 10));
+    assert(quiet.getOrderBook("AAPL")->pendingLevelUpdates() == 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_level_updates_rebuild_book() {
+    std::cout << "Testing level updates against book depth..." << std::endl;
+    
+    MatchingEngine engine;
+    InstrumentSpec spec("AAPL");
+    BookHandle book = engine.registerInstrument(spec.withArrayLadder(10000, 200));
+    
+    // Apply every delta to a local L2 view
+    std::map<std::pair<int, Price>, Quantity> view;
+    engine.setLevelUpdateCallback([&view](const LevelUpdate& update) {
+        auto key = std::make_pair(static_cast<int>(update.side), update.price);
+        if (update.quantity == 0) {
+            view.erase(key);
+        } else {
+            view[key] = update.quantity;
+        }
+    });
+    
+    uint64_t seed = 7;
+    auto next = [&seed](uint64_t bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (seed >> 33) % bound;
+    };
+    
+    std::vector<Fill> fills;
+    for (OrderId id = 1; id <= 5000; ++id) {
+        switch (next(4)) {
+            case 0:
+                engine.cancelOrder(book, 1 + next(id));
+                break;
+            case 1:
+                engine.modifyOrder(book, 1 + next(id), 10090 + next(20), next(3) * 10);
+                break;
+            default: {
+                Side side = next(2) ? Side::Buy : Side::Sell;
+                Price price = 10090 + static_cast<Price>(next(20));
+                OrderType type = next(10) == 0 ? OrderType::IOC : OrderType::Limit;
+                engine.submitOrder(book, Order(id, "AAPL", side, type, price,
+                                               1 + next(50)), fills);
+                fills.clear();
+                break;
+            }
+        }
+    }
+    
+    // The view holds exactly the book's levels and totals
+    size_t levels = 0;
+    for (Side side : {Side::Buy, Side::Sell}) {
+        engine.getOrderBook(book)->visitDepth(side, 1000, [&](const DepthLevel& level) {
+            auto it = view.find(std::make_pair(static_cast<int>(side), level.price));
+            assert(it != view.end() && it->second == level.quantity);
+            ++levels;
+            return true;
+        });
+    }
+    assert(levels == view.size());
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
 int main() {
     std::cout << "\n=== Matching Engine Tests ===" << std::endl;
     
@@ -228,11 +823,21 @@ int main() {
     test_limit_order_match();
     test_market_order();
     test_ioc_order();
+    test_fok_order();
     test_cancel_order();
     test_multiple_symbols();
     test_callbacks();
+    test_callback_reentry();
+    test_callback_submit();
     test_with_risk_manager();
     test_statistics();
+    test_instrument_ticks();
+    test_symbol_ids();
+    test_static_listener();
+    test_book_handles();
+    test_batch_submission();
+    test_level_updates();
+    test_level_updates_rebuild_book();
     
     std::cout << "\n=== All Matching Engine Tests Passed! ===" << std::endl;
     return 0;
@@ -1,22 +1,27 @@
 #include "../include/order_book.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <vector>
 
 using namespace trading;
 
+// Test prices are written in dollars and converted to cent ticks
+static Price px(double price) { return toTicks(price); }
+
 void test_add_order() {
     std::cout << "Testing addOrder..." << std::endl;
     
     OrderBook book("AAPL");
     
     // Add buy order
-    Order buy_order(1, "AAPL", Side::Buy, OrderType::Limit, 150.0, 100);
+    Order buy_order(1, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100);
     assert(book.addOrder(buy_order));
     assert(book.bidOrderCount() == 1);
     assert(book.askOrderCount() == 0);
     
     // Add sell order
-    Order sell_order(2, "AAPL", Side::Sell, OrderType::Limit, 151.0, 50);
+    Order sell_order(2, "AAPL", Side::Sell, OrderType::Limit, px(151.0), 50);
     assert(book.addOrder(sell_order));
     assert(book.bidOrderCount() == 1);
     assert(book.askOrderCount() == 1);
@@ -24,18 +29,18 @@ void test_add_order() {
     // Check best bid/ask
     auto best_bid = book.getBestBid();
     assert(best_bid.has_value());
-    assert(best_bid->first == 150.0);
+    assert(best_bid->first == px(150.0));
     assert(best_bid->second == 100);
     
     auto best_ask = book.getBestAsk();
     assert(best_ask.has_value());
-    assert(best_ask->first == 151.0);
+    assert(best_ask->first == px(151.0));
     assert(best_ask->second == 50);
     
     // Check spread
     auto spread = book.getSpread();
     assert(spread.has_value());
-    assert(spread.value() == 1.0);
+    assert(spread.value() == px(1.0));
     
     std::cout << "  PASSED" << std::endl;
 }
@@ -46,8 +51,8 @@ void test_cancel_order() {
     OrderBook book("AAPL");
     
     // Add orders
-    Order order1(1, "AAPL", Side::Buy, OrderType::Limit, 150.0, 100);
-    Order order2(2, "AAPL", Side::Buy, OrderType::Limit, 149.0, 200);
+    Order order1(1, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100);
+    Order order2(2, "AAPL", Side::Buy, OrderType::Limit, px(149.0), 200);
     book.addOrder(order1);
     book.addOrder(order2);
     
@@ -63,7 +68,7 @@ void test_cancel_order() {
     // Best bid should now be 149.0
     auto best_bid = book.getBestBid();
     assert(best_bid.has_value());
-    assert(best_bid->first == 149.0);
+    assert(best_bid->first == px(149.0));
     
     std::cout << "  PASSED" << std::endl;
 }
@@ -74,21 +79,21 @@ void test_multiple_price_levels() {
     OrderBook book("AAPL");
     
     // Add orders at different price levels
-    book.addOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, 150.0, 100));
-    book.addOrder(Order(2, "AAPL", Side::Buy, OrderType::Limit, 149.5, 200));
-    book.addOrder(Order(3, "AAPL", Side::Buy, OrderType::Limit, 149.0, 150));
-    book.addOrder(Order(4, "AAPL", Side::Buy, OrderType::Limit, 150.0, 50));  // Same level as order 1
+    book.addOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100));
+    book.addOrder(Order(2, "AAPL", Side::Buy, OrderType::Limit, px(149.5), 200));
+    book.addOrder(Order(3, "AAPL", Side::Buy, OrderType::Limit, px(149.0), 150));
+    book.addOrder(Order(4, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 50));  // Same level as order 1
     
     // Get bid levels
     auto levels = book.getBidLevels(5);
     assert(levels.size() == 3);
     
     // Check ordering (highest price first)
-    assert(levels[0].price == 150.0);
+    assert(levels[0].price == px(150.0));
     assert(levels[0].total_quantity == 150);  // 100 + 50
-    assert(levels[1].price == 149.5);
+    assert(levels[1].price == px(149.5));
     assert(levels[1].total_quantity == 200);
-    assert(levels[2].price == 149.0);
+    assert(levels[2].price == px(149.0));
     
     std::cout << "  PASSED" << std::endl;
 }
@@ -99,23 +104,23 @@ void test_execute_fill() {
     OrderBook book("AAPL");
     
     // Add resting sell orders
-    book.addOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, 150.0, 100));
-    book.addOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, 150.5, 200));
-    book.addOrder(Order(3, "AAPL", Side::Sell, OrderType::Limit, 151.0, 150));
+    book.addOrder(Order(1, "AAPL", Side::Sell, OrderType::Limit, px(150.0), 100));
+    book.addOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, px(150.5), 200));
+    book.addOrder(Order(3, "AAPL", Side::Sell, OrderType::Limit, px(151.0), 150));
     
     // Execute buy order that matches first two levels
-    auto fills = book.executeFill(Side::Buy, 250, 151.0, 100);
+    auto fills = book.executeFill(Side::Buy, 250, px(151.0), 100);
     
     assert(fills.size() == 2);  // Matched two orders
-    assert(fills[0].price == 150.0);
+    assert(fills[0].price == px(150.0));
     assert(fills[0].quantity == 100);
-    assert(fills[1].price == 150.5);
+    assert(fills[1].price == px(150.5));
     assert(fills[1].quantity == 150);
     
     // Check remaining order book state
     auto best_ask = book.getBestAsk();
     assert(best_ask.has_value());
-    assert(best_ask->first == 150.5);
+    assert(best_ask->first == px(150.5));
     assert(best_ask->second == 50);  // 200 - 150 filled
     
     std::cout << "  PASSED" << std::endl;
@@ -126,14 +131,14 @@ void test_order_lookup() {
     
     OrderBook book("AAPL");
     
-    Order order(1, "AAPL", Side::Buy, OrderType::Limit, 150.0, 100);
+    Order order(1, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100);
     book.addOrder(order);
     
     // Lookup existing order
     const Order* found = book.getOrder(1);
     assert(found != nullptr);
     assert(found->id == 1);
-    assert(found->price == 150.0);
+    assert(found->price == px(150.0));
     
     // Lookup non-existent order
     const Order* not_found = book.getOrder(999);
@@ -147,7 +152,7 @@ void test_modify_order() {
     
     OrderBook book("AAPL");
     
-    Order order(1, "AAPL", Side::Buy, OrderType::Limit, 150.0, 100);
+    Order order(1, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100);
     book.addOrder(order);
     
     // Modify quantity only
@@ -156,13 +161,13 @@ void test_modify_order() {
     const Order* modified = book.getOrder(1);
     assert(modified != nullptr);
     assert(modified->quantity == 200);
-    assert(modified->price == 150.0);
+    assert(modified->price == px(150.0));
     
     // Modify price (will re-add order)
-    assert(book.modifyOrder(1, 151.0, 0));
+    assert(book.modifyOrder(1, px(151.0), 0));
     
     auto best_bid = book.getBestBid();
-    assert(best_bid->first == 151.0);
+    assert(best_bid->first == px(151.0));
     
     std::cout << "  PASSED" << std::endl;
 }
@@ -176,15 +181,375 @@ void test_mid_price() {
     assert(!book.getMidPrice().has_value());
     
     // Only bid - no mid price
-    book.addOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, 150.0, 100));
+    book.addOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100));
     assert(!book.getMidPrice().has_value());
     
     // Both sides - has mid price
-    book.addOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, 152.0, 100));
+    book.addOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, px(152.0), 100));
     
     auto mid = book.getMidPrice();
     assert(mid.has_value());
-    assert(mid.value() == 151.0);  // (150 + 152) / 2
+    assert(mid.value() == px(151.0));  // (150 + 152) / 2
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_array_layout() {
+    std::cout << "Testing array ladder layout..." << std::endl;
+    
+    // Band covers 100.00 - 199.99
+    InstrumentSpec spec("AAPL");
+    spec.withArrayLadder(px(100.0), 10000);
+    OrderBook book(spec);
+    
+    book.addOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, px(150.0), 100));
+    book.addOrder(Order(2, "AAPL", Side::Buy, OrderType::Limit, px(149.5), 200));
+    book.addOrder(Order(3, "AAPL", Side::Sell, OrderType::Limit, px(151.0), 50));
+    book.addOrder(Order(4, "AAPL", Side::Sell, OrderType::Limit, px(152.0), 75));
+    
+    // Prices outside the band are rejected
+    assert(!book.addOrder(Order(5, "AAPL", Side::Buy, OrderType::Limit, px(99.99), 10)));
+    assert(!book.addOrder(Order(6, "AAPL", Side::Sell, OrderType::Limit, px(200.0), 10)));
+    assert(!book.modifyOrder(1, px(250.0), 0));
+    assert(book.totalOrderCount() == 4);
+    
+    assert(book.getBestBid()->first == px(150.0));
+    assert(book.getBestAsk()->first == px(151.0));
+    
+    // Cancelling the touch moves the best price to the next level
+    assert(book.cancelOrder(1));
+    assert(book.getBestBid()->first == px(149.5));
+    
+    // Levels are reported in priority order
+    auto asks = book.getAskLevels(5);
+    assert(asks.size() == 2);
+    assert(asks[0].price == px(151.0));
+    assert(asks[1].price == px(152.0));
+    
+    // Sweep both ask levels
+    auto fills = book.executeFill(Side::Buy, 100, px(152.0), 100);
+    assert(fills.size() == 2);
+    assert(fills[1].price == px(152.0));
+    assert(fills[1].quantity == 50);
+    assert(book.getBestAsk()->first == px(152.0));
+    assert(book.getBestAsk()->second == 25);
+    
+    auto last = book.executeFill(Side::Buy, 100, 0, 101);
+    assert(last.size() == 1);
+    assert(!book.getBestAsk().has_value());
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_price_bitmap() {
+    std::cout << "Testing PriceBitmap..." << std::endl;
+    
+    // Spans several level-2 words (64^3 slots each)
+    PriceBitmap bitmap(600000);
+    assert(bitmap.findFirst() == PriceBitmap::npos);
+    
+    bitmap.set(5);
+    bitmap.set(64);
+    bitmap.set(4095);
+    bitmap.set(4096);
+    bitmap.set(599999);
+    
+    assert(bitmap.findFirst() == 5);
+    assert(bitmap.findNext(6) == 64);
+    assert(bitmap.findNext(65) == 4095);
+    assert(bitmap.findNext(4096) == 4096);
+    assert(bitmap.findNext(4097) == 599999);
+    assert(bitmap.findNext(600000) == PriceBitmap::npos);
+    
+    // Clearing the last bit in a word must clear the summary bits too
+    bitmap.clear(4095);
+    bitmap.clear(4096);
+    assert(bitmap.findNext(65) == 599999);
+    bitmap.clear(599999);
+    assert(bitmap.findNext(65) == PriceBitmap::npos);
+    assert(bitmap.test(64) && !bitmap.test(4096));
+    
+    // Sweeping a wide, sparse array book lands on each level in turn
+    InstrumentSpec spec("WIDE");
+    spec.withArrayLadder(0, 1 << 20);
+    OrderBook book(spec);
+    book.addOrder(Order(1, "WIDE", Side::Sell, OrderType::Limit, 10, 5));
+    book.addOrder(Order(2, "WIDE", Side::Sell, OrderType::Limit, 300000, 5));
+    book.addOrder(Order(3, "WIDE", Side::Sell, OrderType::Limit, 1000000, 5));
+    book.addOrder(Order(4, "WIDE", Side::Buy, OrderType::Limit, 9, 5));
+    book.addOrder(Order(5, "WIDE", Side::Buy, OrderType::Limit, 2, 5));
+    
+    assert(book.cancelOrder(2));
+    auto fills = book.executeFill(Side::Buy, 10, MAX_PRICE, 100);
+    assert(fills.size() == 2);
+    assert(fills[1].price == 1000000);
+    assert(!book.getBestAsk().has_value());
+    
+    assert(book.cancelOrder(4));
+    assert(book.getBestBid()->first == 2);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_order_index_churn() {
+    std::cout << "Testing OrderIndex under cancel churn..." << std::endl;
+    
+    // Node addresses only need to be distinct for the index
+    std::vector<OrderNode> nodes(1000);
+    OrderIndex index;
+    for (OrderId id = 1; id <= 1000; ++id) {
+        assert(index.insert(id, &nodes[id - 1]));
+    }
+    assert(!index.insert(1, &nodes[0]));
+    size_t capacity = index.capacity();
+    
+    // Replace every resting id many times over; without tombstones the
+    // table never grows and every live id stays reachable
+    std::vector<OrderId> live(1000);
+    for (size_t i = 0; i < live.size(); ++i) {
+        live[i] = i + 1;
+    }
+    OrderId next_id = 1001;
+    for (size_t step = 0; step < 100000; ++step) {
+        size_t slot = (step * 7919) % live.size();
+        assert(index.erase(live[slot]));
+        assert(!index.contains(live[slot]));
+        assert(index.insert(next_id, &nodes[slot]));
+        live[slot] = next_id++;
+    }
+    
+    assert(index.size() == 1000);
+    assert(index.capacity() == capacity);
+    for (size_t i = 0; i < live.size(); ++i) {
+        assert(index.find(live[i]) == &nodes[i]);
+    }
+    assert(!index.erase(1));
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_depth_view() {
+    std::cout << "Testing depth view..." << std::endl;
+    
+    for (int layout = 0; layout < 2; ++layout) {
+        InstrumentSpec spec("AAPL");
+        if (layout == 1) {
+            spec.withArrayLadder(px(100.00), 10000);
+        }
+        OrderBook book(spec);
+        
+        // Bids: 3 orders at 150.00, 1 at 149.99; asks: 2 at 150.05
+        book.addOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, px(150.00), 100));
+        book.addOrder(Order(2, "AAPL", Side::Buy, OrderType::Limit, px(150.00), 50));
+        book.addOrder(Order(3, "AAPL", Side::Buy, OrderType::Limit, px(150.00), 25));
+        book.addOrder(Order(4, "AAPL", Side::Buy, OrderType::Limit, px(149.99), 10));
+        book.addOrder(Order(5, "AAPL", Side::Sell, OrderType::Limit, px(150.05), 40));
+        book.addOrder(Order(6, "AAPL", Side::Sell, OrderType::Limit, px(150.05), 60));
+        
+        auto bids = book.getDepth<5>(Side::Buy);
+        assert(bids.size() == 2);
+        assert(bids[0].price == px(150.00));
+        assert(bids[0].quantity == 175);
+        assert(bids[0].order_count == 3);
+        assert(bids[1].price == px(149.99));
+        assert(bids[1].order_count == 1);
+        
+        auto asks = book.getDepth<5>(Side::Sell);
+        assert(asks.size() == 1);
+        assert(asks[0].quantity == 100);
+        assert(asks[0].order_count == 2);
+        
+        // Capacity and explicit level limits both cap the copy
+        assert(book.getDepth<1>(Side::Buy).size() == 1);
+        assert(book.getDepth<5>(Side::Buy, 1).size() == 1);
+        
+        // Aggregates agree with the full snapshot
+        auto snapshot = book.getBidLevels(5);
+        size_t i = 0;
+        for (const DepthLevel& level : bids) {
+            assert(level.price == snapshot[i].price);
+            assert(level.quantity == snapshot[i].total_quantity);
+            assert(level.order_count == snapshot[i].order_count());
+            ++i;
+        }
+        
+        // Visitor can stop early
+        size_t seen = book.visitDepth(Side::Buy, 10, [](const DepthLevel&) { return false; });
+        assert(seen == 1);
+        assert(book.visitDepth(Side::Buy, 0, [](const DepthLevel&) { return true; }) == 0);
+    }
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+// Cached depth must equal a fresh walk of the ladder
+static void checkDepthCache(const OrderBook& book, Side side) {
+    const auto& cached = book.cachedDepth(side);
+    auto fresh = (side == Side::Buy) ? book.getBidLevels(DepthCache::LEVELS)
+                                     : book.getAskLevels(DepthCache::LEVELS);
+    assert(cached.size() == fresh.size());
+    for (size_t i = 0; i < fresh.size(); ++i) {
+        assert(cached[i].price == fresh[i].price);
+        assert(cached[i].quantity == fresh[i].total_quantity);
+        assert(cached[i].order_count == fresh[i].order_count());
+    }
+}
+
+void test_depth_cache() {
+    std::cout << "Testing incremental depth cache..." << std::endl;
+    
+    for (int layout = 0; layout < 2; ++layout) {
+        InstrumentSpec spec("AAPL");
+        if (layout == 1) {
+            spec.withArrayLadder(9000, 2000);
+        }
+        OrderBook book(spec);
+        
+        uint64_t version = book.version();
+        assert(!book.cancelOrder(1));
+        assert(book.version() == version);
+        
+        // Random adds, cancels, modifies and sweeps over ~40 levels per side
+        // so levels keep moving in and out of the cached top N
+        uint64_t seed = 42;
+        auto next = [&seed]() {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            return seed;
+        };
+        OrderId next_id = 1;
+        for (int step = 0; step < 20000; ++step) {
+            uint64_t r = next();
+            uint64_t before = book.version();
+            bool changed = false;
+            switch (r % 8) {
+                case 0: case 1: case 2: {
+                    Side side = (r & 8) ? Side::Buy : Side::Sell;
+                    Price offset = 1 + static_cast<Price>((r >> 4) % 40);
+                    Price price = (side == Side::Buy) ? 10000 - offset : 10000 + offset;
+                    changed = book.addOrder(Order(next_id++, "AAPL", side, OrderType::Limit,
+                                                  price, 1 + (r >> 12) % 50));
+                    break;
+                }
+                case 3: case 4:
+                    changed = book.cancelOrder(1 + (r >> 4) % next_id);
+                    break;
+                case 5: {
+                    OrderId id = 1 + (r >> 4) % next_id;
+                    const Order* order = book.getOrder(id);
+                    Quantity qty = 1 + static_cast<Quantity>((r >> 20) % 80);
+                    bool differs = order && qty != order->quantity;
+                    changed = book.modifyOrder(id, 0, qty) && differs;
+                    break;
+                }
+                case 6: {
+                    OrderId id = 1 + (r >> 4) % next_id;
+                    const Order* order = book.getOrder(id);
+                    if (order) {
+                        Price shift = static_cast<Price>((r >> 20) % 7) - 3;
+                        Price price = order->price + shift;
+                        bool valid = (order->side == Side::Buy) ? price < 10000 : price > 10000;
+                        changed = valid && shift != 0 && book.modifyOrder(id, price, 0);
+                    }
+                    break;
+                }
+                case 7: {
+                    Side side = (r & 8) ? Side::Buy : Side::Sell;
+                    Quantity qty = 1 + static_cast<Quantity>((r >> 4) % 300);
+                    changed = book.executeFill(side, qty, 0, 900000000 + step,
+                                               [](const Fill&) {}) > 0;
+                    break;
+                }
+            }
+            assert(changed ? book.version() > before : book.version() == before);
+            checkDepthCache(book, Side::Buy);
+            checkDepthCache(book, Side::Sell);
+        }
+        
+        // Deeper requests than the cache fall back to the ladder
+        size_t deep = book.visitDepth(Side::Buy, 30, [](const DepthLevel&) { return true; });
+        assert(deep == std::min<size_t>(30, book.getBidLevels(100).size()));
+    }
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_available_liquidity() {
+    std::cout << "Testing available liquidity..." << std::endl;
+    
+    for (int layout = 0; layout < 2; ++layout) {
+        InstrumentSpec spec("AAPL");
+        if (layout == 1) {
+            spec.withArrayLadder(9000, 2000);
+        }
+        OrderBook book(spec);
+        assert(book.availableLiquidity(Side::Buy, 10100, 10) == 0);
+        
+        // 30 ask levels (deeper than the depth cache) of 10 each, 10001..10030,
+        // and one bid level
+        OrderId id = 1;
+        for (Price price = 10001; price <= 10030; ++price) {
+            book.addOrder(Order(id++, "AAPL", Side::Sell, OrderType::Limit, price, 4));
+            book.addOrder(Order(id++, "AAPL", Side::Sell, OrderType::Limit, price, 6));
+        }
+        book.addOrder(Order(id++, "AAPL", Side::Buy, OrderType::Limit, 9990, 25));
+        uint64_t version = book.version();
+        uint64_t hash = book.stateHash();
+        
+        // Covered at the touch: early exit caps the answer at what was asked
+        assert(book.availableLiquidity(Side::Buy, 10001, 7) == 7);
+        assert(book.availableLiquidity(Side::Buy, 10001, 50) == 10);
+        // Limit price bounds the levels counted
+        assert(book.availableLiquidity(Side::Buy, 10005, 1000) == 50);
+        assert(book.availableLiquidity(Side::Buy, 10000, 1000) == 0);
+        // Beyond the cached levels, and market orders (no limit)
+        assert(book.availableLiquidity(Side::Buy, 10025, 1000) == 250);
+        assert(book.availableLiquidity(Side::Buy, 10025, 215) == 215);
+        assert(book.availableLiquidity(Side::Buy, 0, 1000) == 300);
+        // Sells look at the bids
+        assert(book.availableLiquidity(Side::Sell, 9990, 100) == 25);
+        assert(book.availableLiquidity(Side::Sell, 9991, 100) == 0);
+        
+        // Nothing was touched
+        assert(book.version() == version && book.stateHash() == hash);
+        assert(book.askOrderCount() == 60);
+    }
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_level_change_set() {
+    std::cout << "Testing level change set collapses repeat changes..." << std::endl;
+    
+    // A sweep over many levels, then a second change to every level: one
+    // entry per level, in first-change order, holding the final state
+    LevelChangeSet changes;
+    for (int round = 0; round < 2; ++round) {
+        for (Price price = 1; price <= 1000; ++price) {
+            changes.record(Side::Buy, price, price + round, 1 + round);
+            changes.record(Side::Sell, price, 2 * price + round, 1 + round);
+        }
+        assert(changes.size() == 2000);
+    }
+    Price price = 1;
+    bool sell = false;
+    for (const LevelUpdate& update : changes) {
+        assert(update.side == (sell ? Side::Sell : Side::Buy) && update.price == price);
+        assert(update.quantity == (sell ? 2 * price : price) + 1 && update.order_count == 2);
+        price += sell ? 1 : 0;
+        sell = !sell;
+    }
+    
+    // Cleared entries are gone from the index too
+    changes.clear();
+    assert(changes.empty());
+    changes.record(Side::Sell, 500, 0, 0);
+    changes.record(Side::Buy, 500, 7, 1);
+    changes.record(Side::Sell, 500, 3, 2);
+    assert(changes.size() == 2);
+    assert(changes.begin()->side == Side::Sell && changes.begin()->quantity == 3);
+    assert(changes.begin()[1].side == Side::Buy && changes.begin()[1].quantity == 7);
     
     std::cout << "  PASSED" << std::endl;
 }
@@ -199,6 +564,13 @@ int main() {
     test_order_lookup();
     test_modify_order();
     test_mid_price();
+    test_array_layout();
+    test_price_bitmap();
+    test_order_index_churn();
+    test_depth_view();
+    test_depth_cache();
+    test_available_liquidity();
+    test_level_change_set();
     
     std::cout << "\n=== All Order Book Tests Passed! ===" << std::endl;
     return 0;
@@ -0,0 +1,358 @@
+#include "../include/engine_pipeline.hpp"
+#include "../include/journal_replay.hpp"
+#include "test_util.hpp"
+#include <atomic>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <iterator>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace trading;
+
+struct Event {
+    bool fill;
+    OrderId order_id;
+    OrderId counter_order_id;
+    Quantity quantity;
+    OrderStatus status;
+    
+    bool operator==(const Event& other) const {
+        return fill == other.fill && order_id == other.order_id &&
+               counter_order_id == other.counter_order_id &&
+               quantity == other.quantity && status == other.status;
+    }
+};
+
+struct RecordingListener : NullListener {
+    std::vector<Event>* events = nullptr;
+    
+    void onFill(const Fill& fill) {
+        events->push_back({true, fill.order_id, fill.counter_order_id, fill.quantity,
+                           OrderStatus::New});
+    }
+    void onOrder(const Order& order) {
+        events->push_back({false, order.id, 0, order.filled_qty, order.status});
+    }
+};
+
+static const char* kSymbols[] = {"PLA", "PLB", "PLC"};
+
+// Crossing flow on three books, one registered up front: limits, IOCs,
+// cancels, modifies and some orders over the size limit
+static std::vector<EngineCommand> makeFlow(int count) {
+    testutil::FlowSpec spec;
+    spec.symbols.assign(std::begin(kSymbols), std::end(kSymbols));
+    std::vector<EngineCommand> flow = testutil::makeFlow(spec, 11, count);
+    // Never traded: not journaled by either engine
+    std::vector<EngineCommand> commands = {EngineCommand::cancel(internSymbol("PLZ"), 1)};
+    commands.insert(commands.end(), flow.begin(), flow.end());
+    return commands;
+}
+
+static std::shared_ptr<RiskManager> makeRisk() { return testutil::makeRisk(kSymbols, 25); }
+
+void test_lifecycle() {
+    std::cout << "Testing pipeline start and stop..." << std::endl;
+    
+    EnginePipeline<> pipeline;
+    assert(pipeline.capacity() == 4096);
+    assert(!pipeline.running());
+    assert(!pipeline.submitOrder(Order(1, "PLA", Side::Buy, OrderType::Limit, 500, 10)));
+    
+    auto risk = std::make_shared<RiskManager>();
+    assert(!risk->locking());
+    assert(pipeline.setRiskManager(risk));
+    assert(risk->locking());
+    assert(pipeline.registerSymbol("PLA"));
+    assert(pipeline.start());
+    assert(!pipeline.start());
+    assert(!pipeline.registerSymbol("PLB"));
+    assert(!pipeline.setJournal(nullptr));
+    
+    assert(pipeline.submitOrder(Order(1, "PLA", Side::Buy, OrderType::Limit, 500, 10)));
+    assert(pipeline.submitOrder(Order(2, "PLA", Side::Sell, OrderType::Limit, 500, 4)));
+    pipeline.waitIdle();
+    assert(pipeline.completed() == 2 && pipeline.matched() == 2 && pipeline.checked() == 2);
+    assert(pipeline.engine().getOrderBook("PLA")->getOrder(1)->remaining_qty() == 6);
+    assert(risk->getPosition(internSymbol("PLA")) == -4);    // Positions follow the aggressor
+    
+    pipeline.stop();
+    assert(!pipeline.running());
+    assert(!pipeline.cancelOrder(internSymbol("PLA"), 1));
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_matches_serial_engine() {
+    std::cout << "Testing the pipeline against a serial engine..." << std::endl;
+    
+    std::vector<EngineCommand> commands = makeFlow(30000);
+    std::string pid = std::to_string(::getpid());
+    std::string serial_path = "test_pipeline_serial_" + pid + ".bin";
+    std::string pipeline_path = "test_pipeline_" + pid + ".bin";
+    std::remove(serial_path.c_str());
+    std::remove(pipeline_path.c_str());
+    
+    // Serial reference: risk check, match, positions and events inline
+    std::vector<Event> serial_events;
+    RecordingListener serial_listener;
+    serial_listener.events = &serial_events;
+    BasicMatchingEngine<RecordingListener> serial(serial_listener);
+    serial.registerSymbol("PLB");
+    serial.setRiskManager(makeRisk());
+    auto serial_journal = testutil::openJournal(serial_path);
+    serial.setJournal(serial_journal);
+    std::vector<Fill> fills;
+    for (const EngineCommand& command : commands) {
+        applyCommand(serial, command, fills);
+    }
+    serial_journal->close();
+    
+    // Small ring and batches so the stages lap each other many times
+    std::vector<Event> events;
+    RecordingListener listener;
+    listener.events = &events;
+    PipelineOptions options;
+    options.capacity = 64;
+    options.batch_size = 16;
+    EnginePipeline<RecordingListener> pipeline(options, listener);
+    auto risk = makeRisk();
+    auto journal = testutil::openJournal(pipeline_path);
+    pipeline.registerSymbol("PLB");
+    pipeline.setRiskManager(risk);
+    pipeline.setJournal(journal);
+    assert(pipeline.start());
+    for (const EngineCommand& command : commands) {
+        assert(pipeline.publish(command));
+    }
+    pipeline.stop();
+    journal->close();
+    
+    // Same events, books and positions
+    const std::vector<Event>& published = *pipeline.listener().events;
+    assert(published.size() == serial_events.size());
+    for (size_t i = 0; i < published.size(); ++i) {
+        assert(published[i] == serial_events[i]);
+    }
+    size_t rejected = 0;
+    for (const Event& event : published) {
+        rejected += (!event.fill && event.status == OrderStatus::Rejected) ? 1 : 0;
+    }
+    assert(rejected > 0);
+    assert(pipeline.stateHash() == serial.stateHash());
+    for (const char* symbol : {"PLA", "PLB", "PLC"}) {
+        assert(risk->getPosition(symbol) == serial.riskManager()->getPosition(symbol));
+    }
+    
+    // Same journal, record for record
+    JournalReader serial_reader;
+    JournalReader reader;
+    assert(serial_reader.open(serial_path));
+    assert(reader.open(pipeline_path));
+    JournalRecord expected;
+    JournalRecord record;
+    InstrumentSpec spec;
+    size_t records = 0;
+    while (serial_reader.next(expected, spec)) {
+        assert(reader.next(record, spec));
+        assert(record.sequence == expected.sequence && record.type == expected.type);
+        assert(record.symbol == expected.symbol && record.order_id == expected.order_id);
+        assert(record.quantity == expected.quantity && record.price == expected.price);
+        ++records;
+    }
+    assert(!reader.next(record, spec));
+    assert(records > commands.size());
+    
+    // And it replays to the same state
+    BasicMatchingEngine<NullListener> replayed;
+    replayed.setRiskManager(makeRisk());
+    ReplayResult result = replayJournal(pipeline_path, replayed);
+    assert(result.ok && result.rejected == rejected);
+    assert(replayed.stateHash() == serial.stateHash());
+    
+    std::remove(serial_path.c_str());
+    std::remove(pipeline_path.c_str());
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+// Stage 3 listener that blocks in its first fill until released
+struct StallingListener : RecordingListener {
+    std::atomic<bool>* release = nullptr;
+    
+    void onFill(const Fill& fill) {
+        while (!release->load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        RecordingListener::onFill(fill);
+    }
+};
+
+void test_binding_limit() {
+    std::cout << "Testing a binding position limit sees lagging positions..." << std::endl;
+    
+    // Two resting sells, then two buys that each fill 10 against a limit
+    // of 10: a serial engine rejects the second buy
+    SymbolId symbol = internSymbol("PLL");
+    std::vector<EngineCommand> commands = {
+        EngineCommand::submit(Order(1, symbol, Side::Sell, OrderType::Limit, 500, 10)),
+        EngineCommand::submit(Order(2, symbol, Side::Sell, OrderType::Limit, 500, 10)),
+        EngineCommand::submit(Order(3, symbol, Side::Buy, OrderType::IOC, 500, 10)),
+        EngineCommand::submit(Order(4, symbol, Side::Buy, OrderType::IOC, 500, 10))};
+    auto makeLimit = []() {
+        auto risk = std::make_shared<RiskManager>();
+        risk->setPositionLimit("PLL", 10);
+        return risk;
+    };
+    
+    BasicMatchingEngine<NullListener> serial;
+    serial.setRiskManager(makeLimit());
+    std::vector<Fill> fills;
+    std::vector<OrderStatus> serial_status;
+    for (const EngineCommand& command : commands) {
+        serial_status.push_back(serial.submitOrder(command.toOrder(), fills));
+    }
+    assert(serial_status[2] == OrderStatus::Filled && serial_status[3] == OrderStatus::Rejected);
+    assert(serial.riskManager()->getPosition("PLL") == 10);
+    
+    // Stage 3 holds order 3's fill, so its position is not counted when
+    // stage 1 checks order 4
+    std::string path = "test_pipeline_limit_" + std::to_string(::getpid()) + ".bin";
+    std::remove(path.c_str());
+    std::atomic<bool> release{false};
+    std::vector<Event> events;
+    StallingListener listener;
+    listener.release = &release;
+    listener.events = &events;
+    EnginePipeline<StallingListener> pipeline(PipelineOptions(), listener);
+    auto risk = makeLimit();
+    auto journal = testutil::openJournal(path);
+    pipeline.setRiskManager(risk);
+    pipeline.setJournal(journal);
+    assert(pipeline.start());
+    for (const EngineCommand& command : commands) {
+        assert(pipeline.publish(command));
+    }
+    while (pipeline.matched() < commands.size()) {
+        std::this_thread::yield();
+    }
+    release.store(true, std::memory_order_release);
+    pipeline.stop();
+    journal->close();
+    
+    // Order 4 got through and breached the limit: the state differs from
+    // the serial engine's, but the journal still replays to it
+    assert(events.size() == 6);
+    assert(!events[5].fill && events[5].order_id == 4 && events[5].status == OrderStatus::Filled);
+    assert(risk->getPosition("PLL") == 20);
+    assert(pipeline.stateHash() != serial.stateHash());
+    BasicMatchingEngine<NullListener> replayed;
+    replayed.setRiskManager(std::make_shared<RiskManager>());
+    ReplayResult result = replayJournal(path, replayed);
+    assert(result.ok && result.rejected == 0 && result.commands == 4);
+    assert(replayed.stateHash() == pipeline.stateHash());
+    std::remove(path.c_str());
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_journal_write_failure() {
+    std::cout << "Testing a batch whose journal write fails is not applied..." << std::endl;
+    
+    std::string path = "test_pipeline_failure_" + std::to_string(::getpid()) + ".bin";
+    std::remove(path.c_str());
+    std::vector<Event> events;
+    RecordingListener listener;
+    listener.events = &events;
+    EnginePipeline<RecordingListener> pipeline(PipelineOptions(), listener);
+    auto journal = testutil::openJournal(path);
+    pipeline.registerSymbol("PLF");
+    pipeline.setJournal(journal);
+    assert(pipeline.start());
+    SymbolId symbol = internSymbol("PLF");
+    assert(pipeline.submitOrder(Order(1, symbol, Side::Sell, OrderType::Limit, 500, 10)));
+    pipeline.waitIdle();
+    uint64_t hash = pipeline.stateHash();
+    events.clear();
+    
+    // Swap the journal's descriptor between a full device and the file.
+    // The pipeline is idle, so this thread may touch the journal until it
+    // publishes again.
+    int fd = testutil::openDescriptor(path);
+    int saved = ::dup(fd);
+    assert(fd >= 0 && saved >= 0);
+    auto fill_device = [fd]() {
+        int full = ::open("/dev/full", O_WRONLY);
+        assert(full >= 0 && ::dup2(full, fd) == fd);
+        ::close(full);
+    };
+    auto recover = [&]() {
+        assert(journal->failed());
+        assert(::dup2(saved, fd) == fd);
+        assert(journal->commit() && !journal->failed());
+    };
+    
+    // The journal has not failed when each command arrives: the command
+    // is journaled, its commit fails, and stage 2 does not apply it
+    fill_device();
+    assert(pipeline.submitOrder(Order(2, symbol, Side::Buy, OrderType::Limit, 500, 4)));
+    pipeline.waitIdle();
+    recover();
+    
+    fill_device();
+    assert(pipeline.cancelOrder(symbol, 1));
+    pipeline.waitIdle();
+    recover();
+    
+    // A first submit for a symbol leaves its Instrument record, so the
+    // book is created as replay will create it
+    SymbolId fresh = internSymbol("PLG");
+    fill_device();
+    assert(pipeline.submitOrder(Order(3, fresh, Side::Buy, OrderType::Limit, 500, 4)));
+    pipeline.waitIdle();
+    recover();
+    ::close(saved);
+    
+    assert(events.size() == 2);
+    assert(!events[0].fill && events[0].status == OrderStatus::Rejected);
+    assert(!events[1].fill && events[1].status == OrderStatus::Rejected);
+    const OrderBook* book = pipeline.engine().getOrderBook(symbol);
+    assert(book->askOrderCount() == 1 && book->getBestAsk()->second == 10);
+    const OrderBook* fresh_book = pipeline.engine().getOrderBook(fresh);
+    assert(fresh_book && fresh_book->bidOrderCount() == 0);
+    assert(pipeline.stateHash() == hash + symbolStateHash(*fresh_book, nullptr));
+    
+    // The voided records reached the file with their Rejects, and the
+    // journal replays to the pipeline's state
+    assert(pipeline.submitOrder(Order(4, symbol, Side::Buy, OrderType::Limit, 500, 4)));
+    pipeline.stop();
+    journal->close();
+    assert(events.size() == 4 && events[2].fill && events[2].quantity == 4);
+    
+    BasicMatchingEngine<NullListener> replayed;
+    ReplayResult result = replayJournal(path, replayed);
+    assert(result.ok && !result.truncated);
+    assert(result.rejected == 3 && result.commands == 2);
+    assert(replayed.stateHash() == pipeline.stateHash());
+    std::remove(path.c_str());
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Engine Pipeline Tests ===" << std::endl;
+    
+    test_lifecycle();
+    test_matches_serial_engine();
+    test_binding_limit();
+    test_journal_write_failure();
+    
+    std::cout << "\n=== All Engine Pipeline Tests Passed! ===" << std::endl;
+    return 0;
+}
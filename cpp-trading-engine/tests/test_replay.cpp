@@ -0,0 +1,239 @@
+#include "../include/journal_replay.hpp"
+#include "test_util.hpp"
+#include <cstdio>
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace trading;
+
+static std::string journalPath(const char* name) {
+    return std::string("test_replay_") + name + "_" + std::to_string(::getpid()) + ".bin";
+}
+
+static const char* kSymbols[] = {"RPA", "RPB", "RPC", "RPD", "RPE"};
+
+// Mixed flow over several books: limits, IOCs, market orders, cancels,
+// modifies and batches, with a size limit that rejects some submits
+static void trade(MatchingEngine& engine, uint64_t seed, OrderId first_id, int count) {
+    auto next = [&seed](uint64_t bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (seed >> 33) % bound;
+    };
+    std::vector<Fill> fills;
+    std::vector<Order> burst;
+    for (OrderId id = first_id; id < first_id + static_cast<OrderId>(count); ++id) {
+        const char* symbol = kSymbols[next(5)];
+        Side side = next(2) ? Side::Buy : Side::Sell;
+        Price price = 1000 + static_cast<Price>(next(40));
+        Quantity quantity = 1 + static_cast<Quantity>(next(60));
+        switch (next(10)) {
+            case 0:
+                engine.cancelOrder(symbol, id - 1 - next(50));
+                break;
+            case 1:
+                engine.modifyOrder(symbol, id - 1 - next(50), next(2) ? price : 0, quantity);
+                break;
+            case 2:
+                engine.submitOrder(Order(id, symbol, side, OrderType::IOC, price, quantity), fills);
+                break;
+            case 3:
+                engine.submitOrder(Order(id, symbol, side, OrderType::Market, 0, quantity), fills);
+                break;
+            case 4:
+                burst.emplace_back(id, symbol, side, OrderType::Limit, price, quantity);
+                if (burst.size() == 8) {
+                    engine.submitOrders(burst, fills);
+                    burst.clear();
+                }
+                break;
+            default:
+                engine.submitOrder(Order(id, symbol, side, OrderType::Limit, price, quantity), fills);
+                break;
+        }
+        fills.clear();
+    }
+}
+
+static std::shared_ptr<RiskManager> makeRisk() { return testutil::makeRisk(kSymbols, 55); }
+
+static bool sameBooks(const MatchingEngine& a, const MatchingEngine& b) {
+    for (const char* symbol : kSymbols) {
+        const OrderBook* x = a.getOrderBook(symbol);
+        const OrderBook* y = b.getOrderBook(symbol);
+        if (!x || !y || x->stateHash() != y->stateHash() ||
+            x->getBestBid() != y->getBestBid() || x->getBestAsk() != y->getBestAsk() ||
+            x->totalOrderCount() != y->totalOrderCount()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_replay_matches_live() {
+    std::cout << "Testing replay rebuilds the live state..." << std::endl;
+    
+    std::string path = journalPath("live");
+    std::remove(path.c_str());
+    MatchingEngine live;
+    live.setRiskManager(makeRisk());
+    live.setJournal(testutil::openJournal(path));
+    live.registerInstrument(InstrumentSpec("RPA", 0.01, 2).withArrayLadder(900, 300));
+    
+    // Rejected before its symbol had a book: journaled without an Instrument
+    live.riskManager()->setOrderSizeLimit("RPZ", 10);
+    std::vector<Fill> fills;
+    assert(live.submitOrder(Order(99, "RPZ", Side::Buy, OrderType::Limit, 500, 20), fills) ==
+           OrderStatus::Rejected);
+    assert(live.getOrderBook("RPZ") == nullptr);
+    
+    trade(live, 1, 1, 5000);
+    uint64_t mid_hash = live.journalCheckpoint();
+    trade(live, 2, 100000, 5000);
+    uint64_t live_hash = live.journalCheckpoint();
+    assert(mid_hash != live_hash);
+    live.journal()->close();
+    
+    for (size_t threads : {1, 2, 3, 8}) {
+        MatchingEngine recovered;
+        recovered.setRiskManager(makeRisk());
+        ReplayOptions options;
+        options.threads = threads;
+        ReplayResult result = replayJournal(path, recovered, options);
+        
+        assert(result.ok && !result.truncated);
+        assert(result.partitions == std::min<size_t>(threads, 5));
+        assert(result.books == 5);
+        assert(result.checkpoints == 2 && result.mismatch_sequence == 0);
+        assert(result.rejected > 0 && result.unknown_symbol == 0);
+        assert(result.fills == live.totalFillsGenerated());
+        assert(result.state_hash == live_hash);
+        assert(recovered.stateHash() == live_hash);
+        assert(sameBooks(live, recovered));
+        assert(recovered.getOrderBook("RPZ") == nullptr);
+        
+        for (const char* symbol : kSymbols) {
+            assert(recovered.riskManager()->getPosition(symbol) ==
+                   live.riskManager()->getPosition(symbol));
+        }
+        
+        // The rebuilt books keep their instrument and read the clock again
+        const OrderBook* book = recovered.getOrderBook("RPA");
+        assert(book->instrument().layout == BookLayout::Array);
+        assert(book->instrument().tick_size == 0.01);
+        assert(book->timestamping());
+        assert(recovered.riskManager()->getTickSize("RPA") == 0.01);
+    }
+    
+    std::remove(path.c_str());
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_recovered_engine_continues() {
+    std::cout << "Testing a recovered engine continues the journal..." << std::endl;
+    
+    std::string path = journalPath("continue");
+    std::remove(path.c_str());
+    MatchingEngine live;
+    live.setJournal(testutil::openJournal(path));
+    trade(live, 3, 1, 3000);
+    live.journal()->close();
+    live.setJournal(nullptr);
+    
+    // Recover, reattach the journal and keep trading on both engines
+    MatchingEngine recovered;
+    ReplayResult result = replayJournal(path, recovered);
+    assert(result.ok && result.checkpoints == 0);
+    assert(result.state_hash == live.stateHash());
+    recovered.setJournal(testutil::openJournal(path));
+    
+    trade(live, 4, 50000, 3000);
+    trade(recovered, 4, 50000, 3000);
+    uint64_t hash = recovered.journalCheckpoint();
+    assert(hash == live.stateHash());
+    recovered.journal()->close();
+    
+    // The combined journal replays to the same place
+    MatchingEngine again;
+    result = replayJournal(path, again);
+    assert(result.ok && result.checkpoints == 1);
+    assert(result.state_hash == hash);
+    assert(sameBooks(live, again));
+    
+    std::remove(path.c_str());
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_checkpoint_mismatch() {
+    std::cout << "Testing checkpoint mismatches are reported..." << std::endl;
+    
+    std::string path = journalPath("mismatch");
+    std::remove(path.c_str());
+    uint64_t bad_sequence = 0;
+    {
+        MatchingEngine live;
+        live.setJournal(testutil::openJournal(path));
+        trade(live, 5, 1, 1000);
+        live.journalCheckpoint();
+        bad_sequence = live.journal()->append(JournalRecord::checkpoint(live.stateHash() + 1));
+        trade(live, 6, 10000, 1000);
+        live.journalCheckpoint();
+    }
+    
+    ReplayOptions options;
+    options.positions = false;   // The live engine had no risk manager
+    JournalReplay replay(options);
+    ReplayResult result = replay.run(path);
+    assert(!result.ok);
+    assert(result.checkpoints == 1);
+    assert(result.mismatch_sequence == bad_sequence);
+    
+    // Not a journal at all
+    assert(!replay.run(path + ".missing").ok);
+    
+    std::remove(path.c_str());
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_symbol_ids_remapped() {
+    std::cout << "Testing replay follows each process's symbol ids..." << std::endl;
+    
+    // Two processes wrote the same id for different symbols
+    std::string path = journalPath("remap");
+    std::remove(path.c_str());
+    {
+        OrderJournal journal;
+        assert(journal.open(path));
+        journal.append(JournalRecord::cancel(7, 1));   // Before any instrument
+        journal.appendInstrument(7, InstrumentSpec("RMA"));
+        journal.append(JournalRecord::submit(Order(1, 7, Side::Buy, OrderType::Limit, 100, 5)));
+        journal.appendInstrument(7, InstrumentSpec("RMB"));
+        journal.append(JournalRecord::submit(Order(2, 7, Side::Sell, OrderType::Limit, 200, 6)));
+    }
+    
+    MatchingEngine engine;
+    ReplayResult result = replayJournal(path, engine);
+    assert(result.ok && result.books == 2);
+    assert(result.unknown_symbol == 1 && result.commands == 2);
+    assert(engine.getOrderBook("RMA")->getBestBid()->first == 100);
+    assert(!engine.getOrderBook("RMA")->getBestAsk());
+    assert(engine.getOrderBook("RMB")->getBestAsk()->first == 200);
+    
+    std::remove(path.c_str());
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Journal Replay Tests ===" << std::endl;
+    
+    test_replay_matches_live();
+    test_recovered_engine_continues();
+    test_checkpoint_mismatch();
+    test_symbol_ids_remapped();
+    
+    std::cout << "\n=== All Journal Replay Tests Passed! ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "../include/command_sequencer.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace trading;
+
+constexpr size_t kProducers = 4;
+constexpr size_t kPerProducer = 5000;
+
+struct Sequenced {
+    uint64_t sequence;
+    EngineCommand command;
+};
+
+// Each producer trades its own ids on two shared books; a tenth are cancels
+static EngineCommand producerCommand(size_t producer, size_t i) {
+    static const SymbolId symbols[] = {internSymbol("SQA"), internSymbol("SQB")};
+    OrderId id = producer * 1000000 + i + 1;
+    SymbolId symbol = symbols[(producer + i) % 2];
+    if (i % 10 == 9) {
+        return EngineCommand::cancel(symbol, id - 5);
+    }
+    Side side = (i + producer) % 3 == 0 ? Side::Sell : Side::Buy;
+    Price price = 100 + static_cast<Price>((i * 7 + producer) % 11);
+    return EngineCommand::submit(Order(id, symbol, side, OrderType::Limit, price,
+                                       1 + static_cast<Quantity>(i % 9)));
+}
+
+void test_sequence_order() {
+    std::cout << "Testing sequence numbers follow publish order..." << std::endl;
+    
+    CommandSequencer sequencer(5);
+    assert(sequencer.capacity() == 8);
+    uint64_t expected = 1;
+    OrderId next_id = 1;
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 6; ++i) {
+            assert(sequencer.cancelOrder(internSymbol("SQA"), next_id++) == expected++);
+        }
+        assert(sequencer.claimed() == expected - 1);
+        
+        OrderId seen = next_id - 6;
+        size_t taken = sequencer.consume([&seen](const EngineCommand& command) {
+            assert(command.type == CommandType::Cancel && command.order_id == seen++);
+        }, 4);
+        assert(taken == 4);
+        taken = sequencer.consume([&seen](const EngineCommand& command) {
+            assert(command.order_id == seen++);
+        });
+        assert(taken == 2 && seen == next_id);
+        assert(sequencer.consumed() == expected - 1);
+    }
+    assert(sequencer.consume([](const EngineCommand&) { assert(false); }) == 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_producers_feed_one_engine() {
+    std::cout << "Testing concurrent producers: journal order equals sequence order..."
+              << std::endl;
+    
+    for (WaitStrategy wait : {WaitStrategy::SpinYield, WaitStrategy::Block}) {
+        std::string path = "test_sequencer_" + std::to_string(::getpid()) + ".bin";
+        std::remove(path.c_str());
+        JournalOptions options;
+        options.fsync = FsyncPolicy::None;
+        auto journal = std::make_shared<OrderJournal>();
+        assert(journal->open(path, options));
+        
+        BasicMatchingEngine<NullListener> engine;
+        engine.setJournal(journal);
+        CommandSequencer sequencer(64, wait);
+        EngineLoop<NullListener, CommandSequencer> loop(engine, sequencer, 16);
+        std::thread engine_thread([&loop]() { loop.run(); });
+        
+        std::vector<std::vector<Sequenced>> published(kProducers);
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < kProducers; ++p) {
+            producers.emplace_back([p, &sequencer, &published]() {
+                for (size_t i = 0; i < kPerProducer; ++i) {
+                    EngineCommand command = producerCommand(p, i);
+                    published[p].push_back({sequencer.publish(command), command});
+                }
+            });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        loop.stop();
+        engine_thread.join();
+        journal->close();
+        
+        // Sequence numbers are dense, and each producer's are increasing
+        std::vector<Sequenced> all;
+        for (const auto& mine : published) {
+            for (size_t i = 1; i < mine.size(); ++i) {
+                assert(mine[i].sequence > mine[i - 1].sequence);
+            }
+            all.insert(all.end(), mine.begin(), mine.end());
+        }
+        std::sort(all.begin(), all.end(), [](const Sequenced& a, const Sequenced& b) {
+            return a.sequence < b.sequence;
+        });
+        for (size_t i = 0; i < all.size(); ++i) {
+            assert(all[i].sequence == i + 1);
+        }
+        assert(loop.processed() == all.size() && sequencer.consumed() == all.size());
+        
+        // The journal holds the commands in sequence order
+        JournalReader reader;
+        assert(reader.open(path));
+        JournalRecord record;
+        InstrumentSpec spec;
+        size_t next = 0;
+        while (reader.next(record, spec)) {
+            if (record.type != CommandType::Submit && record.type != CommandType::Cancel) {
+                continue;
+            }
+            assert(next < all.size());
+            assert(record.type == all[next].command.type);
+            assert(record.order_id == all[next].command.order_id);
+            ++next;
+        }
+        assert(next == all.size());
+        
+        // Replaying the sequence on one thread gives the same state
+        BasicMatchingEngine<NullListener> reference;
+        std::vector<Fill> fills;
+        for (const Sequenced& entry : all) {
+            applyCommand(reference, entry.command, fills);
+        }
+        assert(engine.stateHash() == reference.stateHash());
+        std::remove(path.c_str());
+    }
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Command Sequencer Tests ===" << std::endl;
+    
+    test_sequence_order();
+    test_producers_feed_one_engine();
+    
+    std::cout << "\n=== All Command Sequencer Tests Passed! ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include "../include/sharded_engine.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <iterator>
+#include <cassert>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace trading;
+
+static const char* kSymbols[] = {"SHA", "SHB", "SHC", "SHD", "SHE", "SHF", "SHG"};
+constexpr size_t kSymbolCount = sizeof(kSymbols) / sizeof(kSymbols[0]);
+
+// Mixed flow over every symbol: limits, IOCs, market orders, cancels and modifies
+static std::vector<EngineCommand> makeFlow(uint64_t seed, int count) {
+    testutil::FlowSpec spec;
+    spec.symbols.assign(std::begin(kSymbols), std::end(kSymbols));
+    spec.base_price = 1000;
+    spec.levels = 40;
+    spec.max_quantity = 60;
+    spec.lookback = 50;
+    spec.market_orders = true;
+    return testutil::makeFlow(spec, seed, count);
+}
+
+static bool sameEvent(const EngineEvent& a, const EngineEvent& b) {
+    return a.type == b.type && a.order_id == b.order_id &&
+           a.counter_order_id == b.counter_order_id && a.price == b.price &&
+           a.quantity == b.quantity && a.filled_qty == b.filled_qty && a.side == b.side &&
+           a.status == b.status;
+}
+
+using EventsBySymbol = std::map<SymbolId, std::vector<EngineEvent>>;
+
+// Reference: one engine applying the whole flow on this thread
+static uint64_t runSingle(const std::vector<EngineCommand>& commands, EventsBySymbol& events) {
+    MatchingEngine engine;
+    engine.setFillCallback([&events](const Fill& fill) {
+        events[fill.symbol].push_back(EngineEvent::fill(fill));
+    });
+    engine.setOrderCallback([&events](const Order& order) {
+        events[order.symbol].push_back(EngineEvent::order(order));
+    });
+    std::vector<Fill> fills;
+    for (const EngineCommand& command : commands) {
+        applyCommand(engine, command, fills);
+    }
+    return engine.stateHash();
+}
+
+static void collect(ShardedEngine& engine, EventsBySymbol& events) {
+    for (size_t shard = 0; shard < engine.shardCount(); ++shard) {
+        engine.consumeEvents(shard, [&events](const EngineEvent& event) {
+            events[event.symbol].push_back(event);
+        });
+    }
+}
+
+void test_matches_single_engine() {
+    std::cout << "Testing shards reproduce a single engine per symbol..." << std::endl;
+    
+    std::vector<EngineCommand> commands = makeFlow(7, 20000);
+    EventsBySymbol expected;
+    uint64_t expected_hash = runSingle(commands, expected);
+    
+    for (size_t shards : {1, 2, 3, 4}) {
+        ShardOptions options;
+        options.shards = shards;
+        options.queue_capacity = 1024;
+        ShardedEngine engine(options);
+        for (const char* symbol : kSymbols) {
+            assert(engine.registerSymbol(symbol, 256));
+        }
+        assert(engine.start());
+        
+        EventsBySymbol events;
+        for (size_t i = 0; i < commands.size(); ++i) {
+            assert(engine.submit(commands[i]));
+            if (i % 64 == 63) {
+                collect(engine, events);
+            }
+        }
+        engine.waitIdle();
+        collect(engine, events);
+        
+        assert(engine.commandsProcessed() == commands.size());
+        assert(engine.stateHash() == expected_hash);
+        assert(events.size() == expected.size());
+        for (const auto& entry : expected) {
+            const std::vector<EngineEvent>& got = events[entry.first];
+            assert(got.size() == entry.second.size());
+            for (size_t i = 0; i < got.size(); ++i) {
+                assert(sameEvent(got[i], entry.second[i]));
+            }
+        }
+        engine.stop();
+        assert(engine.eventsDropped() == 0);
+    }
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_symbol_routing() {
+    std::cout << "Testing symbols are spread over the shards..." << std::endl;
+    
+    ShardOptions options;
+    options.shards = 3;
+    options.pin_threads = false;
+    ShardedEngine engine(options);
+    assert(engine.shardCount() == 3);
+    assert(!engine.submitOrder(Order(1, "SHA", Side::Buy, OrderType::Limit, 1000, 10)));
+    
+    for (size_t i = 0; i < 6; ++i) {
+        assert(engine.registerSymbol(kSymbols[i]));
+    }
+    std::vector<size_t> per_shard(engine.shardCount(), 0);
+    for (size_t i = 0; i < 6; ++i) {
+        size_t shard = engine.shardOf(findSymbol(kSymbols[i]));
+        assert(shard < engine.shardCount());
+        assert(engine.shardEngine(shard).getOrderBook(kSymbols[i]) != nullptr);
+        ++per_shard[shard];
+    }
+    assert(per_shard[0] == 2 && per_shard[1] == 2 && per_shard[2] == 2);
+    assert(engine.shardOf(internSymbol(kSymbols[6])) == engine.shardCount());
+    
+    // A symbol first seen after start() gets a shard and a book on first use
+    assert(engine.start());
+    assert(!engine.start());
+    assert(!engine.registerSymbol("SHZ"));
+    SymbolId late = internSymbol(kSymbols[6]);
+    assert(engine.submitOrder(Order(1, late, Side::Buy, OrderType::Limit, 1000, 10)));
+    assert(engine.shardOf(late) < engine.shardCount());
+    engine.waitIdle();
+    const OrderBook* book = engine.shardEngine(engine.shardOf(late)).getOrderBook(late);
+    assert(book && book->getBestBid()->first == 1000);
+    
+    // Ids the registry never issued are refused, not routed
+    assert(!engine.submitOrder(Order()));
+    assert(!engine.cancelOrder(INVALID_SYMBOL_ID, 1));
+    assert(!engine.modifyOrder(static_cast<SymbolId>(1u << 30), 1, 1000, 5));
+    assert(engine.shardOf(INVALID_SYMBOL_ID) == engine.shardCount());
+    
+    engine.stop();
+    assert(!engine.running());
+    assert(!engine.cancelOrder(late, 1));
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_stop_drains_commands() {
+    std::cout << "Testing stop applies every queued command..." << std::endl;
+    
+    std::vector<EngineCommand> commands = makeFlow(11, 5000);
+    EventsBySymbol unused;
+    uint64_t expected_hash = runSingle(commands, unused);
+    
+    ShardOptions options;
+    options.shards = 2;
+    options.event_capacity = 16;    // Mostly unconsumed: the rest are dropped at stop
+    ShardedEngine engine(options);
+    assert(engine.start());
+    size_t consumed = 0;
+    for (const EngineCommand& command : commands) {
+        assert(engine.submit(command));
+        // Keep the output rings moving until the last stretch
+        if (consumed < commands.size() / 2) {
+            for (size_t shard = 0; shard < engine.shardCount(); ++shard) {
+                engine.consumeEvents(shard, [](const EngineEvent&) {});
+            }
+            ++consumed;
+        }
+    }
+    engine.stop();
+    
+    assert(engine.commandsProcessed() == commands.size());
+    assert(engine.stateHash() == expected_hash);
+    assert(engine.eventsDropped() > 0);
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Sharded Engine Tests ===" << std::endl;
+    
+    test_matches_single_engine();
+    test_symbol_routing();
+    test_stop_drains_commands();
+    
+    std::cout << "\n=== All Sharded Engine Tests Passed! ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,325 @@
+#include "../include/engine_snapshot.hpp"
+#include "../include/fork_snapshot.hpp"
+#include "test_util.hpp"
+#include <cstdio>
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace trading;
+
+static std::string filePath(const char* name, const char* kind) {
+    return std::string("test_snapshot_") + name + "_" + std::to_string(::getpid()) + kind;
+}
+
+static const char* kSymbols[] = {"SNA", "SNB", "SNC", "SND"};
+
+// Resting orders, partial fills, cancels and modifies over several books
+static void trade(MatchingEngine& engine, uint64_t seed, OrderId first_id, int count) {
+    auto next = [&seed](uint64_t bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (seed >> 33) % bound;
+    };
+    std::vector<Fill> fills;
+    for (OrderId id = first_id; id < first_id + static_cast<OrderId>(count); ++id) {
+        const char* symbol = kSymbols[next(4)];
+        Side side = next(2) ? Side::Buy : Side::Sell;
+        Price price = 1000 + static_cast<Price>(next(40));
+        Quantity quantity = 1 + static_cast<Quantity>(next(60));
+        switch (next(8)) {
+            case 0:
+                engine.cancelOrder(symbol, id - 1 - next(50));
+                break;
+            case 1:
+                engine.modifyOrder(symbol, id - 1 - next(50), next(2) ? price : 0, quantity);
+                break;
+            case 2:
+                engine.submitOrder(Order(id, symbol, side, OrderType::IOC, price, quantity), fills);
+                break;
+            default:
+                engine.submitOrder(Order(id, symbol, side, OrderType::Limit, price, quantity), fills);
+                break;
+        }
+        fills.clear();
+    }
+}
+
+static std::shared_ptr<RiskManager> makeRisk() { return testutil::makeRisk(kSymbols, 55); }
+
+// Same levels with the same orders, in the same queue order
+static bool sameBooks(const MatchingEngine& a, const MatchingEngine& b) {
+    for (const char* symbol : kSymbols) {
+        const OrderBook* x = a.getOrderBook(symbol);
+        const OrderBook* y = b.getOrderBook(symbol);
+        if (!x || !y || x->stateHash() != y->stateHash() ||
+            x->getBestBid() != y->getBestBid() || x->getBestAsk() != y->getBestAsk() ||
+            x->totalOrderCount() != y->totalOrderCount() ||
+            x->bidOrderCount() != y->bidOrderCount() ||
+            x->cachedDepth(Side::Buy).levels[0].quantity !=
+                y->cachedDepth(Side::Buy).levels[0].quantity) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_round_trip() {
+    std::cout << "Testing snapshot round trip of books and queue order..." << std::endl;
+    
+    std::string path = filePath("round", ".snap");
+    MatchingEngine live;
+    live.registerInstrument(InstrumentSpec("SNA", 0.01, 2).withArrayLadder(900, 300));
+    trade(live, 1, 1, 4000);
+    
+    SnapshotInfo saved = saveSnapshot(path, live);
+    assert(saved.ok && !saved.has_risk);
+    assert(saved.books == 4 && saved.orders > 0);
+    assert(saved.journal_offset == 0);
+    
+    MatchingEngine restored;
+    SnapshotInfo info = restoreSnapshot(path, restored);
+    assert(info.ok);
+    assert(info.books == 4 && info.orders == saved.orders);
+    assert(info.state_hash == live.stateHash());
+    assert(restored.stateHash() == live.stateHash());
+    assert(sameBooks(live, restored));
+    
+    const OrderBook* book = restored.getOrderBook("SNA");
+    assert(book->instrument().layout == BookLayout::Array);
+    assert(book->instrument().tick_size == 0.01);
+    assert(book->topOfBook().read().getBestBid() == live.getOrderBook("SNA")->getBestBid());
+    
+    // Restored books trade on exactly as the originals do
+    trade(live, 2, 100000, 2000);
+    trade(restored, 2, 100000, 2000);
+    assert(sameBooks(live, restored));
+    
+    std::remove(path.c_str());
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_risk_restored() {
+    std::cout << "Testing snapshot restores risk limits, positions and counters..." << std::endl;
+    
+    std::string path = filePath("risk", ".snap");
+    MatchingEngine live;
+    auto risk = makeRisk();
+    risk->setPositionLimit("SNB", 777);
+    risk->setNotionalLimit("SNC", 12345.0);
+    risk->setGlobalPositionLimit(5000);
+    risk->setOrderRateLimit(100000);
+    live.setRiskManager(risk);
+    trade(live, 3, 1, 3000);
+    assert(saveSnapshot(path, live).ok);
+    
+    MatchingEngine restored;
+    restored.setRiskManager(std::make_shared<RiskManager>());
+    SnapshotInfo info = restoreSnapshot(path, restored);
+    assert(info.ok && info.has_risk && info.risk_symbols >= 4);
+    
+    const RiskManager& copy = *restored.riskManager();
+    for (const char* symbol : kSymbols) {
+        assert(copy.getPosition(symbol) == risk->getPosition(symbol));
+        assert(copy.getNotionalExposure(symbol) == risk->getNotionalExposure(symbol));
+        assert(copy.getOrderSizeLimit(symbol) == 55);
+    }
+    assert(copy.getPositionLimit("SNB") == 777);
+    assert(copy.getNotionalLimit("SNC") == 12345.0);
+    RiskManager::GlobalRisk global = copy.globalRisk();
+    assert(global.position_limit == 5000);
+    assert(global.order_rate_limit == 100000);
+    assert(global.orders_this_second == risk->globalRisk().orders_this_second);
+    assert(restored.stateHash() == live.stateHash());
+    
+    std::remove(path.c_str());
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_recovery_from_snapshot_and_tail() {
+    std::cout << "Testing recovery from a snapshot plus the journal tail..." << std::endl;
+    
+    std::string snapshot_path = filePath("tail", ".snap");
+    std::string journal_path = filePath("tail", ".bin");
+    std::remove(journal_path.c_str());
+    MatchingEngine live;
+    live.setRiskManager(makeRisk());
+    live.setJournal(testutil::openJournal(journal_path));
+    trade(live, 4, 1, 5000);
+    
+    SnapshotInfo saved = saveSnapshot(snapshot_path, live);
+    assert(saved.ok && saved.journal_sequence > 0);
+    assert(saved.journal_offset > OrderJournal::HEADER_BYTES);
+    
+    trade(live, 5, 100000, 3000);
+    live.registerSymbol("SNE");   // A book created after the snapshot
+    live.submitOrder(Order(900000, "SNE", Side::Buy, OrderType::Limit, 50, 5));
+    uint64_t live_hash = live.journalCheckpoint();
+    live.journal()->close();
+    
+    for (size_t threads : {1, 3}) {
+        MatchingEngine recovered;
+        recovered.setRiskManager(makeRisk());
+        ReplayOptions options;
+        options.threads = threads;
+        ReplayResult result = recoverEngine(snapshot_path, journal_path, recovered, options);
+        assert(result.ok && result.checkpoints == 1);
+        assert(result.books == 5);
+        assert(result.state_hash == live_hash);
+        assert(sameBooks(live, recovered));
+        assert(recovered.getOrderBook("SNE")->getBestBid()->first == 50);
+        
+        // Only the tail was replayed
+        ReplayResult full;
+        {
+            MatchingEngine scratch;
+            scratch.setRiskManager(makeRisk());
+            full = replayJournal(journal_path, scratch);
+            assert(full.ok && full.state_hash == live_hash);
+        }
+        assert(result.commands < full.commands);
+        
+        for (const char* symbol : kSymbols) {
+            assert(recovered.riskManager()->getPosition(symbol) ==
+                   live.riskManager()->getPosition(symbol));
+        }
+    }
+    
+    // A missing snapshot falls back to the whole journal
+    MatchingEngine fallback;
+    fallback.setRiskManager(makeRisk());
+    ReplayResult result = recoverEngine(snapshot_path + ".missing", journal_path, fallback);
+    assert(result.ok && result.state_hash == live_hash);
+    
+    // A journal that ends before the snapshot point cannot continue it
+    {
+        std::string short_path = filePath("short", ".bin");
+        std::remove(short_path.c_str());
+        OrderJournal journal;
+        assert(journal.open(short_path));
+        journal.close();
+        MatchingEngine engine;
+        engine.setRiskManager(makeRisk());
+        assert(!recoverEngine(snapshot_path, short_path, engine).ok);
+        std::remove(short_path.c_str());
+    }
+    
+    std::remove(snapshot_path.c_str());
+    std::remove(journal_path.c_str());
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_bad_snapshot_refused() {
+    std::cout << "Testing corrupt and foreign snapshots are refused..." << std::endl;
+    
+    std::string path = filePath("bad", ".snap");
+    MatchingEngine live;
+    trade(live, 6, 1, 1000);
+    assert(saveSnapshot(path, live).ok);
+    
+    std::vector<char> bytes;
+    {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        assert(file);
+        int c;
+        while ((c = std::fgetc(file)) != EOF) {
+            bytes.push_back(static_cast<char>(c));
+        }
+        std::fclose(file);
+    }
+    auto rewrite = [&path](const std::vector<char>& content) {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        assert(file);
+        std::fwrite(content.data(), 1, content.size(), file);
+        std::fclose(file);
+    };
+    
+    EngineSnapshot snapshot;
+    assert(snapshot.open(path));
+    
+    // Flipped body byte
+    std::vector<char> corrupt = bytes;
+    corrupt[corrupt.size() / 2] ^= 0x40;
+    rewrite(corrupt);
+    assert(!snapshot.open(path));
+    
+    // Another format version
+    std::vector<char> version = bytes;
+    version[4] = static_cast<char>(EngineSnapshot::FORMAT_VERSION + 1);
+    rewrite(version);
+    assert(!snapshot.open(path));
+    
+    // Cut short
+    rewrite(std::vector<char>(bytes.begin(), bytes.end() - 8));
+    assert(!snapshot.open(path));
+    
+    MatchingEngine engine;
+    assert(!restoreSnapshot(path, engine).ok);
+    assert(!engine.getOrderBook(kSymbols[0]));
+    assert(!snapshot.open(path + ".missing"));
+    
+    std::remove(path.c_str());
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_fork_snapshot() {
+    std::cout << "Testing forked snapshots capture the state at the fork..." << std::endl;
+    
+    std::string snapshot_path = filePath("fork", ".snap");
+    std::string journal_path = filePath("fork", ".bin");
+    std::remove(journal_path.c_str());
+    MatchingEngine live;
+    live.setRiskManager(makeRisk());
+    live.setJournal(testutil::openJournal(journal_path));
+    trade(live, 7, 1, 4000);
+    uint64_t hash_at_fork = live.stateHash();
+    
+    ForkSnapshot snapshot;
+    assert(snapshot.start(snapshot_path, live));
+    assert(snapshot.running());
+    assert(!snapshot.start(snapshot_path, live));   // One at a time
+    
+    // The parent keeps matching while the child writes
+    trade(live, 8, 100000, 4000);
+    assert(live.stateHash() != hash_at_fork);
+    assert(snapshot.wait());
+    assert(!snapshot.running() && snapshot.poll());
+    
+    const ForkSnapshotMetrics& metrics = snapshot.metrics();
+    assert(metrics.fork_ns > 0 && metrics.stall_ns >= metrics.fork_ns);
+    assert(metrics.write_ns > 0 && metrics.duration_ns >= metrics.write_ns);
+    assert(snapshot.info().state_hash == hash_at_fork);
+    assert(snapshot.info().has_risk && snapshot.info().orders > 0);
+    
+    MatchingEngine restored;
+    restored.setRiskManager(makeRisk());
+    SnapshotInfo info = restoreSnapshot(snapshot_path, restored);
+    assert(info.ok && restored.stateHash() == hash_at_fork);
+    
+    // And the journal tail written after the fork completes the recovery
+    uint64_t live_hash = live.journalCheckpoint();
+    live.journal()->close();
+    MatchingEngine recovered;
+    recovered.setRiskManager(makeRisk());
+    ReplayResult result = recoverEngine(snapshot_path, journal_path, recovered);
+    assert(result.ok && result.state_hash == live_hash && result.checkpoints == 1);
+    
+    std::remove(snapshot_path.c_str());
+    std::remove(journal_path.c_str());
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Engine Snapshot Tests ===" << std::endl;
+    
+    test_round_trip();
+    test_risk_restored();
+    test_recovery_from_snapshot_and_tail();
+    test_bad_snapshot_refused();
+    test_fork_snapshot();
+    
+    std::cout << "\n=== All Engine Snapshot Tests Passed! ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,205 @@
+#include "../include/matching_engine.hpp"
+#include <atomic>
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+using namespace trading;
+
+constexpr int kReaders = 4;
+
+// Start readers and wait until all of them are running, so the writer
+// overlaps with them even on a single core
+template <typename Fn>
+static std::vector<std::thread> startReaders(std::atomic<int>& running, Fn fn) {
+    std::vector<std::thread> readers;
+    for (int r = 0; r < kReaders; ++r) {
+        readers.emplace_back([&running, fn] {
+            running.fetch_add(1);
+            fn();
+        });
+    }
+    while (running.load() < kReaders) {
+        std::this_thread::yield();
+    }
+    return readers;
+}
+
+static bool matchesBook(const Quote& quote, const OrderBook& book) {
+    return quote.getBestBid() == book.getBestBid() &&
+           quote.getBestAsk() == book.getBestAsk() &&
+           quote.getMidPrice() == book.getMidPrice();
+}
+
+void test_quote_tracks_book() {
+    std::cout << "Testing top of book tracks the book..." << std::endl;
+    
+    OrderBook book("AAPL");
+    const TopOfBook& top = book.topOfBook();
+    assert(top.sequence() == 0);
+    assert(!top.read().getBestBid() && !top.read().getMidPrice());
+    
+    book.addOrder(Order(1, "AAPL", Side::Buy, OrderType::Limit, 10000, 100));
+    book.addOrder(Order(2, "AAPL", Side::Sell, OrderType::Limit, 10010, 50));
+    Quote quote = top.read();
+    assert(quote.sequence == 2);
+    assert(quote.bid_price == 10000 && quote.bid_quantity == 100);
+    assert(quote.ask_price == 10010 && quote.ask_quantity == 50);
+    assert(*quote.getSpread() == 10);
+    
+    // Changes behind the touch publish nothing
+    book.addOrder(Order(3, "AAPL", Side::Buy, OrderType::Limit, 9990, 100));
+    book.cancelOrder(3);
+    assert(top.sequence() == 2);
+    
+    // Quantity changes at the touch do
+    book.modifyOrder(1, 0, 60);
+    book.executeFill(Side::Buy, 20, 0, 100);
+    quote = top.read();
+    assert(quote.sequence == 4);
+    assert(quote.bid_quantity == 60 && quote.ask_quantity == 30);
+    
+    // Randomized: the quote always equals the book's own best levels
+    uint64_t seed = 11;
+    auto next = [&seed](uint64_t bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (seed >> 33) % bound;
+    };
+    for (OrderId id = 10; id < 5000; ++id) {
+        switch (next(4)) {
+            case 0:
+                book.cancelOrder(next(id));
+                break;
+            case 1:
+                book.executeFill(next(2) ? Side::Buy : Side::Sell, 1 + next(200), 0, id);
+                break;
+            default:
+                book.addOrder(Order(id, "AAPL", next(2) ? Side::Buy : Side::Sell,
+                                    OrderType::Limit, 9950 + next(100), 1 + next(50)));
+                break;
+        }
+        assert(matchesBook(top.read(), book));
+    }
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_seqlock_readers() {
+    std::cout << "Testing seqlock with concurrent readers..." << std::endl;
+    
+    // Every published quote satisfies a relation a torn read would break
+    constexpr Price kUpdates = 500000;
+    TopOfBook top;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::atomic<uint64_t> reads{0};
+    
+    std::atomic<int> running{0};
+    std::vector<std::thread> readers = startReaders(running, [&] {
+        uint64_t last_sequence = 0;
+        uint64_t count = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            Quote quote = top.read();
+            ++count;
+            if (quote.sequence == 0) {
+                continue;   // Nothing published yet
+            }
+            bool consistent = quote.ask_price == quote.bid_price + 1 &&
+                              quote.bid_quantity == quote.bid_price * 3 &&
+                              quote.ask_quantity == quote.bid_price * 5 &&
+                              quote.sequence == static_cast<uint64_t>(quote.bid_price) &&
+                              quote.sequence >= last_sequence;
+            if (!consistent) {
+                torn.fetch_add(1);
+            }
+            last_sequence = quote.sequence;
+        }
+        reads.fetch_add(count);
+    });
+    
+    for (Price n = 1; n <= kUpdates; ++n) {
+        top.publish(n, n * 3, n + 1, n * 5);
+        if (n % 4096 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    
+    assert(torn.load() == 0);
+    assert(reads.load() > 0);
+    assert(top.sequence() == static_cast<uint64_t>(kUpdates));
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_engine_readers() {
+    std::cout << "Testing top of book readers against a live engine..." << std::endl;
+    
+    MatchingEngine engine;
+    BookHandle handle = engine.registerSymbol("AAPL", 1024);
+    const OrderBook& book = *engine.getOrderBook(handle);
+    const TopOfBook& top = book.topOfBook();
+    
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+    std::atomic<int> running{0};
+    std::vector<std::thread> readers = startReaders(running, [&] {
+        uint64_t last_sequence = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            Quote quote = top.read();
+            // The engine never leaves the book crossed, and a side is
+            // either empty or has both a price and a quantity
+            bool sane = (quote.bid_price > 0) == (quote.bid_quantity > 0) &&
+                        (quote.ask_price > 0) == (quote.ask_quantity > 0) &&
+                        (!quote.getSpread() || *quote.getSpread() > 0) &&
+                        quote.sequence >= last_sequence;
+            if (!sane) {
+                bad.fetch_add(1);
+            }
+            last_sequence = quote.sequence;
+        }
+    });
+    
+    uint64_t seed = 5;
+    auto next = [&seed](uint64_t bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (seed >> 33) % bound;
+    };
+    std::vector<Fill> fills;
+    for (OrderId id = 1; id <= 200000; ++id) {
+        if (id > 200 && next(2) == 0) {
+            engine.cancelOrder(handle, id - 200);
+        }
+        Side side = next(2) ? Side::Buy : Side::Sell;
+        engine.submitOrder(handle, Order(id, "AAPL", side, OrderType::Limit,
+                                         9950 + next(100), 1 + next(50)), fills);
+        fills.clear();
+        if (id % 1024 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    
+    assert(bad.load() == 0);
+    assert(matchesBook(top.read(), book));
+    
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Top of Book Tests ===" << std::endl;
+    
+    test_quote_tracks_book();
+    test_seqlock_readers();
+    test_engine_readers();
+    
+    std::cout << "\n=== All Top of Book Tests Passed! ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,135 @@
+#ifndef TRADING_TEST_UTIL_HPP
+#define TRADING_TEST_UTIL_HPP
+
+#include "../include/engine_command.hpp"
+#include "../include/order_journal.hpp"
+#include "../include/risk_manager.hpp"
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace testutil {
+
+using namespace trading;
+
+/**
+ * @brief Shape of a generated command flow
+ */
+struct FlowSpec {
+    std::vector<const char*> symbols;
+    Price base_price = 500;        // Prices are base_price + [0, levels)
+    Price levels = 20;
+    Quantity max_quantity = 30;    // Quantities are [1, max_quantity]
+    OrderId lookback = 20;         // Cancels and modifies target one of the last lookback ids
+    bool market_orders = false;    // Also market orders, and modifies that reprice
+};
+
+/**
+ * @brief Deterministic crossing flow: limits, IOCs, cancels and modifies
+ *        (plus market orders if the spec asks for them)
+ */
+inline std::vector<EngineCommand> makeFlow(const FlowSpec& spec, uint64_t seed, int count) {
+    auto next = [&seed](uint64_t bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (seed >> 33) % bound;
+    };
+    std::vector<SymbolId> symbols;
+    for (const char* symbol : spec.symbols) {
+        symbols.push_back(internSymbol(symbol));
+    }
+    std::vector<EngineCommand> commands;
+    for (OrderId id = 1; id <= static_cast<OrderId>(count); ++id) {
+        SymbolId symbol = symbols[next(symbols.size())];
+        Side side = next(2) ? Side::Buy : Side::Sell;
+        Price price = spec.base_price + static_cast<Price>(next(spec.levels));
+        Quantity quantity = 1 + static_cast<Quantity>(next(spec.max_quantity));
+        switch (next(spec.market_orders ? 10 : 8)) {
+            case 0:
+                commands.push_back(EngineCommand::cancel(symbol, id - 1 - next(spec.lookback)));
+                break;
+            case 1: {
+                OrderId target = id - 1 - next(spec.lookback);
+                Price new_price = spec.market_orders && next(2) ? price : 0;
+                commands.push_back(EngineCommand::modify(symbol, target, new_price, quantity));
+                break;
+            }
+            case 2:
+                commands.push_back(EngineCommand::submit(
+                    Order(id, symbol, side, OrderType::IOC, price, quantity)));
+                break;
+            case 3:
+                if (spec.market_orders) {
+                    commands.push_back(EngineCommand::submit(
+                        Order(id, symbol, side, OrderType::Market, 0, quantity)));
+                } else {
+                    commands.push_back(EngineCommand::submit(
+                        Order(id, symbol, side, OrderType::Limit, price, quantity)));
+                }
+                break;
+            default:
+                commands.push_back(EngineCommand::submit(
+                    Order(id, symbol, side, OrderType::Limit, price, quantity)));
+                break;
+        }
+    }
+    return commands;
+}
+
+/**
+ * @brief Risk manager with the same order size limit on every symbol
+ */
+template <typename Symbols>
+std::shared_ptr<RiskManager> makeRisk(const Symbols& symbols, Quantity size_limit) {
+    auto risk = std::make_shared<RiskManager>();
+    for (const char* symbol : symbols) {
+        risk->setOrderSizeLimit(symbol, size_limit);
+    }
+    return risk;
+}
+
+/**
+ * @brief Open (or reopen) a journal, asserting success
+ */
+inline std::shared_ptr<OrderJournal> openJournal(const std::string& path,
+                                                 FsyncPolicy fsync = FsyncPolicy::None,
+                                                 size_t group_size = 1) {
+    JournalOptions options;
+    options.fsync = fsync;
+    options.group_size = group_size;
+    auto journal = std::make_shared<OrderJournal>();
+    assert(journal->open(path, options));
+    return journal;
+}
+
+/**
+ * @brief Descriptor this process has open on a file, or -1
+ *
+ * Tests dup2() /dev/full over it to make the journal's writes fail.
+ */
+inline int openDescriptor(const std::string& path) {
+    char target[PATH_MAX];
+    if (!::realpath(path.c_str(), target)) {
+        return -1;
+    }
+    for (int fd = 0; fd < 1024; ++fd) {
+        char link[PATH_MAX];
+        std::string proc = "/proc/self/fd/" + std::to_string(fd);
+        ssize_t size = ::readlink(proc.c_str(), link, sizeof(link) - 1);
+        if (size > 0) {
+            link[size] = '\0';
+            if (std::string(link) == target) {
+                return fd;
+            }
+        }
+    }
+    return -1;
+}
+
+} // namespace testutil
+
+#endif // TRADING_TEST_UTIL_HPP